@@ -0,0 +1,494 @@
+/**
+ * @file latency_benchmark.cpp
+ * @brief Latency benchmarks
+ *
+ * Runs against local mock servers so results do not depend on the network.
+ * The task pool benchmark measures throughput scaling with worker count.
+ * The message parsing benchmark links the counting allocator and reports
+ * heap allocations per market data message once warmed up; dispatch_tests
+ * asserts there are none on the full WSClient dispatch path.
+ * Usage: latency_benchmark [iterations]
+ */
+
+#include "api/http_client.h"
+#include "api/deribit_api.h"
+#include "websocket/tls_context.h"
+#include "order/orderbook.h"
+#include "order/ticker_cache.h"
+#include "order/trade_store.h"
+#include "utils/task_pool.h"
+#include "utils/arena.h"
+#include "utils/allocation_counter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = boost::asio::ip::tcp;
+using deribit::api::HttpConnectionPool;
+using deribit::api::HttpResponse;
+using deribit::api::RequestParams;
+using deribit::websocket::TlsContext;
+using deribit::utils::TaskPool;
+using deribit::utils::TaskPoolConfig;
+using deribit::utils::AllocationCounter;
+using deribit::utils::Arena;
+using deribit::utils::ArenaScope;
+using deribit::api::WSMessageView;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const std::string kRequest =
+    "GET /api/v2/public/test HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+const std::string kResponse =
+    "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 54\r\n\r\n"
+    "{\"jsonrpc\":\"2.0\",\"result\":{\"version\":\"1.2.26\"},\"id\":0}";
+
+/**
+ * @brief Summary of a series of samples in microseconds
+ */
+struct Summary {
+    double p50;
+    double p99;
+    double avg;
+};
+
+Summary summarize(std::vector<double> samples) {
+    Summary summary{0, 0, 0};
+    if (samples.empty()) {
+        return summary;
+    }
+    std::sort(samples.begin(), samples.end());
+    summary.p50 = samples[samples.size() / 2];
+    summary.p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    for (double sample : samples) {
+        summary.avg += sample;
+    }
+    summary.avg /= static_cast<double>(samples.size());
+    return summary;
+}
+
+double elapsedUs(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Configure a server context with a freshly generated self-signed certificate
+ */
+bool useSelfSignedCertificate(ssl::context& context) {
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    if (!key || !cert) {
+        EVP_PKEY_free(key);
+        X509_free(cert);
+        return false;
+    }
+
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    bool ok = X509_sign(cert, key, EVP_sha256()) > 0 &&
+              SSL_CTX_use_certificate(context.native_handle(), cert) == 1 &&
+              SSL_CTX_use_PrivateKey(context.native_handle(), key) == 1;
+
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ok;
+}
+
+/**
+ * @class MockTlsServer
+ * @brief Local TLS server answering HTTP requests until the client closes
+ */
+class MockTlsServer {
+public:
+    MockTlsServer()
+        : m_context(ssl::context::tls_server),
+          m_acceptor(m_ioContext, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0)) {}
+
+    bool start() {
+        if (!useSelfSignedCertificate(m_context)) {
+            return false;
+        }
+        m_thread = std::thread([this]() { run(); });
+        return true;
+    }
+
+    void stop() {
+        // Unblock the pending accept with a last connection
+        m_running.store(false);
+        boost::system::error_code ec;
+        tcp::socket wakeup(m_ioContext);
+        wakeup.connect(m_acceptor.local_endpoint(), ec);
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    unsigned short getPort() const { return m_acceptor.local_endpoint().port(); }
+
+private:
+    net::io_context m_ioContext;
+    ssl::context m_context;
+    tcp::acceptor m_acceptor;
+    std::thread m_thread;
+    std::atomic<bool> m_running{true};
+
+    void run() {
+        while (true) {
+            boost::system::error_code ec;
+            ssl::stream<tcp::socket> stream(m_ioContext, m_context);
+            m_acceptor.accept(stream.next_layer(), ec);
+            if (ec || !m_running.load()) {
+                return;
+            }
+            stream.next_layer().set_option(tcp::no_delay(true));
+            stream.handshake(ssl::stream_base::server, ec);
+            if (ec) {
+                continue;
+            }
+            net::streambuf request;
+            while (!ec) {
+                size_t bytes = net::read_until(stream, request, "\r\n\r\n", ec);
+                if (!ec) {
+                    request.consume(bytes);
+                    net::write(stream, net::buffer(kResponse), ec);
+                }
+            }
+            stream.shutdown(ec);
+        }
+    }
+};
+
+/**
+ * @brief Measure TLS handshake and first request latency against the mock
+ */
+void benchmarkTlsConnect(unsigned short port, int iterations, bool resumption) {
+    TlsContext tls(false);
+    tls.setSessionResumption(resumption);
+
+    net::io_context ioContext;
+    tcp::endpoint endpoint(net::ip::make_address("127.0.0.1"), port);
+    std::vector<double> connect;
+    std::vector<double> handshake;
+    std::vector<double> firstRequest;
+
+    for (int i = 0; i < iterations; ++i) {
+        boost::system::error_code ec;
+        ssl::stream<tcp::socket> stream(ioContext, tls.get());
+
+        auto start = Clock::now();
+        stream.next_layer().connect(endpoint, ec);
+        if (ec) {
+            std::fprintf(stderr, "connect failed: %s\n", ec.message().c_str());
+            return;
+        }
+        stream.next_layer().set_option(tcp::no_delay(true));
+        connect.push_back(elapsedUs(start));
+
+        tls.prepare(stream.native_handle(), "localhost");
+        auto handshakeStart = Clock::now();
+        stream.handshake(ssl::stream_base::client, ec);
+        if (ec) {
+            std::fprintf(stderr, "handshake failed: %s\n", ec.message().c_str());
+            return;
+        }
+        tls.onHandshake(stream.native_handle());
+        handshake.push_back(elapsedUs(handshakeStart));
+
+        // Reading the response also processes post-handshake session tickets
+        auto requestStart = Clock::now();
+        net::write(stream, net::buffer(kRequest), ec);
+        net::streambuf response;
+        net::read_until(stream, response, "}", ec);
+        firstRequest.push_back(elapsedUs(requestStart));
+
+        stream.shutdown(ec);
+    }
+
+    auto stats = tls.getStats();
+    std::printf("TLS connect (%s), %d iterations, %llu resumed, cipher preference %s\n",
+                resumption ? "session resumption" : "full handshake", iterations,
+                static_cast<unsigned long long>(stats.resumed),
+                TlsContext::hasAesAcceleration() ? "AES-GCM" : "ChaCha20-Poly1305");
+    const std::pair<const char*, const std::vector<double>*> series[] = {
+        {"tcp connect", &connect},
+        {"tls handshake", &handshake},
+        {"first request", &firstRequest},
+    };
+    for (const auto& entry : series) {
+        Summary summary = summarize(*entry.second);
+        std::printf("  %-14s p50 %9.1f us  p99 %9.1f us  avg %9.1f us\n",
+                    entry.first, summary.p50, summary.p99, summary.avg);
+    }
+}
+
+/**
+ * @brief Measure REST request latency on a new connection per request vs a warm pool
+ */
+void benchmarkRestPool(unsigned short port, int iterations) {
+    TlsContext tls(false);
+    std::string service = std::to_string(port);
+    RequestParams params;
+    HttpResponse response;
+    std::vector<double> perRequest;
+    std::vector<double> pooled;
+
+    for (int i = 0; i < iterations; ++i) {
+        HttpConnectionPool pool("localhost", service, 1, &tls);
+        params.clear().add("currency", "BTC").add("expired", false);
+        auto start = Clock::now();
+        if (!pool.get("/api/v2/public/test", params, response)) {
+            std::fprintf(stderr, "request failed\n");
+            return;
+        }
+        perRequest.push_back(elapsedUs(start));
+    }
+
+    HttpConnectionPool pool("localhost", service, 1, &tls);
+    pool.warmup(1);
+    for (int i = 0; i < iterations; ++i) {
+        params.clear().add("currency", "BTC").add("expired", false);
+        auto start = Clock::now();
+        if (!pool.get("/api/v2/public/test", params, response)) {
+            std::fprintf(stderr, "request failed\n");
+            return;
+        }
+        pooled.push_back(elapsedUs(start));
+    }
+
+    std::printf("REST request, %d iterations\n", iterations);
+    Summary summary = summarize(perRequest);
+    std::printf("  %-14s p50 %9.1f us  p99 %9.1f us  avg %9.1f us\n",
+                "new connection", summary.p50, summary.p99, summary.avg);
+    summary = summarize(pooled);
+    std::printf("  %-14s p50 %9.1f us  p99 %9.1f us  avg %9.1f us\n",
+                "pooled", summary.p50, summary.p99, summary.avg);
+}
+
+/**
+ * @brief CPU-bound work standing in for an analytics task
+ */
+double spin(int rounds) {
+    double x = 1.0;
+    for (int i = 0; i < rounds; ++i) {
+        x = std::sqrt(x + static_cast<double>(i));
+    }
+    return x;
+}
+
+/**
+ * @brief Split a range of work items in halves down to single items, stealing the halves
+ */
+void splitTask(TaskPool& pool, int begin, int end, int rounds, std::atomic<int>& remaining) {
+    while (end - begin > 1) {
+        int middle = begin + (end - begin) / 2;
+        pool.submit([&pool, middle, end, rounds, &remaining]() {
+            splitTask(pool, middle, end, rounds, remaining);
+        });
+        end = middle;
+    }
+    volatile double sink = spin(rounds);
+    (void)sink;
+    remaining.fetch_sub(1, std::memory_order_release);
+}
+
+/**
+ * @brief Measure task throughput for growing worker counts
+ *
+ * Runs independent tasks submitted from outside the pool, and a recursive
+ * split where all work starts on one worker and spreads by stealing.
+ */
+void benchmarkTaskPool(int iterations) {
+    const int tasks = iterations * 50;
+    const int rounds = 20000;
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned int> counts;
+    for (unsigned int threads = 1; threads < cores; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(cores);
+
+    std::printf("Task pool, %d tasks of %d rounds, %u cores\n", tasks, rounds, cores);
+    double baseline[2] = {0, 0};
+    for (unsigned int threads : counts) {
+        TaskPoolConfig config;
+        config.threads = threads;
+        TaskPool pool(config);
+        pool.start();
+
+        double rates[2];
+        for (int mode = 0; mode < 2; ++mode) {
+            std::atomic<int> remaining(tasks);
+            auto start = Clock::now();
+            if (mode == 0) {
+                for (int i = 0; i < tasks; ++i) {
+                    pool.submit([rounds, &remaining]() {
+                        volatile double sink = spin(rounds);
+                        (void)sink;
+                        remaining.fetch_sub(1, std::memory_order_release);
+                    });
+                }
+            } else {
+                pool.submit([&pool, tasks, rounds, &remaining]() {
+                    splitTask(pool, 0, tasks, rounds, remaining);
+                });
+            }
+            while (remaining.load(std::memory_order_acquire) > 0) {
+                std::this_thread::yield();
+            }
+            rates[mode] = tasks / (elapsedUs(start) / 1e6);
+            if (baseline[mode] == 0) {
+                baseline[mode] = rates[mode];
+            }
+        }
+
+        auto stats = pool.getStats();
+        pool.stop();
+        std::printf("  %2u threads  submitted %9.0f tasks/s (x%.2f)  split %9.0f tasks/s (x%.2f)  %llu stolen\n",
+                    threads, rates[0], rates[0] / baseline[0], rates[1], rates[1] / baseline[1],
+                    static_cast<unsigned long long>(stats.stolen));
+    }
+}
+
+/**
+ * @brief Build the market data notifications fed to the parsing benchmark
+ *
+ * A book snapshot followed by changes continuing its change IDs, each
+ * change deleting and re-adding a level, interleaved with ticker and
+ * trade notifications.
+ */
+std::vector<std::pair<std::string, std::string>> buildMarketData(size_t count) {
+    std::vector<std::pair<std::string, std::string>> messages;
+    messages.reserve(count);
+
+    std::string snapshot = "{\"type\":\"snapshot\",\"timestamp\":1700000000000,"
+                           "\"instrument_name\":\"BTC-PERPETUAL\",\"change_id\":1,\"bids\":[";
+    for (int i = 0; i < 20; ++i) {
+        snapshot += (i ? ",[\"new\"," : "[\"new\",") + std::to_string(50000.0 - 0.5 * i) + ",10.0]";
+    }
+    snapshot += "],\"asks\":[";
+    for (int i = 0; i < 20; ++i) {
+        snapshot += (i ? ",[\"new\"," : "[\"new\",") + std::to_string(50000.5 + 0.5 * i) + ",10.0]";
+    }
+    snapshot += "]}";
+    messages.emplace_back("book.BTC-PERPETUAL.100ms", snapshot);
+
+    int64_t changeId = 1;
+    for (size_t i = 1; i < count; ++i) {
+        if (i % 4 == 1) {
+            std::string price = std::to_string(50000.0 - 0.5 * static_cast<double>(i % 20));
+            messages.emplace_back("ticker.BTC-PERPETUAL.100ms",
+                "{\"timestamp\":1700000000000,\"instrument_name\":\"BTC-PERPETUAL\",\"mark_price\":" + price +
+                ",\"index_price\":50001.2,\"last_price\":" + price + ",\"best_bid_price\":50000.0,"
+                "\"best_bid_amount\":10.0,\"best_ask_price\":50000.5,\"best_ask_amount\":10.0,"
+                "\"open_interest\":12345.0,\"current_funding\":0.0,\"funding_8h\":0.0001,\"state\":\"open\"}");
+        } else if (i % 4 == 3) {
+            messages.emplace_back("trades.BTC-PERPETUAL.raw",
+                "[{\"trade_seq\":" + std::to_string(i) + ",\"trade_id\":\"BTC-" + std::to_string(1000000 + i) +
+                "\",\"timestamp\":1700000000000,\"price\":50000.5,\"instrument_name\":\"BTC-PERPETUAL\","
+                "\"direction\":\"buy\",\"amount\":10.0}]");
+        } else {
+            std::string price = std::to_string(50000.0 - 0.5 * static_cast<double>(i % 20));
+            messages.emplace_back("book.BTC-PERPETUAL.100ms",
+                "{\"type\":\"change\",\"timestamp\":1700000000000,\"prev_change_id\":" +
+                std::to_string(changeId) + ",\"instrument_name\":\"BTC-PERPETUAL\",\"change_id\":" +
+                std::to_string(changeId + 1) + ",\"bids\":[[\"delete\"," + price + ",0.0],[\"new\"," + price +
+                ",7.0]],\"asks\":[[\"change\",50001.0,3.0]]}");
+            ++changeId;
+        }
+    }
+    return messages;
+}
+
+/**
+ * @brief Measure parsing of market data batches and count heap allocations once warm
+ */
+void benchmarkMessageParsing(int iterations) {
+    const size_t batchSize = 16;
+    const size_t warmup = 64;
+    const size_t measured = static_cast<size_t>(iterations) * 50;
+    auto messages = buildMarketData(warmup + measured);
+
+    auto& books = deribit::order::OrderBookManager::getInstance();
+    auto& tickers = deribit::order::TickerCache::getInstance();
+    auto& trades = deribit::order::TradeStore::getInstance();
+    std::vector<WSMessageView> batch;
+    batch.reserve(batchSize);
+
+    // Dispatch batches the way WSClient::flushBatch() does
+    auto feed = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i += batchSize) {
+            ArenaScope scope;
+            batch.clear();
+            for (size_t j = i; j < std::min(end, i + batchSize); ++j) {
+                batch.push_back(WSMessageView{messages[j].first, messages[j].second, {}});
+            }
+            books.onBookMessages(batch);
+            tickers.onTickerMessages(batch);
+            trades.onTradeMessages(batch);
+        }
+    };
+
+    feed(0, warmup);
+    uint64_t allocations = AllocationCounter::getThreadCount();
+    auto start = Clock::now();
+    feed(warmup, warmup + measured);
+    double us = elapsedUs(start);
+    allocations = AllocationCounter::getThreadCount() - allocations;
+
+    auto book = books.getBook("BTC-PERPETUAL");
+    std::printf("Message parsing, %zu messages in batches of %zu\n", measured, batchSize);
+    std::printf("  %.0f ns/message  %.3f heap allocations/message  arena high water %zu bytes  book %s\n",
+                us * 1000.0 / static_cast<double>(measured),
+                static_cast<double>(allocations) / static_cast<double>(measured),
+                Arena::local().getStats().highWater, book && book->isValid() ? "valid" : "INVALID");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+    if (iterations <= 0) {
+        iterations = 200;
+    }
+
+    MockTlsServer server;
+    if (!server.start()) {
+        std::fprintf(stderr, "Failed to start mock TLS server\n");
+        return 1;
+    }
+
+    benchmarkTlsConnect(server.getPort(), iterations, false);
+    benchmarkTlsConnect(server.getPort(), iterations, true);
+    benchmarkRestPool(server.getPort(), iterations);
+
+    server.stop();
+
+    benchmarkTaskPool(iterations);
+    benchmarkMessageParsing(iterations);
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file black_scholes.h
+ * @brief Batched Black-76 pricing, greeks and implied volatility
+ *
+ * This file contains option pricing kernels working on arrays of
+ * options at once. Options are priced on the forward (Black-76), which
+ * is how Deribit quotes them against the underlying future.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace deribit {
+namespace analytics {
+
+/**
+ * @struct OptionInputs
+ * @brief Structure of input arrays for a batch of options
+ *
+ * All arrays hold one value per option. Prices are in the quote currency
+ * (USD for coin-settled Deribit options, i.e. the coin price times the
+ * forward, and USDC as quoted for linear ones).
+ */
+struct OptionInputs {
+    const double* forward;   // forward or underlying future price
+    const double* strike;
+    const double* expiry;    // time to expiry in years
+    const double* sign;      // +1 for calls, -1 for puts
+};
+
+/**
+ * @struct OptionOutputs
+ * @brief Structure of output arrays for a batch of options
+ *
+ * Greeks are per unit of the underlying and per year; vega is per unit
+ * of volatility (divide by 100 for one vol point).
+ */
+struct OptionOutputs {
+    double* price;
+    double* delta;
+    double* gamma;
+    double* vega;
+    double* theta;
+};
+
+/**
+ * @brief Price a batch of options and compute their greeks
+ *
+ * Options with a non-positive expiry, volatility, forward or strike get
+ * their intrinsic value and zero greeks (delta 0 or ±discount).
+ *
+ * @param count Number of options
+ * @param inputs Input arrays
+ * @param vol Volatility per option
+ * @param rate Continuously compounded discount rate (0 for Deribit)
+ * @param outputs Output arrays
+ */
+void priceBatch(size_t count, const OptionInputs& inputs, const double* vol, double rate, const OptionOutputs& outputs);
+
+/**
+ * @brief Solve the implied volatility of a batch of option prices
+ *
+ * Every option runs the same fixed number of safeguarded Newton steps,
+ * so the loop has no data dependent branches. Prices outside the
+ * no-arbitrage bounds yield 0.
+ *
+ * @param count Number of options
+ * @param inputs Input arrays
+ * @param price Option price per option
+ * @param rate Continuously compounded discount rate (0 for Deribit)
+ * @param vol Output volatility per option
+ */
+void impliedVolBatch(size_t count, const OptionInputs& inputs, const double* price, double rate, double* vol);
+
+/**
+ * @brief Price a single option
+ * @param forward Forward price
+ * @param strike Strike
+ * @param expiry Time to expiry in years
+ * @param vol Volatility
+ * @param isCall true for a call, false for a put
+ * @param rate Discount rate
+ * @return Option price
+ */
+double blackPrice(double forward, double strike, double expiry, double vol, bool isCall, double rate = 0);
+
+/**
+ * @brief Standard normal cumulative distribution function
+ *
+ * Branch-free double precision approximation used by the kernels.
+ *
+ * @param x Argument
+ * @return Probability
+ */
+double normalCdf(double x);
+
+/**
+ * @brief Get the instruction set the batched kernels run with
+ * @return "avx512", "avx2" or "scalar"
+ */
+const char* getKernelIsa();
+
+} // namespace analytics
+} // namespace deribit
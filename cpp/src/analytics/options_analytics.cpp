@@ -0,0 +1,331 @@
+/**
+ * @file options_analytics.cpp
+ * @brief Options analytics implementation
+ */
+
+#include "options_analytics.h"
+#include "black_scholes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace deribit {
+namespace analytics {
+
+namespace {
+
+// Index entry for instruments that are not options
+const uint32_t kNotOption = UINT32_MAX;
+
+const double kMillisPerYear = 365.0 * 24 * 3600 * 1000;
+const int64_t kExpiryTimeOfDayMs = 8 * 3600 * 1000;  // 08:00 UTC
+
+/**
+ * @brief Days since 1970-01-01 of a civil date (proleptic Gregorian)
+ */
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+/**
+ * @brief Parse a Deribit expiry date such as "25MAR22" or "5APR24"
+ */
+bool parseExpiry(const std::string& text, int64_t& expiry) {
+    static const char* kMonths[] = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+                                    "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
+    size_t digits = 0;
+    while (digits < text.size() && text[digits] >= '0' && text[digits] <= '9') {
+        ++digits;
+    }
+    if (digits < 1 || digits > 2 || text.size() != digits + 5) {
+        return false;
+    }
+    unsigned day = static_cast<unsigned>(std::atoi(text.substr(0, digits).c_str()));
+    std::string month = text.substr(digits, 3);
+    std::string year = text.substr(digits + 3, 2);
+    if (year[0] < '0' || year[0] > '9' || year[1] < '0' || year[1] > '9') {
+        return false;
+    }
+    for (unsigned i = 0; i < 12; ++i) {
+        if (month == kMonths[i]) {
+            int64_t days = daysFromCivil(2000 + std::atoi(year.c_str()), i + 1, day);
+            expiry = days * 86400000 + kExpiryTimeOfDayMs;
+            return day >= 1 && day <= 31;
+        }
+    }
+    return false;
+}
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+bool parseOptionName(const std::string& name, OptionContract& contract) {
+    // CURRENCY-EXPIRY-STRIKE-TYPE
+    size_t first = name.find('-');
+    size_t second = first == std::string::npos ? first : name.find('-', first + 1);
+    size_t third = second == std::string::npos ? second : name.find('-', second + 1);
+    if (third == std::string::npos || third + 2 != name.size()) {
+        return false;
+    }
+    char type = name[third + 1];
+    if (type != 'C' && type != 'P') {
+        return false;
+    }
+
+    std::string strike = name.substr(second + 1, third - second - 1);
+    for (auto& c : strike) {
+        if (c == 'd') {
+            c = '.';
+        }
+    }
+    char* end = nullptr;
+    double value = std::strtod(strike.c_str(), &end);
+    if (strike.empty() || end != strike.c_str() + strike.size() || value <= 0) {
+        return false;
+    }
+
+    int64_t expiry = 0;
+    if (!parseExpiry(name.substr(first + 1, second - first - 1), expiry)) {
+        return false;
+    }
+
+    contract.currency = name.substr(0, first);
+    contract.expiry = expiry;
+    contract.strike = value;
+    contract.isCall = type == 'C';
+    contract.inverse = contract.currency.find("_USDC") == std::string::npos;
+    return true;
+}
+
+OptionsAnalytics& OptionsAnalytics::getInstance() {
+    static OptionsAnalytics instance;
+    return instance;
+}
+
+void OptionsAnalytics::onTicker(const std::string& instrument, const order::Ticker& ticker) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t slot;
+    auto it = m_writerIndex.find(instrument);
+    if (it != m_writerIndex.end()) {
+        slot = it->second;
+    } else {
+        OptionContract contract;
+        slot = parseOptionName(instrument, contract) ? addOption(instrument, contract) : kNotOption;
+        m_writerIndex.emplace(instrument, slot);
+    }
+    if (slot == kNotOption) {
+        return;
+    }
+
+    // Coin-settled options are quoted in the underlying, linear ones in USDC
+    double forward = ticker.underlyingPrice > 0 ? ticker.underlyingPrice : ticker.indexPrice;
+    double scale = m_contracts[slot].inverse ? forward : 1.0;
+    double mark = ticker.markPrice * scale;
+    double bid = ticker.bestBidPrice * scale;
+    double ask = ticker.bestAskPrice * scale;
+    m_timestamps[slot] = ticker.timestamp;
+    if (forward == m_forwards[slot] && mark == m_marks[slot] && bid == m_bids[slot] && ask == m_asks[slot]) {
+        return;
+    }
+    ++m_versions[slot];
+    m_forwards[slot] = forward;
+    m_marks[slot] = mark;
+    m_bids[slot] = bid;
+    m_asks[slot] = ask;
+    if (!m_dirtyFlags[slot]) {
+        m_dirtyFlags[slot] = 1;
+        m_dirty.push_back(slot);
+    }
+}
+
+size_t OptionsAnalytics::recompute(bool all) {
+    auto& batch = all ? m_fullBatch : m_dirtyBatch;
+    std::lock_guard<std::mutex> batchLock(batch.mutex);
+    batch.slots.clear();
+    size_t count;
+    int64_t now = nowMs();
+    {
+        // Copy the inputs, the solve below runs without the writer lock
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (all) {
+            for (uint32_t slot = 0; slot < m_contracts.size(); ++slot) {
+                if (m_contracts[slot].expiry > 0 && m_forwards[slot] > 0) {
+                    batch.slots.push_back(slot);
+                }
+            }
+        } else {
+            batch.slots.swap(m_dirty);
+        }
+        for (uint32_t slot : m_dirty) {
+            m_dirtyFlags[slot] = 0;
+        }
+        for (uint32_t slot : batch.slots) {
+            m_dirtyFlags[slot] = 0;
+        }
+        m_dirty.clear();
+
+        count = batch.slots.size();
+        if (count == 0) {
+            return 0;
+        }
+
+        // Gather the inputs into contiguous arrays
+        for (auto* column : {&batch.forward, &batch.strike, &batch.expiry, &batch.sign, &batch.mark,
+                             &batch.bid, &batch.ask, &batch.markIv, &batch.bidIv, &batch.askIv,
+                             &batch.price, &batch.delta, &batch.gamma, &batch.vega, &batch.theta}) {
+            column->resize(count);
+        }
+        batch.versions.resize(count);
+        batch.timestamps.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t slot = batch.slots[i];
+            const auto& contract = m_contracts[slot];
+            batch.versions[i] = m_versions[slot];
+            batch.timestamps[i] = m_timestamps[slot];
+            batch.forward[i] = m_forwards[slot];
+            batch.strike[i] = contract.strike;
+            batch.expiry[i] = static_cast<double>(contract.expiry - now) / kMillisPerYear;
+            batch.sign[i] = contract.isCall ? 1.0 : -1.0;
+            batch.mark[i] = m_marks[slot];
+            batch.bid[i] = m_bids[slot];
+            batch.ask[i] = m_asks[slot];
+        }
+    }
+
+    OptionInputs inputs{batch.forward.data(), batch.strike.data(), batch.expiry.data(), batch.sign.data()};
+    impliedVolBatch(count, inputs, batch.mark.data(), 0, batch.markIv.data());
+    impliedVolBatch(count, inputs, batch.bid.data(), 0, batch.bidIv.data());
+    impliedVolBatch(count, inputs, batch.ask.data(), 0, batch.askIv.data());
+    priceBatch(count, inputs, batch.markIv.data(), 0, OptionOutputs{
+        batch.price.data(), batch.delta.data(), batch.gamma.data(), batch.vega.data(), batch.theta.data()
+    });
+
+    // Scatter into the published slots, skipping options that were removed
+    // or already published from newer inputs in the meantime
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t slot = batch.slots[i];
+        if (batch.versions[i] < m_published[slot]) {
+            continue;
+        }
+        m_published[slot] = batch.versions[i];
+
+        OptionGreeks greeks;
+        greeks.forward = batch.forward[i];
+        greeks.expiry = batch.expiry[i];
+        greeks.markPrice = batch.mark[i];
+        greeks.markIv = batch.markIv[i];
+        greeks.bidIv = batch.bidIv[i];
+        greeks.askIv = batch.askIv[i];
+        greeks.delta = batch.delta[i];
+        greeks.gamma = batch.gamma[i];
+        greeks.vega = batch.vega[i];
+        greeks.theta = batch.theta[i];
+        greeks.timestamp = batch.timestamps[i];
+        greeks.valid = true;
+        m_slots[slot].store(greeks);
+    }
+    return count;
+}
+
+const GreeksSlot* OptionsAnalytics::getSlot(const std::string& instrument) {
+    std::lock_guard<std::mutex> lock(m_slotsMutex);
+    auto it = m_readerIndex.find(instrument);
+    return it != m_readerIndex.end() ? &m_slots[it->second] : nullptr;
+}
+
+bool OptionsAnalytics::getGreeks(const std::string& instrument, OptionGreeks& greeks) {
+    const GreeksSlot* slot = getSlot(instrument);
+    if (!slot) {
+        return false;
+    }
+    greeks = slot->load();
+    return greeks.valid;
+}
+
+size_t OptionsAnalytics::getChain(const std::string& currency,
+                                  std::vector<std::pair<std::string, OptionGreeks>>& chain) {
+    chain.clear();
+    std::lock_guard<std::mutex> lock(m_slotsMutex);
+    std::string prefix = currency + "-";
+    for (auto it = m_readerIndex.lower_bound(prefix);
+         it != m_readerIndex.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+        OptionGreeks greeks = m_slots[it->second].load();
+        if (greeks.valid) {
+            chain.emplace_back(it->first, greeks);
+        }
+    }
+    return chain.size();
+}
+
+void OptionsAnalytics::removeOption(const std::string& instrument) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_writerIndex.find(instrument);
+    if (it == m_writerIndex.end()) {
+        return;
+    }
+    uint32_t slot = it->second;
+    m_writerIndex.erase(it);
+    if (slot == kNotOption) {
+        return;
+    }
+
+    m_contracts[slot] = OptionContract();
+    m_forwards[slot] = 0;
+    // Results still being computed for the option are dropped
+    m_published[slot] = ++m_versions[slot];
+    if (m_dirtyFlags[slot]) {
+        m_dirtyFlags[slot] = 0;
+        m_dirty.erase(std::find(m_dirty.begin(), m_dirty.end(), slot));
+    }
+    m_free.push_back(slot);
+
+    std::lock_guard<std::mutex> slotsLock(m_slotsMutex);
+    m_readerIndex.erase(instrument);
+    m_slots[slot].store(OptionGreeks());
+}
+
+uint32_t OptionsAnalytics::addOption(const std::string& instrument, const OptionContract& contract) {
+    uint32_t slot;
+    if (!m_free.empty()) {
+        slot = m_free.back();
+        m_free.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_contracts.size());
+        m_contracts.emplace_back();
+        m_forwards.push_back(0);
+        m_marks.push_back(0);
+        m_bids.push_back(0);
+        m_asks.push_back(0);
+        m_timestamps.push_back(0);
+        m_versions.push_back(0);
+        m_published.push_back(0);
+        m_dirtyFlags.push_back(0);
+    }
+    m_contracts[slot] = contract;
+    m_forwards[slot] = 0;
+    m_marks[slot] = 0;
+    m_bids[slot] = 0;
+    m_asks[slot] = 0;
+    m_published[slot] = ++m_versions[slot];
+
+    std::lock_guard<std::mutex> lock(m_slotsMutex);
+    if (slot == m_slots.size()) {
+        m_slots.emplace_back();
+    }
+    m_readerIndex[instrument] = slot;
+    return slot;
+}
+
+} // namespace analytics
+} // namespace deribit
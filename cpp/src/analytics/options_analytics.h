@@ -0,0 +1,198 @@
+/**
+ * @file options_analytics.h
+ * @brief Implied volatility and greeks for option chains
+ *
+ * This file contains the engine keeping the implied volatilities and
+ * greeks of every subscribed option up to date from its ticker.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <cstdint>
+#include "../order/ticker_cache.h"
+#include "../utils/seqlock.h"
+
+namespace deribit {
+namespace analytics {
+
+/**
+ * @struct OptionContract
+ * @brief Structure describing an option, parsed from its instrument name
+ */
+struct OptionContract {
+    std::string currency;    // e.g. "BTC" or "XRP_USDC"
+    int64_t expiry;          // milliseconds since epoch
+    double strike;
+    bool isCall;
+    bool inverse;            // coin-settled, priced in the underlying rather than USDC
+
+    OptionContract() : expiry(0), strike(0), isCall(true), inverse(true) {}
+};
+
+/**
+ * @brief Parse an option instrument name such as "BTC-25MAR22-50000-C"
+ *
+ * Deribit options expire at 08:00 UTC; decimal strikes use 'd' as the
+ * separator ("0d625").
+ *
+ * @param name Instrument name
+ * @param contract Output contract
+ * @return true if the name is an option, false otherwise
+ */
+bool parseOptionName(const std::string& name, OptionContract& contract);
+
+/**
+ * @struct OptionGreeks
+ * @brief Structure for the analytics of an option
+ *
+ * Prices are in the quote currency (USD for coin-settled options, USDC
+ * for linear ones); the greeks are those of Black-76 at the mark volatility.
+ */
+struct OptionGreeks {
+    double forward;          // underlying price from the ticker
+    double expiry;           // years to expiry when computed
+    double markPrice;
+    double markIv;           // 0 if the mark is outside the no-arbitrage bounds
+    double bidIv;            // 0 without a bid
+    double askIv;            // 0 without an ask
+    double delta;
+    double gamma;
+    double vega;             // per unit of volatility
+    double theta;            // per year
+    int64_t timestamp;       // ticker time, milliseconds since epoch
+    bool valid;
+
+    OptionGreeks() : forward(0), expiry(0), markPrice(0), markIv(0), bidIv(0), askIv(0), delta(0),
+                     gamma(0), vega(0), theta(0), timestamp(0), valid(false) {}
+};
+
+using GreeksSlot = utils::SeqLock<OptionGreeks>;
+
+/**
+ * @class OptionsAnalytics
+ * @brief Class for computing option analytics incrementally
+ *
+ * Tickers only mark their option dirty; recompute() then solves the
+ * dirty options together with the batched kernels, so a burst of
+ * thousands of tickers costs one pass over contiguous arrays. The inputs
+ * are copied under the writer lock and solved outside it, so tickers keep
+ * flowing while a chain is repriced. Results are published per option in
+ * a seqlock slot that readers load without locking.
+ */
+class OptionsAnalytics {
+public:
+    /**
+     * @brief Get the instance (singleton)
+     * @return Reference to OptionsAnalytics instance
+     */
+    static OptionsAnalytics& getInstance();
+
+    /**
+     * @brief Record the ticker of an instrument, see TickerCache::setOnTicker()
+     *
+     * Tickers of instruments that are not options are ignored. The option
+     * is marked dirty only if its underlying or quotes changed.
+     *
+     * @param instrument Instrument name
+     * @param ticker Latest ticker
+     */
+    void onTicker(const std::string& instrument, const order::Ticker& ticker);
+
+    /**
+     * @brief Recompute the analytics of the options whose inputs changed
+     *
+     * Incremental and full recomputes may run concurrently on different
+     * threads; a result is not published over one computed from newer inputs.
+     *
+     * @param all Recompute every option, e.g. periodically for time decay
+     * @return Number of options recomputed
+     */
+    size_t recompute(bool all = false);
+
+    /**
+     * @brief Get the slot of an option
+     * @param instrument Instrument name
+     * @return Slot, valid until the option is removed, or nullptr if unknown
+     */
+    const GreeksSlot* getSlot(const std::string& instrument);
+
+    /**
+     * @brief Get the latest analytics of an option
+     * @param instrument Instrument name
+     * @param greeks Output analytics
+     * @return true if computed at least once, false otherwise
+     */
+    bool getGreeks(const std::string& instrument, OptionGreeks& greeks);
+
+    /**
+     * @brief Get the analytics of all options of a currency
+     * @param currency Currency, e.g. "BTC"
+     * @param chain Output instrument names and analytics, cleared first
+     * @return Number of options
+     */
+    size_t getChain(const std::string& currency, std::vector<std::pair<std::string, OptionGreeks>>& chain);
+
+    /**
+     * @brief Stop tracking an option
+     * @param instrument Instrument name
+     */
+    void removeOption(const std::string& instrument);
+
+private:
+    // Private constructor for singleton
+    OptionsAnalytics() = default;
+
+    // Prevent copying and assignment
+    OptionsAnalytics(const OptionsAnalytics&) = delete;
+    OptionsAnalytics& operator=(const OptionsAnalytics&) = delete;
+
+    // Writer state, one entry per option slot; guarded by m_mutex
+    std::vector<OptionContract> m_contracts;
+    std::vector<double> m_forwards;
+    std::vector<double> m_marks;
+    std::vector<double> m_bids;
+    std::vector<double> m_asks;
+    std::vector<int64_t> m_timestamps;
+    std::vector<uint64_t> m_versions;       // bumped on every input change
+    std::vector<uint64_t> m_published;      // version of the published result
+    std::vector<uint8_t> m_dirtyFlags;
+    std::vector<uint32_t> m_dirty;
+    std::vector<uint32_t> m_free;
+    std::map<std::string, uint32_t, std::less<>> m_writerIndex;
+    std::mutex m_mutex;
+
+    // Scratch arrays for the batched kernels, one set each for the
+    // incremental and the full recompute; guarded by their own mutex
+    struct Batch {
+        std::mutex mutex;
+        std::vector<uint32_t> slots;
+        std::vector<uint64_t> versions;
+        std::vector<int64_t> timestamps;
+        std::vector<double> forward, strike, expiry, sign, mark, bid, ask;
+        std::vector<double> markIv, bidIv, askIv, price, delta, gamma, vega, theta;
+    };
+    Batch m_dirtyBatch;
+    Batch m_fullBatch;
+
+    // Reader state; slots are never freed so pointers stay valid
+    std::deque<GreeksSlot> m_slots;
+    std::map<std::string, uint32_t, std::less<>> m_readerIndex;
+    std::mutex m_slotsMutex;
+
+    /**
+     * @brief Add an option, reusing a removed slot if any
+     * @param instrument Instrument name
+     * @param contract Parsed contract
+     * @return Slot index
+     */
+    uint32_t addOption(const std::string& instrument, const OptionContract& contract);
+};
+
+} // namespace analytics
+} // namespace deribit
@@ -0,0 +1,412 @@
+/**
+ * @file vol_surface.cpp
+ * @brief Volatility surface implementation
+ */
+
+#include "vol_surface.h"
+#include "options_analytics.h"
+#include "../utils/config.h"
+#include "../utils/task_pool.h"
+#include "../utils/logger.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace deribit {
+namespace analytics {
+
+namespace {
+
+const double kMillisPerYear = 365.0 * 24 * 3600 * 1000;
+
+// Nelder-Mead search over (m, ln sigma); a warm start only needs to track
+// the previous optimum, a cold one has to find it
+const int kColdIterations = 200;
+const int kWarmIterations = 40;
+const double kColdStep[2] = {0.1, 0.7};
+const double kWarmStep[2] = {0.02, 0.2};
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Fit a, b and rho for fixed m and sigma by linear least squares
+ *
+ * With y = (k - m) / sigma the model is linear: w = a + d y + c z, where
+ * z = sqrt(y^2 + 1), c = b sigma and d = rho b sigma. b >= 0 and
+ * |rho| <= 1 are enforced by clamping c and d and refitting a.
+ *
+ * @return Sum of squared errors in total variance
+ */
+double fitLinear(const std::vector<double>& k, const std::vector<double>& w, double m, double sigma,
+                 SviParams& params) {
+    size_t n = k.size();
+    double s1 = 0, sy = 0, sz = 0, syy = 0, syz = 0, szz = 0, sw = 0, syw = 0, szw = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double y = (k[i] - m) / sigma;
+        double z = std::sqrt(y * y + 1.0);
+        s1 += 1;
+        sy += y;
+        sz += z;
+        syy += y * y;
+        syz += y * z;
+        szz += z * z;
+        sw += w[i];
+        syw += y * w[i];
+        szw += z * w[i];
+    }
+
+    // Normal equations [s1 sy sz; sy syy syz; sz syz szz] [a d c] = [sw syw szw]
+    double det = s1 * (syy * szz - syz * syz) - sy * (sy * szz - syz * sz) + sz * (sy * syz - syy * sz);
+    double a = sw / s1;
+    double d = 0;
+    double c = 0;
+    if (std::fabs(det) > 1e-12) {
+        a = (sw * (syy * szz - syz * syz) - sy * (syw * szz - syz * szw) + sz * (syw * syz - syy * szw)) / det;
+        d = (s1 * (syw * szz - szw * syz) - sw * (sy * szz - syz * sz) + sz * (sy * szw - syw * sz)) / det;
+        c = (s1 * (syy * szw - syz * syw) - sy * (sy * szw - syw * sz) + sw * (sy * syz - syy * sz)) / det;
+    }
+
+    if (c < 0 || std::fabs(d) > c) {
+        c = std::max(c, 0.0);
+        d = std::max(-c, std::min(d, c));
+        a = (sw - d * sy - c * sz) / s1;
+    }
+
+    params.a = a;
+    params.b = c / sigma;
+    params.rho = c > 0 ? d / c : 0.0;
+    params.m = m;
+    params.sigma = sigma;
+
+    double error = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double residual = params.totalVariance(k[i]) - w[i];
+        error += residual * residual;
+    }
+    return error;
+}
+
+} // namespace
+
+double SviParams::totalVariance(double k) const {
+    double x = k - m;
+    return a + b * (rho * x + std::sqrt(x * x + sigma * sigma));
+}
+
+VolSurface::VolSurface(std::string currency, std::vector<ExpirySmile> smiles, int64_t builtAt, uint64_t version)
+    : m_currency(std::move(currency)),
+      m_smiles(std::move(smiles)),
+      m_builtAt(builtAt),
+      m_version(version) {}
+
+double VolSurface::getVol(double strike, int64_t expiry) const {
+    if (m_smiles.empty() || strike <= 0) {
+        return 0.0;
+    }
+    auto variance = [strike](const ExpirySmile& smile) {
+        return std::max(smile.params.totalVariance(std::log(strike / smile.forward)), 0.0);
+    };
+
+    auto next = std::lower_bound(m_smiles.begin(), m_smiles.end(), expiry,
+        [](const ExpirySmile& smile, int64_t value) { return smile.expiry < value; });
+    if (next == m_smiles.begin() || next == m_smiles.end()) {
+        const auto& nearest = next == m_smiles.end() ? m_smiles.back() : m_smiles.front();
+        return nearest.years > 0 ? std::sqrt(variance(nearest) / nearest.years) : 0.0;
+    }
+
+    const auto& previous = *(next - 1);
+    double weight = static_cast<double>(expiry - previous.expiry) / static_cast<double>(next->expiry - previous.expiry);
+    double total = variance(previous) + weight * (variance(*next) - variance(previous));
+    double years = static_cast<double>(expiry - m_builtAt) / kMillisPerYear;
+    return years > 0 ? std::sqrt(total / years) : 0.0;
+}
+
+VolSurfaceConfig VolSurfaceConfig::fromConfig(const utils::Config& config) {
+    VolSurfaceConfig result;
+    result.enabled = config.getBool("surface.enabled", result.enabled);
+    auto currencies = config.getStringList("surface.currencies");
+    if (!currencies.empty()) {
+        result.currencies = currencies;
+    }
+    result.refreshInterval = std::chrono::milliseconds(config.getUInt(
+        "surface.refresh_interval_ms",
+        static_cast<unsigned int>(result.refreshInterval.count())
+    ));
+    result.ivThreshold = config.getDouble("surface.iv_threshold", result.ivThreshold);
+    result.forwardThreshold = config.getDouble("surface.forward_threshold", result.forwardThreshold);
+    result.minPoints = config.getUInt("surface.min_points", static_cast<unsigned int>(result.minPoints));
+    return result;
+}
+
+VolSurfaceBuilder::VolSurfaceBuilder(VolSurfaceConfig config, utils::TaskPool& pool)
+    : m_config(std::move(config)), m_pool(pool) {
+    for (const auto& name : m_config.currencies) {
+        auto currency = std::make_unique<Currency>();
+        currency->name = name;
+        m_currencies.push_back(std::move(currency));
+    }
+}
+
+VolSurfaceBuilder::~VolSurfaceBuilder() {
+    stop();
+}
+
+bool VolSurfaceBuilder::start() {
+    return m_config.enabled && !m_running.exchange(true);
+}
+
+void VolSurfaceBuilder::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_inFlightMutex);
+    m_inFlightCondition.wait(lock, [this]() { return m_inFlight == 0; });
+}
+
+size_t VolSurfaceBuilder::refresh() {
+    if (!m_running.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    auto& analytics = OptionsAnalytics::getInstance();
+    std::vector<std::pair<std::string, OptionGreeks>> chain;
+    size_t queued = 0;
+    int64_t now = nowMs();
+
+    for (auto& entry : m_currencies) {
+        Currency& currency = *entry;
+        if (currency.building.load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        // One quote per strike, from the out-of-the-money side
+        std::map<int64_t, std::vector<std::pair<double, double>>> quotes;
+        std::map<int64_t, std::pair<double, double>> timing;  // forward sum, years
+        analytics.getChain(currency.name, chain);
+        OptionContract contract;
+        for (const auto& option : chain) {
+            const auto& greeks = option.second;
+            if (greeks.markIv <= 0 || greeks.expiry <= 0 || !parseOptionName(option.first, contract)) {
+                continue;
+            }
+            bool outOfTheMoney = contract.isCall ? contract.strike >= greeks.forward : contract.strike < greeks.forward;
+            if (!outOfTheMoney) {
+                continue;
+            }
+            quotes[contract.expiry].emplace_back(contract.strike, greeks.markIv);
+            auto& time = timing[contract.expiry];
+            time.first += greeks.forward;
+            time.second = greeks.expiry;
+        }
+
+        bool changed = false;
+        std::vector<ExpiryState*> dirty;
+        for (auto it = currency.expiries.begin(); it != currency.expiries.end();) {
+            auto found = quotes.find(it->first);
+            if (found == quotes.end() || found->second.size() < m_config.minPoints) {
+                it = currency.expiries.erase(it);
+                changed = true;
+            } else {
+                ++it;
+            }
+        }
+
+        for (auto& expiry : quotes) {
+            auto& points = expiry.second;
+            if (points.size() < m_config.minPoints) {
+                continue;
+            }
+            std::sort(points.begin(), points.end());
+
+            ExpiryInputs inputs;
+            inputs.expiry = expiry.first;
+            inputs.years = timing[expiry.first].second;
+            inputs.forward = timing[expiry.first].first / static_cast<double>(points.size());
+            for (const auto& point : points) {
+                inputs.strikes.push_back(point.first);
+                inputs.vols.push_back(point.second);
+            }
+
+            auto& state = currency.expiries[expiry.first];
+            const auto& previous = state.inputs;
+            bool refit = !state.fitted || previous.strikes != inputs.strikes ||
+                std::fabs(inputs.forward / previous.forward - 1.0) > m_config.forwardThreshold;
+            for (size_t i = 0; !refit && i < inputs.vols.size(); ++i) {
+                refit = std::fabs(inputs.vols[i] - previous.vols[i]) > m_config.ivThreshold;
+            }
+            if (refit) {
+                state.inputs = std::move(inputs);
+                dirty.push_back(&state);
+            }
+        }
+
+        if (dirty.empty() && !changed) {
+            continue;
+        }
+
+        currency.builtAt = now;
+        currency.building.store(true, std::memory_order_release);
+        currency.pending = dirty.size();
+        if (dirty.empty()) {
+            publish(currency);
+            continue;
+        }
+        for (ExpiryState* state : dirty) {
+            post(currency, *state);
+        }
+        queued += dirty.size();
+    }
+    return queued;
+}
+
+std::shared_ptr<const VolSurface> VolSurfaceBuilder::getSurface(const std::string& currency) const {
+    for (const auto& entry : m_currencies) {
+        if (entry->name == currency) {
+            return entry->surface.load(std::memory_order_acquire);
+        }
+    }
+    return nullptr;
+}
+
+void VolSurfaceBuilder::post(Currency& currency, ExpiryState& state) {
+    {
+        std::lock_guard<std::mutex> lock(m_inFlightMutex);
+        ++m_inFlight;
+    }
+    bool queued = m_pool.submit([this, &currency, &state]() {
+        // Fits queued before stop() are skipped and redone after a restart
+        if (m_running.load(std::memory_order_acquire)) {
+            fit(state);
+        } else {
+            state.fitted = false;
+        }
+        complete(currency);
+    });
+    if (!queued) {
+        state.fitted = false;
+        complete(currency);
+    }
+}
+
+void VolSurfaceBuilder::complete(Currency& currency) {
+    if (currency.pending.fetch_sub(1) == 1) {
+        publish(currency);
+    }
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+    if (--m_inFlight == 0) {
+        m_inFlightCondition.notify_all();
+    }
+}
+
+void VolSurfaceBuilder::fit(ExpiryState& state) {
+    const auto& inputs = state.inputs;
+    size_t n = inputs.strikes.size();
+    std::vector<double> k(n);
+    std::vector<double> w(n);
+    for (size_t i = 0; i < n; ++i) {
+        k[i] = std::log(inputs.strikes[i] / inputs.forward);
+        w[i] = inputs.vols[i] * inputs.vols[i] * inputs.years;
+    }
+
+    // Nelder-Mead over x = (m, ln sigma), the rest is solved linearly
+    bool warm = state.fitted;
+    SviParams start = warm ? state.smile.params : SviParams();
+    const double* step = warm ? kWarmStep : kColdStep;
+    int iterations = warm ? kWarmIterations : kColdIterations;
+
+    using Point = std::array<double, 2>;
+    SviParams params;
+    auto objective = [&k, &w, &params](const Point& x) {
+        return fitLinear(k, w, x[0], std::exp(x[1]), params);
+    };
+
+    std::array<Point, 3> simplex = {{
+        {start.m, std::log(start.sigma)},
+        {start.m + step[0], std::log(start.sigma)},
+        {start.m, std::log(start.sigma) + step[1]},
+    }};
+    std::array<double, 3> values;
+    for (size_t i = 0; i < 3; ++i) {
+        values[i] = objective(simplex[i]);
+    }
+
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        // Order best to worst
+        std::array<size_t, 3> order = {0, 1, 2};
+        std::sort(order.begin(), order.end(), [&values](size_t x, size_t y) { return values[x] < values[y]; });
+        std::array<Point, 3> sorted = {simplex[order[0]], simplex[order[1]], simplex[order[2]]};
+        std::array<double, 3> sortedValues = {values[order[0]], values[order[1]], values[order[2]]};
+        simplex = sorted;
+        values = sortedValues;
+
+        Point centroid = {(simplex[0][0] + simplex[1][0]) / 2, (simplex[0][1] + simplex[1][1]) / 2};
+        auto along = [&centroid, &simplex](double factor) {
+            return Point{centroid[0] + factor * (simplex[2][0] - centroid[0]),
+                         centroid[1] + factor * (simplex[2][1] - centroid[1])};
+        };
+
+        Point reflected = along(-1.0);
+        double reflectedValue = objective(reflected);
+        if (reflectedValue < values[0]) {
+            Point expanded = along(-2.0);
+            double expandedValue = objective(expanded);
+            simplex[2] = expandedValue < reflectedValue ? expanded : reflected;
+            values[2] = std::min(expandedValue, reflectedValue);
+        } else if (reflectedValue < values[1]) {
+            simplex[2] = reflected;
+            values[2] = reflectedValue;
+        } else {
+            Point contracted = along(0.5);
+            double contractedValue = objective(contracted);
+            if (contractedValue < values[2]) {
+                simplex[2] = contracted;
+                values[2] = contractedValue;
+            } else {
+                for (size_t i = 1; i < 3; ++i) {
+                    simplex[i] = {(simplex[0][0] + simplex[i][0]) / 2, (simplex[0][1] + simplex[i][1]) / 2};
+                    values[i] = objective(simplex[i]);
+                }
+            }
+        }
+    }
+
+    size_t best = std::min_element(values.begin(), values.end()) - values.begin();
+    objective(simplex[best]);
+
+    double squared = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double vol = std::sqrt(std::max(params.totalVariance(k[i]), 0.0) / inputs.years);
+        squared += (vol - inputs.vols[i]) * (vol - inputs.vols[i]);
+    }
+
+    state.smile.expiry = inputs.expiry;
+    state.smile.years = inputs.years;
+    state.smile.forward = inputs.forward;
+    state.smile.params = params;
+    state.smile.rmse = std::sqrt(squared / static_cast<double>(n));
+    state.smile.points = n;
+    state.fitted = true;
+    ++m_fits;
+}
+
+void VolSurfaceBuilder::publish(Currency& currency) {
+    std::vector<ExpirySmile> smiles;
+    smiles.reserve(currency.expiries.size());
+    for (const auto& expiry : currency.expiries) {
+        if (expiry.second.fitted) {
+            smiles.push_back(expiry.second.smile);
+        }
+    }
+
+    std::shared_ptr<const VolSurface> surface = std::make_shared<VolSurface>(
+        currency.name, std::move(smiles), currency.builtAt, ++currency.version);
+    currency.surface.store(std::move(surface), std::memory_order_release);
+    currency.building.store(false, std::memory_order_release);
+}
+
+} // namespace analytics
+} // namespace deribit
@@ -0,0 +1,280 @@
+/**
+ * @file vol_surface.h
+ * @brief Implied volatility surfaces fitted from option analytics
+ *
+ * This file contains the SVI parametrization of a smile, the immutable
+ * surface of one currency and the builder refitting surfaces on the task
+ * pool as option quotes move.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace deribit {
+
+namespace utils {
+class Config;
+class TaskPool;
+} // namespace utils
+
+namespace analytics {
+
+/**
+ * @struct SviParams
+ * @brief Structure for the raw SVI parameters of a smile
+ *
+ * Total implied variance at log-moneyness k = ln(K / F) is
+ * w(k) = a + b (rho (k - m) + sqrt((k - m)^2 + sigma^2)).
+ */
+struct SviParams {
+    double a;
+    double b;
+    double rho;
+    double m;
+    double sigma;
+
+    SviParams() : a(0), b(0), rho(0), m(0), sigma(0.1) {}
+
+    /**
+     * @brief Evaluate the total implied variance
+     * @param k Log-moneyness
+     * @return Total variance
+     */
+    double totalVariance(double k) const;
+};
+
+/**
+ * @struct ExpirySmile
+ * @brief Structure for the fitted smile of one expiry
+ */
+struct ExpirySmile {
+    int64_t expiry;     // milliseconds since epoch
+    double years;       // time to expiry when fitted
+    double forward;
+    SviParams params;
+    double rmse;        // fit error in volatility
+    size_t points;      // quotes fitted
+
+    ExpirySmile() : expiry(0), years(0), forward(0), rmse(0), points(0) {}
+};
+
+/**
+ * @class VolSurface
+ * @brief Class for an immutable implied volatility surface of one currency
+ */
+class VolSurface {
+public:
+    /**
+     * @brief Constructor
+     * @param currency Currency, e.g. "BTC"
+     * @param smiles Smiles, sorted by expiry
+     * @param builtAt Time of the inputs, milliseconds since epoch
+     * @param version Version, increasing with every rebuild
+     */
+    VolSurface(std::string currency, std::vector<ExpirySmile> smiles, int64_t builtAt, uint64_t version);
+
+    /**
+     * @brief Get the implied volatility of a strike and expiry
+     *
+     * Total variance is interpolated linearly in time between the
+     * bracketing smiles at the same strike, and extrapolated with the
+     * volatility of the nearest smile.
+     *
+     * @param strike Strike
+     * @param expiry Expiry, milliseconds since epoch
+     * @return Volatility, 0 if the surface is empty
+     */
+    double getVol(double strike, int64_t expiry) const;
+
+    const std::string& getCurrency() const { return m_currency; }
+    const std::vector<ExpirySmile>& getSmiles() const { return m_smiles; }
+    int64_t getBuiltAt() const { return m_builtAt; }
+    uint64_t getVersion() const { return m_version; }
+
+private:
+    std::string m_currency;
+    std::vector<ExpirySmile> m_smiles;
+    int64_t m_builtAt;
+    uint64_t m_version;
+};
+
+/**
+ * @struct VolSurfaceConfig
+ * @brief Structure for the surface builder settings
+ */
+struct VolSurfaceConfig {
+    bool enabled;
+    std::vector<std::string> currencies;
+    std::chrono::milliseconds refreshInterval;
+    double ivThreshold;         // largest quote move, in volatility, that keeps a fit
+    double forwardThreshold;    // largest relative forward move that keeps a fit
+    size_t minPoints;           // quotes needed to fit an expiry
+
+    VolSurfaceConfig() :
+        enabled(true),
+        currencies{"BTC", "ETH"},
+        refreshInterval(500),
+        ivThreshold(0.0025),
+        forwardThreshold(0.0005),
+        minPoints(5) {}
+
+    /**
+     * @brief Build from the "surface" section of the configuration
+     * @param config Configuration
+     * @return Surface builder configuration
+     */
+    static VolSurfaceConfig fromConfig(const utils::Config& config);
+};
+
+/**
+ * @class VolSurfaceBuilder
+ * @brief Class refitting volatility surfaces off the market data thread
+ *
+ * refresh() reads the option chains from OptionsAnalytics and queues a
+ * fit for each expiry whose quotes or forward moved beyond the
+ * thresholds; other expiries keep their previous fit. Fits run on the
+ * task pool and start from the previous parameters. The last fit
+ * of a rebuild publishes the new surface with an atomic pointer swap, so
+ * readers never wait for a fit.
+ */
+class VolSurfaceBuilder {
+public:
+    /**
+     * @brief Constructor
+     * @param config Builder configuration
+     * @param pool Pool running the fits, must outlive the builder
+     */
+    VolSurfaceBuilder(VolSurfaceConfig config, utils::TaskPool& pool);
+
+    /**
+     * @brief Destructor, stops the builder
+     */
+    ~VolSurfaceBuilder();
+
+    // Prevent copying and assignment
+    VolSurfaceBuilder(const VolSurfaceBuilder&) = delete;
+    VolSurfaceBuilder& operator=(const VolSurfaceBuilder&) = delete;
+
+    /**
+     * @brief Start accepting refreshes
+     * @return true if started, false if already running or disabled
+     */
+    bool start();
+
+    /**
+     * @brief Stop accepting refreshes and wait for the fits in flight
+     *
+     * Fits still queued on the pool are skipped.
+     */
+    void stop();
+
+    /**
+     * @brief Queue the refits of the expiries whose inputs changed
+     *
+     * Currencies still being rebuilt are skipped until the next call.
+     *
+     * @return Number of expiries queued
+     */
+    size_t refresh();
+
+    /**
+     * @brief Get the latest surface of a currency
+     * @param currency Currency, e.g. "BTC"
+     * @return Surface, or nullptr if none was built
+     */
+    std::shared_ptr<const VolSurface> getSurface(const std::string& currency) const;
+
+    /**
+     * @brief Get the number of expiry fits run
+     * @return Number of fits
+     */
+    uint64_t getFitCount() const { return m_fits; }
+
+private:
+    /**
+     * @struct ExpiryInputs
+     * @brief Structure for the quotes of one expiry
+     */
+    struct ExpiryInputs {
+        int64_t expiry = 0;
+        double years = 0;
+        double forward = 0;
+        std::vector<double> strikes;   // ascending
+        std::vector<double> vols;
+    };
+
+    /**
+     * @struct ExpiryState
+     * @brief Structure for the last fit of one expiry
+     */
+    struct ExpiryState {
+        ExpiryInputs inputs;
+        ExpirySmile smile;
+        bool fitted = false;
+    };
+
+    /**
+     * @struct Currency
+     * @brief Structure for the surface and fit state of one currency
+     *
+     * The expiry states belong to the rebuild in flight, if any, and to
+     * refresh() otherwise; building hands them over.
+     */
+    struct Currency {
+        std::string name;
+        std::atomic<std::shared_ptr<const VolSurface>> surface;
+        std::map<int64_t, ExpiryState> expiries;
+        std::atomic<bool> building{false};
+        std::atomic<size_t> pending{0};
+        int64_t builtAt = 0;
+        uint64_t version = 0;
+    };
+
+    VolSurfaceConfig m_config;
+    utils::TaskPool& m_pool;
+    std::vector<std::unique_ptr<Currency>> m_currencies;
+    std::atomic<uint64_t> m_fits{0};
+    std::atomic<bool> m_running{false};
+
+    // Fits queued on the pool; stop() waits for them to finish
+    size_t m_inFlight = 0;
+    std::mutex m_inFlightMutex;
+    std::condition_variable m_inFlightCondition;
+
+    /**
+     * @brief Queue the fit of one expiry on the pool
+     * @param currency Currency being rebuilt
+     * @param state Expiry state
+     */
+    void post(Currency& currency, ExpiryState& state);
+
+    /**
+     * @brief Count down the fits of a rebuild, publishing after the last
+     * @param currency Currency being rebuilt
+     */
+    void complete(Currency& currency);
+
+    /**
+     * @brief Fit one expiry, warm-starting from its previous fit
+     * @param state Expiry state, updated in place
+     */
+    void fit(ExpiryState& state);
+
+    /**
+     * @brief Assemble and publish the surface of a currency
+     * @param currency Currency
+     */
+    void publish(Currency& currency);
+};
+
+} // namespace analytics
+} // namespace deribit
@@ -0,0 +1,203 @@
+/**
+ * @file async_api.cpp
+ * @brief Coroutine interface to the Deribit API implementation
+ */
+
+#include "async_api.h"
+
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+namespace api {
+
+using json = nlohmann::json;
+
+namespace {
+
+double number(const json& object, const char* key) {
+    auto it = object.find(key);
+    return it != object.end() && it->is_number() ? it->get<double>() : 0.0;
+}
+
+std::string text(const json& object, const char* key) {
+    auto it = object.find(key);
+    return it != object.end() && it->is_string() ? it->get<std::string>() : std::string();
+}
+
+std::chrono::system_clock::time_point timestamp(const json& object, const char* key) {
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(static_cast<int64_t>(number(object, key))));
+}
+
+Order parseOrder(const json& object) {
+    Order order;
+    order.order_id = text(object, "order_id");
+    order.instrument_name = text(object, "instrument_name");
+    order.direction = text(object, "direction");
+    order.price = number(object, "price");
+    order.amount = number(object, "amount");
+    order.order_type = text(object, "order_type");
+    order.order_state = text(object, "order_state");
+    order.created_at = timestamp(object, "creation_timestamp");
+    order.last_updated_at = timestamp(object, "last_update_timestamp");
+    return order;
+}
+
+void parseLevels(const json& object, const char* key, std::vector<std::pair<double, double>>& levels) {
+    auto it = object.find(key);
+    if (it == object.end() || !it->is_array()) {
+        return;
+    }
+    levels.reserve(it->size());
+    for (const auto& level : *it) {
+        if (level.is_array() && level.size() >= 2) {
+            levels.emplace_back(level[0].get<double>(), level[1].get<double>());
+        }
+    }
+}
+
+/**
+ * @brief Parse a result, treating a malformed one as an API error
+ */
+json parseResult(const std::string& payload) {
+    json result = json::parse(payload, nullptr, false);
+    if (result.is_discarded()) {
+        throw std::runtime_error("Malformed API response");
+    }
+    return result;
+}
+
+} // namespace
+
+RequestAwaitable::RequestAwaitable(websocket::WSClient& client, std::string method, std::string params,
+                                   CallOptions options)
+    : m_client(client),
+      m_method(std::move(method)),
+      m_params(std::move(params)),
+      m_options(std::move(options)),
+      m_success(false) {}
+
+void RequestAwaitable::await_suspend(std::coroutine_handle<> handle) {
+    // The callback may resume the coroutine and destroy this awaitable
+    // before sendRequest() returns, so the request works on copies
+    std::string method = std::move(m_method);
+    std::string params = std::move(m_params);
+    CallOptions options = m_options;
+    m_client.sendRequest(method, params, [this, handle](bool success, const std::string& payload) {
+        m_success = success;
+        m_payload = payload;
+        utils::resumeOnEventLoop(handle);
+    }, options);
+}
+
+std::string RequestAwaitable::await_resume() {
+    if (m_success) {
+        return std::move(m_payload);
+    }
+
+    json error = json::parse(m_payload, nullptr, false);
+    std::string message = error.is_object() ? text(error, "message") : m_payload;
+    if (!error.is_object() || error.find("code") == error.end()) {
+        if (message == "timeout") {
+            throw RequestTimeoutError("Request timed out");
+        }
+        if (message == "cancelled") {
+            throw RequestCancelledError("Request cancelled");
+        }
+    }
+    throw std::runtime_error("API error: " + message);
+}
+
+AsyncDeribitAPI::AsyncDeribitAPI(std::shared_ptr<websocket::WSClient> wsClient)
+    : m_wsClient(std::move(wsClient)) {}
+
+RequestAwaitable AsyncDeribitAPI::request(std::string method, std::string params, CallOptions options) {
+    return RequestAwaitable(*m_wsClient, std::move(method), std::move(params), std::move(options));
+}
+
+utils::Task<Order> AsyncDeribitAPI::placeOrder(
+    std::string instrument_name,
+    std::string direction,
+    double amount,
+    double price,
+    std::string type,
+    CallOptions options
+) {
+    if (direction != "buy" && direction != "sell") {
+        throw std::invalid_argument("Invalid direction: " + direction);
+    }
+    std::string params = encodeOrderParams(instrument_name, amount, price, type);
+    json result = parseResult(co_await request("private/" + direction, std::move(params), std::move(options)));
+    co_return parseOrder(result.value("order", json::object()));
+}
+
+std::string AsyncDeribitAPI::encodeOrderParams(const std::string& instrument_name, double amount, double price,
+                                               const std::string& type) {
+    json params = {
+        {"instrument_name", instrument_name},
+        {"amount", amount},
+        {"type", type}
+    };
+    if (type != "market") {
+        params["price"] = price;
+    }
+    return params.dump();
+}
+
+utils::Task<bool> AsyncDeribitAPI::cancelOrder(std::string order_id, CallOptions options) {
+    json params = {{"order_id", order_id}};
+    try {
+        co_await request("private/cancel", params.dump(), std::move(options));
+    } catch (const std::exception&) {
+        co_return false;
+    }
+    co_return true;
+}
+
+utils::Task<Order> AsyncDeribitAPI::modifyOrder(std::string order_id, double amount, double price,
+                                                CallOptions options) {
+    json params = {
+        {"order_id", order_id},
+        {"amount", amount},
+        {"price", price}
+    };
+    json result = parseResult(co_await request("private/edit", params.dump(), std::move(options)));
+    co_return parseOrder(result.value("order", json::object()));
+}
+
+utils::Task<Orderbook> AsyncDeribitAPI::getOrderbook(std::string instrument_name, CallOptions options) {
+    json params = {{"instrument_name", instrument_name}};
+    json result = parseResult(co_await request("public/get_order_book", params.dump(), std::move(options)));
+
+    Orderbook book;
+    book.instrument_name = text(result, "instrument_name");
+    parseLevels(result, "bids", book.bids);
+    parseLevels(result, "asks", book.asks);
+    book.timestamp = timestamp(result, "timestamp");
+    co_return book;
+}
+
+utils::Task<std::vector<Position>> AsyncDeribitAPI::getPositions(std::string currency, CallOptions options) {
+    json params = {{"currency", currency}};
+    json result = parseResult(co_await request("private/get_positions", params.dump(), std::move(options)));
+
+    std::vector<Position> positions;
+    if (result.is_array()) {
+        positions.reserve(result.size());
+        for (const auto& entry : result) {
+            Position position;
+            position.instrument_name = text(entry, "instrument_name");
+            position.size = number(entry, "size");
+            position.entry_price = number(entry, "average_price");
+            position.mark_price = number(entry, "mark_price");
+            position.unrealized_pnl = number(entry, "floating_profit_loss");
+            position.realized_pnl = number(entry, "realized_profit_loss");
+            position.liquidation_price = number(entry, "estimated_liquidation_price");
+            positions.push_back(std::move(position));
+        }
+    }
+    co_return positions;
+}
+
+} // namespace api
+} // namespace deribit
@@ -0,0 +1,157 @@
+/**
+ * @file async_api.h
+ * @brief Coroutine interface to the Deribit API
+ *
+ * This file contains awaitable versions of the DeribitAPI calls. They
+ * send JSON-RPC requests over the WebSocket connection and resume the
+ * awaiting coroutine on the event loop when the response arrives, so one
+ * thread can keep thousands of operations in flight:
+ *
+ *     utils::Task<void> quote(AsyncDeribitAPI& api) {
+ *         Order order = co_await api.placeOrder("BTC-PERPETUAL", "buy", 10, 50000);
+ *         co_await utils::sleepFor(std::chrono::seconds(1));
+ *         co_await api.cancelOrder(order.order_id);
+ *     }
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <memory>
+#include <string>
+#include <vector>
+#include "deribit_api.h"
+#include "../utils/coroutine.h"
+
+namespace deribit {
+namespace api {
+
+/**
+ * @class RequestAwaitable
+ * @brief Class suspending a coroutine until a JSON-RPC response arrives
+ *
+ * Resuming yields the serialized result, or throws RequestTimeoutError,
+ * RequestCancelledError or std::runtime_error for an API error.
+ */
+class RequestAwaitable {
+public:
+    /**
+     * @brief Constructor
+     * @param client WebSocket client
+     * @param method JSON-RPC method name
+     * @param params Serialized JSON params object
+     * @param options Deadline and cancellation token
+     */
+    RequestAwaitable(websocket::WSClient& client, std::string method, std::string params, CallOptions options);
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    std::string await_resume();
+
+private:
+    websocket::WSClient& m_client;
+    std::string m_method;
+    std::string m_params;
+    CallOptions m_options;
+    bool m_success;
+    std::string m_payload;
+};
+
+/**
+ * @class AsyncDeribitAPI
+ * @brief Class for awaiting Deribit API calls from coroutines
+ *
+ * The calls mirror the blocking DeribitAPI ones and report failures the
+ * same way. Private methods rely on the WebSocket session authenticated
+ * by DeribitAPI::authenticate(). Coroutines resume on the TimerService
+ * thread, which must be running, and the client must outlive the tasks
+ * it returns.
+ */
+class AsyncDeribitAPI {
+public:
+    /**
+     * @brief Constructor
+     * @param wsClient WebSocket client, see DeribitAPI::getWebSocketClient()
+     */
+    explicit AsyncDeribitAPI(std::shared_ptr<websocket::WSClient> wsClient);
+
+    /**
+     * @brief Send a JSON-RPC request
+     * @param method JSON-RPC method name
+     * @param params Serialized JSON params object
+     * @param options Deadline and cancellation token (optional)
+     * @return Awaitable yielding the serialized result
+     */
+    RequestAwaitable request(std::string method, std::string params, CallOptions options = CallOptions());
+
+    /**
+     * @brief Place a new order
+     * @param instrument_name Instrument name
+     * @param direction "buy" or "sell"
+     * @param amount Amount
+     * @param price Price (ignored for market orders)
+     * @param type Order type (limit, market, etc.)
+     * @param options Deadline and cancellation token (optional)
+     * @return Task yielding the order, or throwing like DeribitAPI::placeOrder()
+     */
+    utils::Task<Order> placeOrder(
+        std::string instrument_name,
+        std::string direction,
+        double amount,
+        double price = 0,
+        std::string type = "limit",
+        CallOptions options = CallOptions()
+    );
+
+    /**
+     * @brief Cancel an existing order
+     * @param order_id Order ID
+     * @param options Deadline and cancellation token (default: kCancelOrderDeadline)
+     * @return Task yielding true if cancelled, false otherwise (including a missed deadline)
+     */
+    utils::Task<bool> cancelOrder(std::string order_id, CallOptions options = CallOptions(kCancelOrderDeadline));
+
+    /**
+     * @brief Modify an existing order
+     * @param order_id Order ID
+     * @param amount New amount
+     * @param price New price
+     * @param options Deadline and cancellation token (optional)
+     * @return Task yielding the updated order, or throwing like DeribitAPI::modifyOrder()
+     */
+    utils::Task<Order> modifyOrder(std::string order_id, double amount, double price,
+                                   CallOptions options = CallOptions());
+
+    /**
+     * @brief Get the orderbook for an instrument
+     * @param instrument_name Instrument name
+     * @param options Deadline and cancellation token (optional)
+     * @return Task yielding the orderbook
+     */
+    utils::Task<Orderbook> getOrderbook(std::string instrument_name, CallOptions options = CallOptions());
+
+    /**
+     * @brief Get current positions
+     * @param currency Currency, or "any" for all
+     * @param options Deadline and cancellation token (optional)
+     * @return Task yielding the positions
+     */
+    utils::Task<std::vector<Position>> getPositions(std::string currency = "any", CallOptions options = CallOptions());
+
+    /**
+     * @brief Build the params of a private/buy or private/sell request, as sent by placeOrder()
+     * @param instrument_name Instrument name
+     * @param amount Amount
+     * @param price Price (omitted for market orders)
+     * @param type Order type
+     * @return Serialized JSON params object
+     */
+    static std::string encodeOrderParams(const std::string& instrument_name, double amount, double price,
+                                         const std::string& type);
+
+private:
+    std::shared_ptr<websocket::WSClient> m_wsClient;
+};
+
+} // namespace api
+} // namespace deribit
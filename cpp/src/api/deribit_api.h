@@ -9,6 +9,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <functional>
@@ -16,7 +17,10 @@
 #include <chrono>
 #include <atomic>
 #include <mutex>
+#include <future>
+#include <stdexcept>
 #include "../websocket/ws_client.h"
+#include "http_client.h"
 
 namespace deribit {
 namespace api {
@@ -65,6 +69,23 @@ struct Orderbook {
     std::chrono::system_clock::time_point timestamp;
 };
 
+/**
+ * @struct Instrument
+ * @brief Structure representing instrument metadata from public/get_instruments
+ */
+struct Instrument {
+    std::string instrument_name;
+    std::string currency;
+    std::string kind;  // "future", "option", "spot", ...
+    std::string option_type;  // "call" or "put" for options
+    double strike;
+    double tick_size;
+    double contract_size;
+    double min_trade_amount;
+    bool is_active;
+    std::chrono::system_clock::time_point expiration;
+};
+
 /**
  * @struct WSMessage
  * @brief Structure representing a WebSocket message
@@ -75,6 +96,62 @@ struct WSMessage {
     std::chrono::system_clock::time_point timestamp;
 };
 
+/**
+ * @struct WSMessageView
+ * @brief Structure representing a WebSocket message without ownership
+ *
+ * channel and data point into the client's receive buffer and are only
+ * valid for the duration of the callback they are passed to.
+ */
+struct WSMessageView {
+    std::string_view channel;
+    std::string_view data;
+    std::chrono::system_clock::time_point timestamp;
+
+    /**
+     * @brief Copy into an owning message
+     * @return WSMessage object
+     */
+    WSMessage toMessage() const {
+        return WSMessage{std::string(channel), std::string(data), timestamp};
+    }
+};
+
+/**
+ * @class RequestTimeoutError
+ * @brief Exception thrown when a request misses its deadline
+ *
+ * The request may still have been executed by the exchange.
+ */
+class RequestTimeoutError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @class RequestCancelledError
+ * @brief Exception thrown when a request is cancelled through its token
+ *
+ * The request may still have been executed by the exchange.
+ */
+class RequestCancelledError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Per-call deadline and cancellation token
+ */
+using CallOptions = websocket::RequestOptions;
+
+/**
+ * @brief Default deadline of order cancellations
+ *
+ * A cancel that has not been acknowledged by then is reported as failed
+ * right away, so the caller can react instead of waiting.
+ */
+constexpr std::chrono::milliseconds kCancelOrderDeadline{50};
+
 /**
  * @class DeribitAPI
  * @brief Deribit API client implementation
@@ -96,10 +173,37 @@ public:
     
     /**
      * @brief Authenticate with the API
+     *
+     * The credentials are also registered with the WebSocket client
+     * (WSClient::setAuthParams) so that reconnects re-authenticate.
+     *
      * @return true if successful, false otherwise
      */
     bool authenticate();
     
+    /**
+     * @brief Adopt tokens renewed outside this class
+     *
+     * Used for the tokens of a WebSocket re-authentication, see
+     * WSClient::setOnReauthenticated(). REST calls send the new access
+     * token from the next request on.
+     *
+     * @param accessToken Access token
+     * @param refreshToken Refresh token
+     * @param expiresIn Lifetime of the access token
+     */
+    void setTokens(const std::string& accessToken, const std::string& refreshToken,
+                   std::chrono::seconds expiresIn) {
+        if (accessToken.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_apiMutex);
+        m_accessToken = accessToken;
+        m_refreshToken = refreshToken;
+        m_tokenExpiry = std::chrono::system_clock::now() + expiresIn;
+        m_http->setAccessToken(accessToken);
+    }
+    
     /**
      * @brief Place a new order
      * @param instrument_name Instrument name
@@ -107,34 +211,89 @@ public:
      * @param amount Amount
      * @param price Price (optional for market orders)
      * @param type Order type (limit, market, etc.)
+     * @param options Deadline and cancellation token (optional)
      * @return Order object if successful, throws exception otherwise
+     *         (RequestTimeoutError, RequestCancelledError on deadline or cancellation)
      */
     Order placeOrder(
         const std::string& instrument_name,
         const std::string& direction,
         double amount,
         double price = 0,
-        const std::string& type = "limit"
+        const std::string& type = "limit",
+        const CallOptions& options = CallOptions()
+    );
+    
+    /**
+     * @brief Place a new order without blocking
+     * @param instrument_name Instrument name
+     * @param direction "buy" or "sell"
+     * @param amount Amount
+     * @param price Price (optional for market orders)
+     * @param type Order type (limit, market, etc.)
+     * @param options Deadline and cancellation token (optional)
+     * @return Future for the order; holds the exception placeOrder() would throw
+     */
+    std::future<Order> placeOrderAsync(
+        const std::string& instrument_name,
+        const std::string& direction,
+        double amount,
+        double price = 0,
+        const std::string& type = "limit",
+        const CallOptions& options = CallOptions()
     );
     
     /**
      * @brief Cancel an existing order
      * @param order_id Order ID
-     * @return true if successful, false otherwise
+     * @param options Deadline and cancellation token (default: kCancelOrderDeadline)
+     * @return true if successful, false otherwise (including a missed deadline)
      */
-    bool cancelOrder(const std::string& order_id);
+    bool cancelOrder(
+        const std::string& order_id,
+        const CallOptions& options = CallOptions(kCancelOrderDeadline)
+    );
+    
+    /**
+     * @brief Cancel an existing order without blocking
+     * @param order_id Order ID
+     * @param options Deadline and cancellation token (default: kCancelOrderDeadline)
+     * @return Future for the result of cancelOrder()
+     */
+    std::future<bool> cancelOrderAsync(
+        const std::string& order_id,
+        const CallOptions& options = CallOptions(kCancelOrderDeadline)
+    );
     
     /**
      * @brief Modify an existing order
      * @param order_id Order ID
      * @param amount New amount (optional)
      * @param price New price (optional)
+     * @param options Deadline and cancellation token (optional)
      * @return Updated order if successful, throws exception otherwise
+     *         (RequestTimeoutError, RequestCancelledError on deadline or cancellation)
      */
     Order modifyOrder(
         const std::string& order_id,
         double amount = 0,
-        double price = 0
+        double price = 0,
+        const CallOptions& options = CallOptions()
+    );
+    
+    /**
+     * @brief Modify an existing order without blocking
+     * @param order_id Order ID
+     * @param amount New amount (optional)
+     * @param price New price (optional)
+     * @param options Deadline and cancellation token (optional)
+     * @return Future for the updated order; holds the exception modifyOrder() would throw
+     */
+    std::future<Order> modifyOrderAsync(
+        const std::string& order_id,
+        double amount = 0,
+        double price = 0,
+        const CallOptions& options = CallOptions()
     );
     
     /**
@@ -150,6 +309,25 @@ public:
      */
     std::vector<Position> getPositions();
     
+    /**
+     * @brief Get the open orders of the account (private/get_open_orders)
+     * @return Vector of open and untriggered orders
+     */
+    std::vector<Order> getOpenOrders();
+    
+    /**
+     * @brief Get instrument metadata (public/get_instruments)
+     * @param currency Currency ("BTC", "ETH", ...)
+     * @param kind Instrument kind filter (empty for all kinds)
+     * @param expired Whether to list expired instruments instead of active ones
+     * @return Vector of instruments
+     */
+    std::vector<Instrument> getInstruments(
+        const std::string& currency,
+        const std::string& kind = "",
+        bool expired = false
+    );
+    
     /**
      * @brief Process any pending events
      */
@@ -171,34 +349,40 @@ private:
     std::string m_refreshToken;
     std::chrono::system_clock::time_point m_tokenExpiry;
     std::shared_ptr<websocket::WSClient> m_wsClient;
+    std::unique_ptr<HttpConnectionPool> m_http;  // keep-alive REST connections, warmed up in the constructor
+    RequestParams m_params;                      // reused by REST calls, guarded by m_apiMutex
     std::mutex m_apiMutex;
     
     /**
      * @brief Refresh the access token if necessary
+     *
+     * A new token is handed to HttpConnectionPool::setAccessToken, which
+     * swaps the Authorization header without blocking requests in flight.
+     *
      * @return true if successful, false otherwise
      */
     bool refreshTokenIfNeeded();
     
     /**
-     * @brief Send a GET request to the API
+     * @brief Send a GET request to the API over a pooled connection
      * @param endpoint API endpoint
      * @param params Query parameters
      * @return Response as a string
      */
     std::string sendGetRequest(
         const std::string& endpoint,
-        const std::map<std::string, std::string>& params = {}
+        const RequestParams& params = RequestParams()
     );
     
     /**
-     * @brief Send a POST request to the API
+     * @brief Send a POST request to the API over a pooled connection
      * @param endpoint API endpoint
      * @param params Request body
      * @return Response as a string
      */
     std::string sendPostRequest(
         const std::string& endpoint,
-        const std::map<std::string, std::string>& params = {}
+        const RequestParams& params = RequestParams()
     );
 };
 
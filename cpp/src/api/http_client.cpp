@@ -0,0 +1,390 @@
+/**
+ * @file http_client.cpp
+ * @brief Keep-alive HTTPS client implementation
+ */
+
+#include "http_client.h"
+#include "../websocket/tls_context.h"
+#include "../utils/logger.h"
+
+#include <charconv>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+
+namespace deribit {
+namespace api {
+
+namespace beast = boost::beast;
+namespace http = boost::beast::http;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = boost::asio::ip::tcp;
+
+namespace {
+
+const std::chrono::milliseconds kDefaultRequestTimeout{10000};
+const std::chrono::milliseconds kDefaultIdleTimeout{15000};
+
+/**
+ * @brief Run the operations started on a connection's context to completion
+ *
+ * Beast enforces the stream expiry only on asynchronous operations, so
+ * every step is started asynchronously and driven here; an operation
+ * outliving the expiry fails with beast::error::timeout.
+ */
+void runPending(net::io_context& ioContext) {
+    ioContext.restart();
+    ioContext.run();
+}
+
+void appendUrlEncoded(std::string& out, std::string_view value) {
+    static const char kHex[] = "0123456789ABCDEF";
+    for (char c : value) {
+        auto byte = static_cast<unsigned char>(c);
+        if ((byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z') ||
+            (byte >= '0' && byte <= '9') || byte == '-' || byte == '_' || byte == '.' || byte == '~') {
+            out.push_back(c);
+        } else {
+            out.push_back('%');
+            out.push_back(kHex[byte >> 4]);
+            out.push_back(kHex[byte & 0x0F]);
+        }
+    }
+}
+
+void appendJsonString(std::string& out, std::string_view value) {
+    static const char kHex[] = "0123456789abcdef";
+    out.push_back('"');
+    for (char c : value) {
+        auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (byte < 0x20) {
+            out.append("\\u00");
+            out.push_back(kHex[byte >> 4]);
+            out.push_back(kHex[byte & 0x0F]);
+        } else {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+} // namespace
+
+RequestParams::Entry& RequestParams::next(std::string_view key, bool quoted) {
+    if (m_size == m_entries.size()) {
+        m_entries.emplace_back();
+    }
+    Entry& entry = m_entries[m_size++];
+    entry.key.assign(key.data(), key.size());
+    entry.quoted = quoted;
+    return entry;
+}
+
+RequestParams& RequestParams::add(std::string_view key, std::string_view value) {
+    next(key, true).value.assign(value.data(), value.size());
+    return *this;
+}
+
+RequestParams& RequestParams::add(std::string_view key, double value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    next(key, false).value.assign(buffer, result.ptr);
+    return *this;
+}
+
+RequestParams& RequestParams::add(std::string_view key, int64_t value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    next(key, false).value.assign(buffer, result.ptr);
+    return *this;
+}
+
+RequestParams& RequestParams::add(std::string_view key, uint64_t value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    next(key, false).value.assign(buffer, result.ptr);
+    return *this;
+}
+
+RequestParams& RequestParams::add(std::string_view key, bool value) {
+    next(key, false).value.assign(value ? "true" : "false");
+    return *this;
+}
+
+void RequestParams::appendQuery(std::string& out) const {
+    for (size_t i = 0; i < m_size; ++i) {
+        if (i > 0) {
+            out.push_back('&');
+        }
+        appendUrlEncoded(out, m_entries[i].key);
+        out.push_back('=');
+        appendUrlEncoded(out, m_entries[i].value);
+    }
+}
+
+void RequestParams::appendJson(std::string& out) const {
+    out.push_back('{');
+    for (size_t i = 0; i < m_size; ++i) {
+        if (i > 0) {
+            out.push_back(',');
+        }
+        appendJsonString(out, m_entries[i].key);
+        out.push_back(':');
+        if (m_entries[i].quoted) {
+            appendJsonString(out, m_entries[i].value);
+        } else {
+            out.append(m_entries[i].value);
+        }
+    }
+    out.push_back('}');
+}
+
+/**
+ * @struct HttpConnectionPool::Connection
+ * @brief Socket state for a single persistent connection
+ */
+struct HttpConnectionPool::Connection {
+    net::io_context ioContext;
+    beast::ssl_stream<beast::tcp_stream> stream;
+    beast::flat_buffer buffer;
+    std::chrono::steady_clock::time_point lastUsed;
+
+    explicit Connection(ssl::context& context) : stream(ioContext, context) {}
+};
+
+HttpConnectionPool::HttpConnectionPool(
+    const std::string& host,
+    const std::string& port,
+    size_t maxIdle,
+    websocket::TlsContext* tls
+) : m_host(host),
+    m_port(port),
+    m_maxIdle(maxIdle),
+    m_tls(tls ? *tls : websocket::TlsContext::getInstance()),
+    m_idleTimeout(kDefaultIdleTimeout),
+    m_requestTimeout(kDefaultRequestTimeout) {
+    m_headers = "Host: " + m_host + "\r\n"
+                "User-Agent: deribit-trading-system/1.0\r\n"
+                "Accept: application/json\r\n"
+                "Connection: keep-alive\r\n";
+}
+
+HttpConnectionPool::~HttpConnectionPool() = default;
+
+size_t HttpConnectionPool::warmup(size_t count) {
+    count = std::min(count, m_maxIdle);
+    while (getIdleCount() < count) {
+        auto connection = open();
+        if (!connection) {
+            break;
+        }
+        release(std::move(connection));
+    }
+    return getIdleCount();
+}
+
+bool HttpConnectionPool::get(std::string_view target, const RequestParams& params, HttpResponse& response) {
+    thread_local std::string fullTarget;
+    thread_local std::string request;
+
+    fullTarget.assign(target.data(), target.size());
+    if (!params.empty()) {
+        fullTarget.push_back('?');
+        params.appendQuery(fullTarget);
+    }
+    request.clear();
+    buildRequest("GET", fullTarget, {}, request);
+
+    return execute(request, &response, 1, true);
+}
+
+bool HttpConnectionPool::post(std::string_view target, const RequestParams& params, HttpResponse& response) {
+    thread_local std::string body;
+    thread_local std::string request;
+
+    body.clear();
+    params.appendJson(body);
+    request.clear();
+    buildRequest("POST", target, body, request);
+
+    // Requests with side effects are never resent
+    return execute(request, &response, 1, false);
+}
+
+bool HttpConnectionPool::pipelineGet(const std::vector<std::string>& targets, std::vector<HttpResponse>& responses) {
+    responses.assign(targets.size(), HttpResponse());
+    if (targets.empty()) {
+        return true;
+    }
+
+    std::string requests;
+    for (const auto& target : targets) {
+        buildRequest("GET", target, {}, requests);
+    }
+    return execute(requests, responses.data(), responses.size(), true);
+}
+
+void HttpConnectionPool::setAccessToken(const std::string& token) {
+    std::shared_ptr<const std::string> header;
+    if (!token.empty()) {
+        header = std::make_shared<const std::string>("Authorization: Bearer " + token + "\r\n");
+    }
+    m_authHeader.store(std::move(header), std::memory_order_release);
+}
+
+size_t HttpConnectionPool::getIdleCount() {
+    std::lock_guard<std::mutex> lock(m_idleMutex);
+    return m_idle.size();
+}
+
+std::unique_ptr<HttpConnectionPool::Connection> HttpConnectionPool::acquire(bool& reused) {
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        while (!m_idle.empty()) {
+            auto connection = std::move(m_idle.back());
+            m_idle.pop_back();
+            if (now - connection->lastUsed < m_idleTimeout) {
+                reused = true;
+                return connection;
+            }
+        }
+    }
+    reused = false;
+    return open();
+}
+
+void HttpConnectionPool::release(std::unique_ptr<Connection> connection) {
+    connection->lastUsed = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(m_idleMutex);
+    if (m_idle.size() < m_maxIdle) {
+        m_idle.push_back(std::move(connection));
+    }
+}
+
+std::unique_ptr<HttpConnectionPool::Connection> HttpConnectionPool::open() {
+    auto connection = std::make_unique<Connection>(m_tls.get());
+    auto& tls = m_tls;
+    auto& stream = connection->stream;
+    beast::error_code ec;
+
+    tcp::resolver resolver(connection->ioContext);
+    auto endpoints = resolver.resolve(m_host, m_port, ec);
+    if (!ec) {
+        beast::get_lowest_layer(stream).expires_after(m_requestTimeout);
+        beast::get_lowest_layer(stream).async_connect(endpoints,
+            [&ec](beast::error_code result, const tcp::endpoint&) { ec = result; });
+        runPending(connection->ioContext);
+    }
+    if (ec) {
+        LOG_ERROR("HTTPS connection to {} failed: {}", m_host, ec.message());
+        return nullptr;
+    }
+    beast::get_lowest_layer(stream).socket().set_option(tcp::no_delay(true), ec);
+
+    if (!tls.prepare(stream.native_handle(), m_host)) {
+        LOG_ERROR("Failed to set SNI host name for {}", m_host);
+        return nullptr;
+    }
+    stream.async_handshake(ssl::stream_base::client, [&ec](beast::error_code result) { ec = result; });
+    runPending(connection->ioContext);
+    if (ec) {
+        LOG_ERROR("TLS handshake with {} failed: {}", m_host, ec.message());
+        return nullptr;
+    }
+    tls.onHandshake(stream.native_handle());
+    return connection;
+}
+
+void HttpConnectionPool::buildRequest(
+    std::string_view method,
+    std::string_view target,
+    std::string_view body,
+    std::string& out
+) const {
+    out.append(method.data(), method.size());
+    out.push_back(' ');
+    out.append(target.data(), target.size());
+    out.append(" HTTP/1.1\r\n");
+    out.append(m_headers);
+
+    auto auth = m_authHeader.load(std::memory_order_acquire);
+    if (auth) {
+        out.append(*auth);
+    }
+
+    if (!body.empty()) {
+        char length[24];
+        auto result = std::to_chars(length, length + sizeof(length), body.size());
+        out.append("Content-Type: application/json\r\nContent-Length: ");
+        out.append(length, result.ptr);
+        out.append("\r\n");
+    }
+    out.append("\r\n");
+    out.append(body.data(), body.size());
+}
+
+bool HttpConnectionPool::execute(const std::string& requests, HttpResponse* responses, size_t count, bool retry) {
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool reused = false;
+        auto connection = attempt == 0 ? acquire(reused) : open();
+        if (!connection) {
+            return false;
+        }
+
+        auto& stream = connection->stream;
+        beast::error_code ec;
+        beast::get_lowest_layer(stream).expires_after(m_requestTimeout);
+        net::async_write(stream, net::buffer(requests),
+            [&ec](beast::error_code result, size_t) { ec = result; });
+        runPending(connection->ioContext);
+
+        bool keepAlive = true;
+        size_t received = 0;
+        while (!ec && received < count) {
+            // Read into the caller's body so its capacity is reused
+            http::response<http::string_body> response;
+            response.body() = std::move(responses[received].body);
+            response.body().clear();
+            http::async_read(stream, connection->buffer, response,
+                [&ec](beast::error_code result, size_t) { ec = result; });
+            runPending(connection->ioContext);
+            if (ec) {
+                responses[received].body = std::move(response.body());
+                break;
+            }
+            responses[received].status = response.result_int();
+            responses[received].body = std::move(response.body());
+            keepAlive = keepAlive && response.keep_alive();
+            ++received;
+        }
+
+        if (!ec) {
+            if (keepAlive) {
+                release(std::move(connection));
+            }
+            return true;
+        }
+
+        // An idle connection may have been closed by the server in the meantime
+        if (retry && reused && received == 0) {
+            LOG_DEBUG("Pooled connection to {} was closed ({}), retrying on a new one", m_host, ec.message());
+            continue;
+        }
+        LOG_WARN("HTTPS request to {} failed: {}", m_host, ec.message());
+        return false;
+    }
+    return false;
+}
+
+} // namespace api
+} // namespace deribit
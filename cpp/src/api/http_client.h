@@ -0,0 +1,331 @@
+/**
+ * @file http_client.h
+ * @brief Keep-alive HTTPS client for the Deribit REST API
+ *
+ * This file contains a reusable request parameter builder and a small pool
+ * of persistent TLS connections, so REST calls do not pay for a TCP and
+ * TLS handshake each time.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace deribit {
+
+namespace websocket {
+class TlsContext;
+} // namespace websocket
+
+namespace api {
+
+/**
+ * @class RequestParams
+ * @brief Class for building request parameters without per-call allocations
+ *
+ * Parameters are kept in a flat vector in insertion order. clear() keeps
+ * the storage of all entries, so a builder reused for similar requests
+ * stops allocating after the first few calls.
+ */
+class RequestParams {
+public:
+    /**
+     * @brief Remove all parameters, keeping their storage
+     * @return Reference to this builder
+     */
+    RequestParams& clear() {
+        m_size = 0;
+        return *this;
+    }
+
+    /**
+     * @brief Add a string parameter
+     * @param key Parameter name
+     * @param value Parameter value
+     * @return Reference to this builder
+     */
+    RequestParams& add(std::string_view key, std::string_view value);
+
+    /**
+     * @brief Add a string parameter
+     * @param key Parameter name
+     * @param value Parameter value
+     * @return Reference to this builder
+     */
+    RequestParams& add(std::string_view key, const char* value) {
+        return add(key, std::string_view(value));
+    }
+
+    /**
+     * @brief Add a numeric parameter
+     * @param key Parameter name
+     * @param value Parameter value, formatted in shortest round-trip form
+     * @return Reference to this builder
+     */
+    RequestParams& add(std::string_view key, double value);
+
+    /**
+     * @brief Add an integer parameter
+     * @param key Parameter name
+     * @param value Parameter value
+     * @return Reference to this builder
+     */
+    RequestParams& add(std::string_view key, int64_t value);
+
+    /**
+     * @brief Add an integer parameter, e.g. add("depth", 10)
+     * @param key Parameter name
+     * @param value Parameter value
+     * @return Reference to this builder
+     */
+    RequestParams& add(std::string_view key, int value) {
+        return add(key, static_cast<int64_t>(value));
+    }
+
+    /**
+     * @brief Add an unsigned integer parameter
+     * @param key Parameter name
+     * @param value Parameter value
+     * @return Reference to this builder
+     */
+    RequestParams& add(std::string_view key, uint64_t value);
+
+    /**
+     * @brief Add a boolean parameter
+     * @param key Parameter name
+     * @param value Parameter value
+     * @return Reference to this builder
+     */
+    RequestParams& add(std::string_view key, bool value);
+
+    /**
+     * @brief Get the number of parameters
+     * @return Number of parameters
+     */
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief Check whether there are no parameters
+     * @return true if empty, false otherwise
+     */
+    bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief Append the parameters as a URL-encoded query string
+     * @param out Output string, e.g. "currency=BTC&kind=future"
+     */
+    void appendQuery(std::string& out) const;
+
+    /**
+     * @brief Append the parameters as a JSON object
+     * @param out Output string, e.g. {"currency":"BTC","expired":false}
+     */
+    void appendJson(std::string& out) const;
+
+private:
+    /**
+     * @struct Entry
+     * @brief Structure for a single parameter
+     */
+    struct Entry {
+        std::string key;
+        std::string value;
+        bool quoted;  // string value, as opposed to a number or boolean
+    };
+
+    std::vector<Entry> m_entries;
+    size_t m_size = 0;
+
+    /**
+     * @brief Get the next entry, reusing its storage if possible
+     */
+    Entry& next(std::string_view key, bool quoted);
+};
+
+/**
+ * @struct HttpResponse
+ * @brief Structure representing an HTTP response
+ */
+struct HttpResponse {
+    unsigned int status = 0;
+    std::string body;
+
+    /**
+     * @brief Check whether the status is 2xx
+     * @return true if successful, false otherwise
+     */
+    bool ok() const { return status >= 200 && status < 300; }
+};
+
+/**
+ * @class HttpConnectionPool
+ * @brief Class for a pool of persistent HTTPS connections to one host
+ *
+ * Connections use HTTP/1.1 keep-alive and the shared TLS context, so a
+ * connection opened after a drop usually resumes its TLS session. Header
+ * lines common to every request are built once; the authorization header
+ * is swapped atomically when the access token is refreshed and never
+ * blocks requests in flight.
+ *
+ * All methods are thread-safe. Each request holds one connection for its
+ * duration; requests beyond the pool size open extra connections, which
+ * are closed instead of returned if the pool is full.
+ */
+class HttpConnectionPool {
+public:
+    /**
+     * @brief Constructor
+     * @param host Server host name
+     * @param port Server port
+     * @param maxIdle Maximum number of idle connections kept open
+     * @param tls TLS context, the shared one if null
+     */
+    HttpConnectionPool(
+        const std::string& host,
+        const std::string& port = "443",
+        size_t maxIdle = 4,
+        websocket::TlsContext* tls = nullptr
+    );
+
+    /**
+     * @brief Destructor
+     */
+    ~HttpConnectionPool();
+
+    /**
+     * @brief Open connections ahead of the first requests
+     * @param count Number of connections to open
+     * @return Number of idle connections after warming up
+     */
+    size_t warmup(size_t count);
+
+    /**
+     * @brief Send a GET request with URL-encoded parameters
+     * @param target Request target, e.g. "/api/v2/public/get_instruments"
+     * @param params Query parameters
+     * @param response Output response
+     * @return true if a response was received, false on connection errors
+     */
+    bool get(std::string_view target, const RequestParams& params, HttpResponse& response);
+
+    /**
+     * @brief Send a POST request with a JSON body
+     * @param target Request target
+     * @param params Body parameters
+     * @param response Output response
+     * @return true if a response was received, false on connection errors
+     */
+    bool post(std::string_view target, const RequestParams& params, HttpResponse& response);
+
+    /**
+     * @brief Send several GET requests pipelined on one connection
+     *
+     * All requests are written before the responses are read, saving a
+     * round trip per request. Only GET requests are pipelined since they
+     * are idempotent and can be retried if the connection drops.
+     *
+     * @param targets Request targets including their query strings
+     * @param responses Output responses, in request order
+     * @return true if all responses were received, false otherwise
+     */
+    bool pipelineGet(const std::vector<std::string>& targets, std::vector<HttpResponse>& responses);
+
+    /**
+     * @brief Set the access token sent in the Authorization header
+     * @param token Access token, empty to send no Authorization header
+     */
+    void setAccessToken(const std::string& token);
+
+    /**
+     * @brief Set how long an idle connection may be reused
+     * @param timeout Idle timeout, should be below the server's keep-alive timeout
+     */
+    void setIdleTimeout(std::chrono::milliseconds timeout) { m_idleTimeout = timeout; }
+
+    /**
+     * @brief Set how long connecting, writing or reading a request may take
+     * @param timeout Request timeout
+     */
+    void setRequestTimeout(std::chrono::milliseconds timeout) { m_requestTimeout = timeout; }
+
+    /**
+     * @brief Get the number of idle connections
+     * @return Number of idle connections
+     */
+    size_t getIdleCount();
+
+    /**
+     * @brief Get the host
+     * @return Host name
+     */
+    const std::string& getHost() const { return m_host; }
+
+private:
+    struct Connection;
+
+    // Prevent copying and assignment
+    HttpConnectionPool(const HttpConnectionPool&) = delete;
+    HttpConnectionPool& operator=(const HttpConnectionPool&) = delete;
+
+    std::string m_host;
+    std::string m_port;
+    size_t m_maxIdle;
+    websocket::TlsContext& m_tls;
+    std::chrono::milliseconds m_idleTimeout;
+    std::chrono::milliseconds m_requestTimeout;
+    std::string m_headers;  // common header lines, built once
+    std::atomic<std::shared_ptr<const std::string>> m_authHeader;
+    std::vector<std::unique_ptr<Connection>> m_idle;
+    std::mutex m_idleMutex;
+
+    /**
+     * @brief Take an idle connection or open a new one
+     * @param reused Output whether the connection was taken from the pool
+     * @return Connection, or nullptr if connecting failed
+     */
+    std::unique_ptr<Connection> acquire(bool& reused);
+
+    /**
+     * @brief Return a connection to the pool, or close it if the pool is full
+     */
+    void release(std::unique_ptr<Connection> connection);
+
+    /**
+     * @brief Open a new connection
+     * @return Connection, or nullptr if connecting failed
+     */
+    std::unique_ptr<Connection> open();
+
+    /**
+     * @brief Serialize a request
+     * @param method HTTP method
+     * @param target Request target including any query string
+     * @param body Request body, empty for none
+     * @param out Output request
+     */
+    void buildRequest(std::string_view method, std::string_view target, std::string_view body, std::string& out) const;
+
+    /**
+     * @brief Send serialized requests and read one response per request
+     *
+     * Connecting, writing and reading each give up after the request
+     * timeout, so a stalled server fails the call instead of blocking it.
+     *
+     * @param requests Serialized requests, concatenated
+     * @param responses Output responses, one per request
+     * @param count Number of requests
+     * @param retry Whether the request may be resent on a fresh connection
+     * @return true if all responses were received, false otherwise
+     */
+    bool execute(const std::string& requests, HttpResponse* responses, size_t count, bool retry);
+};
+
+} // namespace api
+} // namespace deribit
@@ -0,0 +1,468 @@
+/**
+ * @file subscription_manager.cpp
+ * @brief Market data subscription management implementation
+ */
+
+#include "subscription_manager.h"
+#include "../utils/config.h"
+#include "../utils/logger.h"
+
+#include <set>
+
+namespace deribit {
+namespace api {
+
+namespace {
+
+const std::string kInstrumentPlaceholder = "{instrument}";
+
+} // namespace
+
+SubscriptionConfig SubscriptionConfig::fromConfig(const utils::Config& config) {
+    SubscriptionConfig result;
+    result.instruments = config.getStringList("subscriptions.instruments");
+    result.currencies = config.getStringList("subscriptions.currencies");
+    result.kinds = config.getStringList("subscriptions.kinds");
+
+    auto channels = config.getStringList("subscriptions.channels");
+    if (!channels.empty()) {
+        result.channels = channels;
+    }
+
+    result.maxChannelsPerRequest = config.getUInt(
+        "subscriptions.max_channels_per_request",
+        static_cast<unsigned int>(result.maxChannelsPerRequest)
+    );
+    result.refreshInterval = std::chrono::milliseconds(config.getUInt(
+        "subscriptions.refresh_interval_ms",
+        static_cast<unsigned int>(result.refreshInterval.count())
+    ));
+
+    if (result.instruments.empty() && result.currencies.empty()) {
+        result.instruments = {"BTC-PERPETUAL", "ETH-PERPETUAL"};
+    }
+    return result;
+}
+
+SubscriptionManager::SubscriptionManager(
+    std::shared_ptr<DeribitAPI> api,
+    std::shared_ptr<websocket::WSClient> wsClient,
+    SubscriptionConfig config
+) : m_api(std::move(api)),
+    m_config(std::move(config)),
+    m_started(false),
+    m_feedsFrozen(false) {
+    addFeed(std::move(wsClient));
+}
+
+SubscriptionManager::~SubscriptionManager() {
+    stop();
+    for (const auto& feed : m_feeds) {
+        feed->setOnDisconnected(nullptr);
+    }
+}
+
+bool SubscriptionManager::addFeed(std::shared_ptr<websocket::WSClient> feed) {
+    if (m_feedsFrozen.load(std::memory_order_acquire)) {
+        LOG_WARN("Ignoring market data connection added after start");
+        return false;
+    }
+    feed->setMaxChannelsPerRequest(m_config.maxChannelsPerRequest);
+    feed->setOnDisconnected([this]() {
+        handleFeedDisconnected();
+    });
+    m_feeds.push_back(std::move(feed));
+    return true;
+}
+
+websocket::FeedStats SubscriptionManager::getFeedStats(size_t feed) const {
+    return m_arbiter ? m_arbiter->getStats(feed) : websocket::FeedStats();
+}
+
+void SubscriptionManager::handleFeedDisconnected() {
+    // Until start() the list may still grow, and nothing derives from the feeds yet
+    if (!m_feedsFrozen.load(std::memory_order_acquire)) {
+        return;
+    }
+    for (const auto& feed : m_feeds) {
+        if (feed->isConnected()) {
+            LOG_WARN("Market data feed connection lost, continuing on redundant connection");
+            return;
+        }
+    }
+    if (m_onAllFeedsDisconnected) {
+        m_onAllFeedsDisconnected();
+    }
+}
+
+size_t SubscriptionManager::start() {
+    return start(loadInstruments());
+}
+
+std::vector<Instrument> SubscriptionManager::loadInstruments() {
+    SubscriptionConfig config;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        config = m_config;
+    }
+    auto universe = loadUniverse(config);
+
+    std::vector<Instrument> instruments;
+    instruments.reserve(universe.size());
+    for (auto& entry : universe) {
+        instruments.push_back(std::move(entry.second));
+    }
+    return instruments;
+}
+
+size_t SubscriptionManager::start(const std::vector<Instrument>& instruments) {
+    // The feed list is fixed from here on, so the I/O threads read it unlocked
+    m_feedsFrozen.store(true, std::memory_order_release);
+    if (m_feeds.size() > 1) {
+        m_arbiter = std::make_unique<websocket::FeedArbiter>(m_feeds.size());
+        LOG_INFO("Arbitrating market data across {} connections", m_feeds.size());
+    }
+
+    std::vector<std::string> names;
+    size_t active;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_started = true;
+        names = trackInstruments(instruments);
+        m_nextReload = std::chrono::steady_clock::now() + m_config.refreshInterval;
+        active = m_active.size();
+    }
+    subscribeInstruments(names);
+    return active;
+}
+
+void SubscriptionManager::refresh() {
+    // Decide what to do under the lock, but download the universe without
+    // it, so readers of the subscribed instruments are never held up by REST
+    bool reload = false;
+    SubscriptionConfig config;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_started) {
+            return;
+        }
+        if (std::chrono::steady_clock::now() >= m_nextReload) {
+            m_nextReload = std::chrono::steady_clock::now() + m_config.refreshInterval;
+            reload = true;
+            config = m_config;
+        }
+    }
+
+    std::map<std::string, Instrument> universe;
+    if (reload) {
+        try {
+            universe = loadUniverse(config);
+        } catch (const std::exception& e) {
+            LOG_WARN("Failed to reload instrument universe: {}", e.what());
+            reload = false;
+        }
+    }
+
+    std::vector<std::string> removed;
+    std::vector<std::string> added;
+    size_t active;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_started) {
+            return;
+        }
+
+        std::set<std::string> expired;
+        auto now = std::chrono::system_clock::now();
+        while (!m_expiries.empty() && m_expiries.begin()->first <= now) {
+            expired.insert(m_expiries.begin()->second);
+            m_expiries.erase(m_expiries.begin());
+        }
+
+        std::vector<Instrument> listed;
+        if (reload) {
+            for (const auto& entry : m_active) {
+                if (universe.find(entry.first) == universe.end()) {
+                    expired.insert(entry.first);
+                }
+            }
+            for (auto& entry : universe) {
+                if (m_active.find(entry.first) == m_active.end()) {
+                    listed.push_back(std::move(entry.second));
+                }
+            }
+        }
+
+        removed = untrackInstruments(std::vector<std::string>(expired.begin(), expired.end()));
+        added = trackInstruments(listed);
+        active = m_active.size();
+    }
+
+    if (removed.empty() && added.empty()) {
+        return;
+    }
+
+    // Requests and the callback run unlocked, the callback may call back in
+    unsubscribeInstruments(removed);
+    subscribeInstruments(added);
+
+    LOG_INFO("Instrument universe updated: {} added, {} removed, {} active",
+             added.size(), removed.size(), active);
+
+    if (m_onUniverseChanged) {
+        m_onUniverseChanged(added, removed);
+    }
+}
+
+void SubscriptionManager::setConfig(const SubscriptionConfig& config) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (config.channels != m_config.channels || config.maxChannelsPerRequest != m_config.maxChannelsPerRequest) {
+        LOG_WARN("Subscription channel and batching changes take effect after a restart");
+    }
+    m_config.instruments = config.instruments;
+    m_config.currencies = config.currencies;
+    m_config.kinds = config.kinds;
+    m_config.refreshInterval = config.refreshInterval;
+    m_nextReload = std::chrono::steady_clock::now();
+}
+
+void SubscriptionManager::requestReload() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_nextReload = std::chrono::steady_clock::now();
+}
+
+void SubscriptionManager::stop() {
+    std::vector<std::string> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_started) {
+            return;
+        }
+        m_started = false;
+
+        std::vector<std::string> instruments;
+        instruments.reserve(m_active.size());
+        for (const auto& entry : m_active) {
+            instruments.push_back(entry.first);
+        }
+        removed = untrackInstruments(instruments);
+    }
+    unsubscribeInstruments(removed);
+}
+
+bool SubscriptionManager::resubscribe(const std::string& instrumentName) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_active.find(instrumentName) == m_active.end()) {
+            return false;
+        }
+    }
+
+    LOG_INFO("Resubscribing {} for a fresh snapshot", instrumentName);
+    auto channels = channelsFor({instrumentName});
+    for (const auto& feed : m_feeds) {
+        feed->resubscribe(channels);
+    }
+    return true;
+}
+
+std::vector<std::string> SubscriptionManager::getInstruments() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> instruments;
+    instruments.reserve(m_active.size());
+    for (const auto& entry : m_active) {
+        instruments.push_back(entry.first);
+    }
+    return instruments;
+}
+
+std::vector<Instrument> SubscriptionManager::getInstrumentMetadata() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Instrument> instruments;
+    instruments.reserve(m_active.size());
+    for (const auto& entry : m_active) {
+        instruments.push_back(entry.second);
+    }
+    return instruments;
+}
+
+bool SubscriptionManager::getInstrument(const std::string& instrumentName, Instrument& instrument) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_active.find(instrumentName);
+    if (it == m_active.end()) {
+        return false;
+    }
+    instrument = it->second;
+    return true;
+}
+
+size_t SubscriptionManager::getInstrumentCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_active.size();
+}
+
+std::map<std::string, Instrument> SubscriptionManager::loadUniverse(const SubscriptionConfig& config) {
+    std::map<std::string, Instrument> universe;
+    auto now = std::chrono::system_clock::now();
+
+    auto accept = [&universe, now](Instrument&& instrument) {
+        if (instrument.is_active && instrument.expiration > now) {
+            std::string name = instrument.instrument_name;
+            universe.emplace(std::move(name), std::move(instrument));
+        }
+    };
+
+    for (const auto& currency : config.currencies) {
+        if (config.kinds.empty()) {
+            for (auto& instrument : m_api->getInstruments(currency)) {
+                accept(std::move(instrument));
+            }
+            continue;
+        }
+        for (const auto& kind : config.kinds) {
+            for (auto& instrument : m_api->getInstruments(currency, kind)) {
+                accept(std::move(instrument));
+            }
+        }
+    }
+
+    if (!config.instruments.empty()) {
+        std::set<std::string> wanted(config.instruments.begin(), config.instruments.end());
+        for (auto& instrument : m_api->getInstruments("any")) {
+            if (wanted.erase(instrument.instrument_name) > 0) {
+                accept(std::move(instrument));
+            }
+        }
+        for (const auto& name : wanted) {
+            LOG_WARN("Configured instrument {} is not listed or has expired, skipping", name);
+        }
+    }
+
+    return universe;
+}
+
+std::vector<std::string> SubscriptionManager::channelsFor(const std::vector<std::string>& instruments) const {
+    std::vector<std::string> channels;
+    channels.reserve(instruments.size() * m_config.channels.size());
+    for (const auto& instrument : instruments) {
+        for (const auto& channelTemplate : m_config.channels) {
+            std::string channel = channelTemplate;
+            auto pos = channel.find(kInstrumentPlaceholder);
+            if (pos != std::string::npos) {
+                channel.replace(pos, kInstrumentPlaceholder.size(), instrument);
+            }
+            channels.push_back(std::move(channel));
+        }
+    }
+    return channels;
+}
+
+std::vector<std::string> SubscriptionManager::trackInstruments(const std::vector<Instrument>& instruments) {
+    std::vector<std::string> names;
+    names.reserve(instruments.size());
+    for (const auto& instrument : instruments) {
+        if (m_active.emplace(instrument.instrument_name, instrument).second) {
+            m_expiries.emplace(instrument.expiration, instrument.instrument_name);
+            names.push_back(instrument.instrument_name);
+        }
+    }
+    return names;
+}
+
+std::vector<std::string> SubscriptionManager::untrackInstruments(const std::vector<std::string>& instruments) {
+    std::vector<std::string> names;
+    names.reserve(instruments.size());
+    for (const auto& name : instruments) {
+        auto it = m_active.find(name);
+        if (it == m_active.end()) {
+            continue;
+        }
+        auto range = m_expiries.equal_range(it->second.expiration);
+        for (auto expiry = range.first; expiry != range.second; ++expiry) {
+            if (expiry->second == name) {
+                m_expiries.erase(expiry);
+                break;
+            }
+        }
+        m_active.erase(it);
+        names.push_back(name);
+    }
+    return names;
+}
+
+void SubscriptionManager::subscribeInstruments(const std::vector<std::string>& names) {
+    if (names.empty()) {
+        return;
+    }
+
+    auto channels = channelsFor(names);
+    auto onMessage = m_onMessage;
+    auto onMessages = m_onMessages;
+    auto* arbiter = m_arbiter.get();
+    size_t requests = 0;
+    for (size_t feed = 0; feed < m_feeds.size(); ++feed) {
+        if (onMessages) {
+            // Each callback only runs on its own feed's I/O thread, so the
+            // filtered batch can be reused across invocations
+            auto accepted = std::make_shared<std::vector<WSMessageView>>();
+            requests += m_feeds[feed]->subscribeBatch(
+                channels,
+                [onMessages, arbiter, feed, accepted](const std::vector<WSMessageView>& msgs) {
+                    if (!arbiter) {
+                        onMessages(msgs);
+                        return;
+                    }
+                    // Deliver under the arbiter's lock, so a copy accepted
+                    // on another connection cannot overtake this batch
+                    auto delivery = arbiter->lockDelivery();
+                    accepted->clear();
+                    for (const auto& msg : msgs) {
+                        if (arbiter->accept(feed, msg)) {
+                            accepted->push_back(msg);
+                        }
+                    }
+                    if (!accepted->empty()) {
+                        onMessages(*accepted);
+                    }
+                }
+            );
+            continue;
+        }
+        requests += m_feeds[feed]->subscribeView(
+            channels,
+            [onMessage, arbiter, feed](const WSMessageView& msg) {
+                std::unique_lock<std::mutex> delivery;
+                if (arbiter) {
+                    delivery = arbiter->lockDelivery();
+                    if (!arbiter->accept(feed, msg)) {
+                        return;
+                    }
+                }
+                if (onMessage) {
+                    onMessage(instrumentFromChannel(msg.channel), msg);
+                }
+            }
+        );
+    }
+
+    LOG_INFO("Subscribed to {} instruments in {} request(s)", names.size(), requests);
+}
+
+void SubscriptionManager::unsubscribeInstruments(const std::vector<std::string>& names) {
+    if (names.empty()) {
+        return;
+    }
+
+    auto channels = channelsFor(names);
+    for (const auto& feed : m_feeds) {
+        feed->unsubscribe(channels);
+    }
+    if (m_arbiter) {
+        for (const auto& channel : channels) {
+            m_arbiter->reset(channel);
+        }
+    }
+}
+
+} // namespace api
+} // namespace deribit
@@ -0,0 +1,338 @@
+/**
+ * @file subscription_manager.h
+ * @brief Market data subscription management
+ *
+ * This file contains the subscription manager which resolves the
+ * instrument universe from configuration and public/get_instruments,
+ * subscribes to it in batched requests and follows expiries and new
+ * listings over time, optionally over several redundant connections.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include "deribit_api.h"
+#include "../websocket/feed_arbiter.h"
+
+namespace deribit {
+
+namespace utils {
+class Config;
+} // namespace utils
+
+namespace api {
+
+/**
+ * @struct SubscriptionConfig
+ * @brief Structure describing the instrument universe to subscribe to
+ */
+struct SubscriptionConfig {
+    std::vector<std::string> instruments;  // explicit instrument names
+    std::vector<std::string> currencies;   // currencies to load from public/get_instruments
+    std::vector<std::string> kinds;        // kinds to load per currency (empty for all)
+    std::vector<std::string> channels;     // channel templates, "{instrument}" is substituted
+    size_t maxChannelsPerRequest;
+    std::chrono::milliseconds refreshInterval;
+
+    SubscriptionConfig() :
+        channels{"book.{instrument}.100ms", "trades.{instrument}.raw", "ticker.{instrument}.100ms"},
+        maxChannelsPerRequest(websocket::WSClient::kDefaultMaxChannelsPerRequest),
+        refreshInterval(std::chrono::minutes(1)) {}
+
+    /**
+     * @brief Build from the "subscriptions" section of the configuration
+     * @param config Configuration
+     * @return Subscription configuration
+     */
+    static SubscriptionConfig fromConfig(const utils::Config& config);
+};
+
+/**
+ * @brief Callback invoked for each notification on a managed channel
+ * @param instrument Instrument name the channel belongs to
+ * @param msg WebSocket message, only valid for the duration of the call
+ */
+using InstrumentMessageCallback = std::function<void(std::string_view instrument, const WSMessageView& msg)>;
+
+/**
+ * @brief Callback for a batch of channel notifications
+ *
+ * Receives the notifications decoded from one burst of reads on a
+ * connection, after arbitration. Use instrumentFromChannel() to map a
+ * notification to its instrument.
+ */
+using MessageBatchCallback = std::function<void(const std::vector<WSMessageView>& msgs)>;
+
+/**
+ * @class SubscriptionManager
+ * @brief Class for managing market data subscriptions across an instrument universe
+ *
+ * With more than one feed connection every channel is subscribed on all
+ * of them and notifications pass through a FeedArbiter, so the message
+ * callback sees each update once, from whichever connection delivered it first.
+ */
+class SubscriptionManager {
+public:
+    /**
+     * @brief Constructor
+     * @param api API client used for public/get_instruments
+     * @param wsClient WebSocket client of the primary feed connection
+     * @param config Subscription configuration
+     */
+    SubscriptionManager(
+        std::shared_ptr<DeribitAPI> api,
+        std::shared_ptr<websocket::WSClient> wsClient,
+        SubscriptionConfig config
+    );
+
+    /**
+     * @brief Destructor
+     */
+    ~SubscriptionManager();
+
+    /**
+     * @brief Set the callback for channel notifications
+     *
+     * Must be set before start(). The callback runs on the WebSocket I/O
+     * thread and receives views into the receive buffer (see WSMessageView).
+     *
+     * @param callback Callback function
+     */
+    void setOnMessage(InstrumentMessageCallback callback) {
+        m_onMessage = std::move(callback);
+    }
+
+    /**
+     * @brief Set the callback for batches of channel notifications
+     *
+     * Must be set before start(). Takes precedence over setOnMessage() and
+     * follows the same threading and lifetime rules.
+     *
+     * @param callback Callback function
+     */
+    void setOnMessages(MessageBatchCallback callback) {
+        m_onMessages = std::move(callback);
+    }
+
+    /**
+     * @brief Add a redundant market data connection
+     *
+     * Must be called before start(), which fixes the list of connections.
+     * The connection must already be connected.
+     *
+     * @param feed WebSocket client for the additional connection
+     * @return true if added, false if already started
+     */
+    bool addFeed(std::shared_ptr<websocket::WSClient> feed);
+
+    /**
+     * @brief Set callback for the loss of every feed connection
+     *
+     * Invoked on the I/O thread of the last connection to drop. Feed
+     * derived state (e.g. books) is only stale once no connection remains.
+     *
+     * @param callback Callback function
+     */
+    void setOnAllFeedsDisconnected(std::function<void()> callback) {
+        m_onAllFeedsDisconnected = std::move(callback);
+    }
+
+    /**
+     * @brief Get arbitration statistics for a feed connection
+     * @param feed Connection index, 0 being the primary connection
+     * @return FeedStats structure (empty with a single connection)
+     */
+    websocket::FeedStats getFeedStats(size_t feed) const;
+
+    /**
+     * @brief Set callback for universe changes
+     *
+     * Invoked from refresh() with no lock held, so it may call back into
+     * the manager.
+     *
+     * @param callback Callback receiving added and removed instrument names
+     */
+    void setOnUniverseChanged(
+        std::function<void(const std::vector<std::string>&, const std::vector<std::string>&)> callback
+    ) {
+        m_onUniverseChanged = std::move(callback);
+    }
+
+    /**
+     * @brief Resolve the universe and subscribe to all of its channels
+     * @return Number of instruments subscribed
+     */
+    size_t start();
+
+    /**
+     * @brief Download the instruments of the configured universe
+     *
+     * Uses only public endpoints and touches no subscription state, so it
+     * can run at startup while the connections are still being set up.
+     *
+     * @return Active, unexpired instruments of the universe
+     */
+    std::vector<Instrument> loadInstruments();
+
+    /**
+     * @brief Subscribe to the channels of instruments loaded beforehand
+     * @param instruments Instruments returned by loadInstruments()
+     * @return Number of instruments subscribed
+     */
+    size_t start(const std::vector<Instrument>& instruments);
+
+    /**
+     * @brief Drop expired instruments and pick up new listings
+     *
+     * Expired instruments are removed on every call; the universe is
+     * reloaded from the exchange once per refresh interval.
+     */
+    void refresh();
+
+    /**
+     * @brief Replace the universe selection, e.g. after a configuration reload
+     *
+     * The instruments, currencies, kinds and refresh interval take effect
+     * on the next refresh(), which reloads the universe immediately.
+     * Channel templates and batching are kept, changing them requires a
+     * restart.
+     *
+     * @param config Subscription configuration
+     */
+    void setConfig(const SubscriptionConfig& config);
+
+    /**
+     * @brief Reload the universe from the exchange on the next refresh()
+     *
+     * Used after starting from a saved instrument list, so listings and
+     * expiries since it was saved are picked up in the background.
+     */
+    void requestReload();
+
+    /**
+     * @brief Resubscribe the channels of an instrument to obtain fresh snapshots
+     * @param instrumentName Instrument name
+     * @return true if the instrument is subscribed, false otherwise
+     */
+    bool resubscribe(const std::string& instrumentName);
+
+    /**
+     * @brief Unsubscribe from all managed channels
+     */
+    void stop();
+
+    /**
+     * @brief Get the instruments currently subscribed
+     * @return Vector of instrument names
+     */
+    std::vector<std::string> getInstruments() const;
+
+    /**
+     * @brief Get the metadata of all subscribed instruments
+     * @return Vector of instruments
+     */
+    std::vector<Instrument> getInstrumentMetadata() const;
+
+    /**
+     * @brief Get the metadata of a subscribed instrument
+     * @param instrumentName Instrument name
+     * @param instrument Output instrument metadata
+     * @return true if the instrument is subscribed, false otherwise
+     */
+    bool getInstrument(const std::string& instrumentName, Instrument& instrument) const;
+
+    /**
+     * @brief Get the number of instruments currently subscribed
+     * @return Number of instruments
+     */
+    size_t getInstrumentCount() const;
+
+    /**
+     * @brief Extract the instrument name from a channel name
+     * @param channel Channel name, e.g. "book.BTC-PERPETUAL.100ms"
+     * @return Instrument name, e.g. "BTC-PERPETUAL", as a view into channel
+     */
+    static std::string_view instrumentFromChannel(std::string_view channel) {
+        auto begin = channel.find('.');
+        if (begin == std::string_view::npos) {
+            return channel;
+        }
+        auto end = channel.find('.', begin + 1);
+        return channel.substr(begin + 1, end == std::string_view::npos ? std::string_view::npos : end - begin - 1);
+    }
+
+private:
+    std::shared_ptr<DeribitAPI> m_api;
+    std::vector<std::shared_ptr<websocket::WSClient>> m_feeds;
+    std::unique_ptr<websocket::FeedArbiter> m_arbiter;
+    SubscriptionConfig m_config;
+    InstrumentMessageCallback m_onMessage;
+    MessageBatchCallback m_onMessages;
+    std::function<void()> m_onAllFeedsDisconnected;
+    std::function<void(const std::vector<std::string>&, const std::vector<std::string>&)> m_onUniverseChanged;
+
+    std::map<std::string, Instrument> m_active;
+    std::multimap<std::chrono::system_clock::time_point, std::string> m_expiries;
+    std::chrono::steady_clock::time_point m_nextReload;
+    bool m_started;
+    std::atomic<bool> m_feedsFrozen;   // m_feeds no longer changes
+    mutable std::mutex m_mutex;
+
+    /**
+     * @brief Load a universe from the exchange
+     *
+     * Runs without m_mutex held, on a copy of the configuration.
+     *
+     * @param config Subscription configuration
+     * @return Map of instrument name to metadata
+     */
+    std::map<std::string, Instrument> loadUniverse(const SubscriptionConfig& config);
+
+    /**
+     * @brief Handle the loss of a feed connection
+     */
+    void handleFeedDisconnected();
+
+    /**
+     * @brief Expand channel templates for a set of instruments
+     * @param instruments Instrument names
+     * @return Channel names
+     */
+    std::vector<std::string> channelsFor(const std::vector<std::string>& instruments) const;
+
+    /**
+     * @brief Start tracking new instruments, with m_mutex held
+     * @param instruments Instruments to add
+     * @return Names of the instruments not tracked before
+     */
+    std::vector<std::string> trackInstruments(const std::vector<Instrument>& instruments);
+
+    /**
+     * @brief Stop tracking instruments, with m_mutex held
+     * @param instruments Instrument names to remove
+     * @return Names of the instruments that were tracked
+     */
+    std::vector<std::string> untrackInstruments(const std::vector<std::string>& instruments);
+
+    /**
+     * @brief Subscribe to the channels of instruments, without m_mutex held
+     * @param names Instrument names
+     */
+    void subscribeInstruments(const std::vector<std::string>& names);
+
+    /**
+     * @brief Unsubscribe from the channels of instruments, without m_mutex held
+     * @param names Instrument names
+     */
+    void unsubscribeInstruments(const std::vector<std::string>& names);
+};
+
+} // namespace api
+} // namespace deribit
@@ -13,11 +13,31 @@
 #include <chrono>
 #include <atomic>
 #include <csignal>
+#include <algorithm>
+#include <future>
+#include <memory>
 #include "api/deribit_api.h"
+#include "api/async_api.h"
+#include "api/subscription_manager.h"
 #include "websocket/ws_server.h"
+#include "order/orderbook.h"
+#include "order/trade_store.h"
+#include "order/ticker_cache.h"
+#include "order/position_tracker.h"
+#include "order/open_orders.h"
+#include "order/state_snapshot.h"
+#include "analytics/options_analytics.h"
+#include "analytics/vol_surface.h"
+#include "strategy/strategy.h"
+#include "strategy/order_router.h"
 #include "utils/logger.h"
 #include "utils/config.h"
 #include "utils/metrics.h"
+#include "utils/timer_service.h"
+#include "utils/task_pool.h"
+#include "utils/huge_pages.h"
+#include "utils/warmup.h"
+#include "utils/startup_graph.h"
 #include "ui/terminal_ui.h"
 
 // Signal handling for graceful shutdown
@@ -28,10 +48,15 @@ void signalHandler(int signal) {
     std::cout << "Received signal " << signal << ", shutting down..." << std::endl;
 }
 
+void reloadHandler(int) {
+    deribit::utils::Config::getInstance().requestReload();
+}
+
 int main(int argc, char** argv) {
     // Register signal handlers
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
+    std::signal(SIGHUP, reloadHandler);
     
     try {
         // Initialize logger
@@ -45,6 +70,15 @@ int main(int argc, char** argv) {
             return 1;
         }
         
+        // Startup snapshot; components reading settings on hot paths call
+        // getSettings() again to see reloads
+        const auto& settings = config.getSettings();
+        
+        // Books, trade tapes and order queues allocate from pre-faulted,
+        // locked huge pages, so the region must exist before they do
+        deribit::utils::HugePageResource::getInstance().reserve(
+            deribit::utils::HugePageConfig::fromConfig(config));
+        
         // Display welcome message
         deribit::ui::TerminalUI::displayWelcomeMessage();
         
@@ -54,73 +88,588 @@ int main(int argc, char** argv) {
         
         // Initialize API client
         auto apiClient = std::make_shared<deribit::api::DeribitAPI>(
-            config.getString("api_key"),
-            config.getString("api_secret"),
-            config.getBool("testnet", true)
+            settings.apiKey,
+            settings.apiSecret,
+            settings.testnet
         );
         
-        if (!apiClient->authenticate()) {
-            LOG_ERROR("Failed to authenticate with Deribit API");
-            return 1;
-        }
+        // Initialize WebSocket server; it binds and serves on its own thread
+        auto wsServer = std::make_shared<deribit::websocket::WSServer>(
+            settings.wsPort
+        );
+        std::thread wsThread;
         
-        LOG_INFO("Successfully authenticated with Deribit API");
+        // Initialize WebSocket client for market data
+        auto wsClient = apiClient->getWebSocketClient();
         
-        // Initialize WebSocket server
-        auto wsServer = std::make_shared<deribit::websocket::WSServer>(
-            config.getUInt("ws_port", 8080)
+        // Tokens renewed by a re-authentication after a reconnect also sign
+        // the REST calls; the client owns the connection, so it is not kept alive
+        std::weak_ptr<deribit::api::DeribitAPI> restClient = apiClient;
+        wsClient->setOnReauthenticated(
+            [restClient](const std::string& accessToken, const std::string& refreshToken,
+                         std::chrono::seconds expiresIn) {
+                if (auto api = restClient.lock()) {
+                    api->setTokens(accessToken, refreshToken, expiresIn);
+                }
+            }
         );
         
-        // Start WebSocket server in a separate thread
-        std::thread wsThread([&wsServer]() {
-            wsServer->start();
+        deribit::websocket::ReconnectPolicy reconnectPolicy;
+        reconnectPolicy.initialDelay = settings.reconnectInitialDelay;
+        reconnectPolicy.maxDelay = settings.reconnectMaxDelay;
+        reconnectPolicy.maxAttempts = settings.reconnectMaxAttempts;
+        wsClient->setReconnectPolicy(reconnectPolicy);
+        
+        // The primary connection carries orders as well as market data, so
+        // it is probed and declared stale like the redundant feeds
+        deribit::websocket::HeartbeatPolicy heartbeatPolicy;
+        heartbeatPolicy.probeAfter = settings.probeAfter;
+        heartbeatPolicy.staleAfter = settings.staleAfter;
+        wsClient->setHeartbeatPolicy(heartbeatPolicy);
+        wsClient->setName("market-data-0");
+        
+        // Background computation, confined to the cores in task_pool.cpus
+        deribit::utils::TaskPool pool(deribit::utils::TaskPoolConfig::fromConfig(config));
+        pool.start();
+        
+        // Subscribe to market data for the configured instrument universe
+        deribit::api::SubscriptionManager subscriptions(
+            apiClient,
+            wsClient,
+            deribit::api::SubscriptionConfig::fromConfig(config)
+        );
+        
+        // Maintain local orderbooks; gaps are resynced from a fresh snapshot
+        auto& books = deribit::order::OrderBookManager::getInstance();
+        books.setOnResyncRequired([&subscriptions](const std::string& instrument) {
+            subscriptions.resubscribe(instrument);
         });
         
-        // Initialize WebSocket client for market data
-        auto wsClient = apiClient->getWebSocketClient();
+        // Recent trades per instrument, parsed once for strategies and the UI
+        auto& trades = deribit::order::TradeStore::getInstance();
+        trades.setCapacity(config.getUInt("trades.capacity", deribit::order::TradeTape::kDefaultCapacity));
         
-        // Subscribe to market data
-        std::vector<std::string> instruments = {
-            "BTC-PERPETUAL",
-            "ETH-PERPETUAL",
-            "BTC-25MAR22"
-        };
+        // Latest tickers and index prices, read lock-free from any thread;
+        // positions are seeded once, resized on fills and marked from every ticker
+        auto& tickers = deribit::order::TickerCache::getInstance();
+        auto& positions = deribit::order::PositionTracker::getInstance();
+        auto& options = deribit::analytics::OptionsAnalytics::getInstance();
+        tickers.setOnTicker(
+            [&positions, &options](const std::string& instrument, const deribit::order::Ticker& ticker) {
+                positions.onTicker(instrument, ticker);
+                options.onTicker(instrument, ticker);
+            }
+        );
+        
+        // Live view, rendered on its own thread from lock-free snapshots
+        deribit::ui::TerminalUI terminalUI(deribit::ui::UIConfig::fromConfig(config));
+        std::vector<std::string> shownInstruments;
+        
+        subscriptions.setOnUniverseChanged(
+            [&books, &trades, &tickers, &options, &terminalUI, &shownInstruments](
+                const std::vector<std::string>& added,
+                const std::vector<std::string>& removed
+            ) {
+                for (const auto& instrument : removed) {
+                    books.removeBook(instrument);
+                    trades.removeTape(instrument);
+                    tickers.removeTicker(instrument);
+                    options.removeOption(instrument);
+                    shownInstruments.erase(
+                        std::remove(shownInstruments.begin(), shownInstruments.end(), instrument),
+                        shownInstruments.end()
+                    );
+                }
+                shownInstruments.insert(shownInstruments.end(), added.begin(), added.end());
+                terminalUI.setInstruments(shownInstruments);
+            }
+        );
+        
+        // Books are stale once every feed connection dropped; the reconnect
+        // resubscribes all channels and the books rebuild from the snapshots
+        subscriptions.setOnAllFeedsDisconnected([&books]() {
+            books.invalidateAll();
+        });
         
-        for (const auto& instrument : instruments) {
-            LOG_INFO("Subscribing to orderbook for {}", instrument);
-            wsClient->subscribe(
-                "book." + instrument + ".100ms",
-                [&wsServer, instrument](const deribit::api::WSMessage& msg) {
-                    // Forward the message to all subscribed clients
-                    wsServer->broadcast(instrument, msg.data);
+        // Strategies are composed at compile time: list them as template
+        // arguments and pass instances to the constructor
+        using StrategyEngine = deribit::strategy::StrategyEngine<>;
+        StrategyEngine strategies;
+        deribit::strategy::OrderRouter router(apiClient, strategies.getActions());
+        
+        subscriptions.setOnMessages(
+            [&wsServer, &books, &trades, &tickers, &options, &strategies](
+                const std::vector<deribit::api::WSMessageView>& msgs
+            ) {
+                books.onBookMessages(msgs);
+                trades.onTradeMessages(msgs);
+                
+                // Options whose ticker changed are repriced together, once per batch
+                if (tickers.onTickerMessages(msgs) > 0) {
+                    options.recompute();
+                }
+                if (StrategyEngine::size() > 0) {
+                    strategies.onMessages(msgs);
+                }
+                
+                // Forward each message to the subscribed clients. The server
+                // takes strings, so the views are copied into buffers reused
+                // across batches of this I/O thread, and only with clients
+                thread_local std::string symbol;
+                thread_local std::string payload;
+                bool forward = wsServer->getClientCount() > 0;
+                auto& metrics = deribit::utils::Metrics::getInstance();
+                for (const auto& msg : msgs) {
+                    symbol.assign(deribit::api::SubscriptionManager::instrumentFromChannel(msg.channel));
+                    if (forward) {
+                        payload.assign(msg.data);
+                        wsServer->broadcast(symbol, payload);
+                    }
                     
                     // Update metrics
-                    auto& metrics = deribit::utils::Metrics::getInstance();
-                    metrics.recordMarketDataUpdate(instrument);
+                    metrics.recordMarketDataUpdate(symbol);
+                }
+            }
+        );
+        
+        // Open orders, positions and the instrument universe are saved
+        // periodically. Starting from a recent snapshot skips the instrument
+        // download; what changed on the exchange since is reconciled
+        auto& openOrders = deribit::order::OpenOrders::getInstance();
+        deribit::order::StateSnapshot snapshot(deribit::order::SnapshotConfig::fromConfig(config));
+        deribit::order::TradingState saved;
+        bool snapshotOpen = snapshot.open();
+        bool warmStart = snapshotOpen && snapshot.load(saved);
+        if (warmStart) {
+            openOrders.setOrders(saved.orders);
+            positions.setPositions(saved.positions);
+        }
+        
+        // Startup steps run concurrently, each as soon as the steps it
+        // depends on are done. Steps returning false abort the startup; the
+        // optional ones log their failure and return true
+        deribit::utils::StartupGraph startup;
+        
+        startup.addStep("authenticate", {}, [&apiClient]() {
+            if (!apiClient->authenticate()) {
+                LOG_ERROR("Failed to authenticate with Deribit API");
+                return false;
+            }
+            LOG_INFO("Successfully authenticated with Deribit API");
+            return true;
+        });
+        
+        // The instrument list is public, so it downloads while authenticating
+        std::vector<deribit::api::Instrument> instruments;
+        bool instrumentsRestored = false;
+        startup.addStep("instruments", {}, [&]() {
+            if (warmStart && !saved.instruments.empty()) {
+                auto now = std::chrono::system_clock::now();
+                for (auto& instrument : saved.instruments) {
+                    if (instrument.expiration > now) {
+                        instruments.push_back(std::move(instrument));
+                    }
+                }
+                instrumentsRestored = true;
+                LOG_INFO("Restored {} instruments from the snapshot", instruments.size());
+                return true;
+            }
+            instruments = subscriptions.loadInstruments();
+            LOG_INFO("Loaded {} instruments", instruments.size());
+            return true;
+        });
+        
+        startup.addStep("ws_server", {}, [&wsServer, &wsThread]() {
+            wsThread = std::thread([&wsServer]() {
+                wsServer->start();
+            });
+            return true;
+        });
+        
+        // Optional redundant market data connections, arbitrated per message
+        std::vector<std::string> connectSteps;
+        unsigned int feedConnections = settings.marketDataConnections;
+        std::vector<std::shared_ptr<deribit::websocket::WSClient>> feedSlots(
+            feedConnections > 1 ? feedConnections - 1 : 0);
+        for (unsigned int i = 1; i < feedConnections; ++i) {
+            connectSteps.push_back("feed_" + std::to_string(i));
+            startup.addStep(connectSteps.back(), {}, [&, i]() {
+                auto feed = std::make_shared<deribit::websocket::WSClient>(
+                    wsClient->getHost(), wsClient->getPort(), wsClient->getPath());
+                feed->setReconnectPolicy(reconnectPolicy);
+                feed->setHeartbeatPolicy(heartbeatPolicy);
+                feed->setName("market-data-" + std::to_string(i));
+                if (!feed->connect()) {
+                    LOG_WARN("Failed to open redundant market data connection {}", i);
+                    return true;
                 }
+                feedSlots[i - 1] = feed;
+                return true;
+            });
+        }
+        
+        // Position changes after each fill are subscribed, and acknowledged,
+        // before the positions are fetched, as for the open orders below
+        startup.addStep("positions", {"authenticate"}, [&apiClient, &wsClient, &positions]() {
+            auto subscribed = std::make_shared<std::promise<void>>();
+            auto acknowledged = subscribed->get_future();
+            size_t requests = wsClient->subscribeBatch({"user.changes.any.any.raw"},
+                [&positions](const std::vector<deribit::api::WSMessageView>& msgs) {
+                    positions.onChangeMessages(msgs);
+                },
+                [subscribed]() { subscribed->set_value(); }
+            );
+            if (requests == 0 || acknowledged.wait_for(std::chrono::seconds(5)) != std::future_status::ready) {
+                LOG_WARN("Position subscription not acknowledged, positions may miss fills until the next one");
+            }
+            try {
+                positions.setPositions(apiClient->getPositions());
+            } catch (const std::exception& e) {
+                LOG_WARN("Failed to load positions: {}", e.what());
+            }
+            return true;
+        });
+        
+        // Order notifications are subscribed, and the subscription
+        // acknowledged, before the open orders are fetched, so no update
+        // falls between the two
+        startup.addStep("orders", {"authenticate"}, [&apiClient, &wsClient, &openOrders]() {
+            auto subscribed = std::make_shared<std::promise<void>>();
+            auto acknowledged = subscribed->get_future();
+            size_t requests = wsClient->subscribeBatch({"user.orders.any.any.raw"},
+                [&openOrders](const std::vector<deribit::api::WSMessageView>& msgs) {
+                    openOrders.onOrderMessages(msgs);
+                },
+                [subscribed]() { subscribed->set_value(); }
             );
+            if (requests == 0 || acknowledged.wait_for(std::chrono::seconds(5)) != std::future_status::ready) {
+                LOG_WARN("Order subscription not acknowledged, open orders may miss updates until the next one");
+            }
+            try {
+                auto asOf = std::chrono::system_clock::now();
+                auto delta = openOrders.reconcile(apiClient->getOpenOrders(), asOf);
+                LOG_INFO("Open orders: {} unchanged, {} added, {} changed, {} removed",
+                         delta.unchanged, delta.added, delta.changed, delta.removed);
+            } catch (const std::exception& e) {
+                LOG_WARN("Failed to load open orders: {}", e.what());
+            }
+            return true;
+        });
+        
+        // Run synthetic market data and orders through the hot paths until
+        // their latency settles, before any live data arrives. Nothing is
+        // sent, and the strategies are not hooked up yet, so they see none of
+        // it. The stages run on each connection's I/O thread, whose arena and
+        // pools parse the live data, after the other CPU-heavy steps so the
+        // latency settles undisturbed
+        std::vector<std::string> warmupAfter{"authenticate", "instruments", "positions", "orders"};
+        warmupAfter.insert(warmupAfter.end(), connectSteps.begin(), connectSteps.end());
+        startup.addStep("warmup", warmupAfter, [&]() {
+            deribit::utils::Warmup warmup(deribit::utils::WarmupConfig::fromConfig(config));
+            const std::string warmupInstrument = "WARMUP-PERPETUAL";
+            
+            deribit::order::OrderBook warmupBook(warmupInstrument);
+            std::string snapshot = "{\"type\":\"snapshot\",\"change_id\":1,\"bids\":[";
+            std::string asks;
+            for (int i = 0; i < 20; ++i) {
+                snapshot += (i ? ",[\"new\"," : "[\"new\",") + std::to_string(50000 - i) + ",10]";
+                asks += (i ? ",[\"new\"," : "[\"new\",") + std::to_string(50001 + i) + ",10]";
+            }
+            snapshot += "],\"asks\":[" + asks + "]}";
+            const std::string change = "{\"type\":\"change\",\"prev_change_id\":1,\"change_id\":2,"
+                "\"bids\":[[\"delete\",49990,0],[\"new\",49990,7]],\"asks\":[[\"change\",50001,3]]}";
+            warmup.addStage("books", [&](uint64_t) {
+                warmupBook.applyUpdate(snapshot);
+                warmupBook.applyUpdate(change);
+            });
+            
+            const std::string ticker = "{\"timestamp\":1,\"instrument_name\":\"" + warmupInstrument +
+                "\",\"mark_price\":50000.5,\"index_price\":50001,\"best_bid_price\":50000,"
+                "\"best_bid_amount\":10,\"best_ask_price\":50001,\"best_ask_amount\":10}";
+            const std::string trade = "[{\"trade_id\":\"1\",\"timestamp\":1,\"price\":50000.5,"
+                "\"instrument_name\":\"" + warmupInstrument + "\",\"direction\":\"buy\",\"amount\":10}]";
+            const std::string tickerChannel = "ticker." + warmupInstrument + ".100ms";
+            const std::string tradeChannel = "trades." + warmupInstrument + ".raw";
+            std::vector<deribit::api::WSMessageView> batch{
+                {tickerChannel, ticker, {}},
+                {tradeChannel, trade, {}}
+            };
+            warmup.addStage("market_data", [&](uint64_t) {
+                tickers.onTickerMessages(batch);
+                trades.onTradeMessages(batch);
+            });
+            
+            // Touch every slot of the order action queue, then route actions
+            // through it and encode them as the router would
+            auto& actions = strategies.getActions();
+            deribit::strategy::OrderAction action;
+            while (actions.tryPush(action)) {}
+            while (actions.tryPop(action)) {}
+            deribit::strategy::OrderAction::setName(action.instrument, warmupInstrument);
+            action.amount = 10;
+            const std::string orderUpdate = "{\"order_id\":\"WARMUP-1\",\"instrument_name\":\"" +
+                warmupInstrument + "\",\"order_state\":\"open\",\"price\":50000,\"amount\":10,"
+                "\"filled_amount\":0}";
+            deribit::strategy::OrderEvent event;
+            warmup.addStage("orders", [&](uint64_t round) {
+                action.clientId = round;
+                action.price = 50000 - static_cast<double>(round % 100);
+                actions.tryPush(action);
+                deribit::strategy::OrderAction routed;
+                actions.tryPop(routed);
+                std::string frame = deribit::websocket::WSClient::encodeRequest(round, "private/buy",
+                    deribit::api::AsyncDeribitAPI::encodeOrderParams(routed.instrument, routed.amount,
+                                                                     routed.price, "limit"));
+                deribit::strategy::parseOrderEvent(orderUpdate, event);
+            });
+            
+            std::vector<std::shared_ptr<deribit::websocket::WSClient>> ioClients{wsClient};
+            for (const auto& feed : feedSlots) {
+                if (feed) {
+                    ioClients.push_back(feed);
+                }
+            }
+            
+            // One connection at a time, as the stages share their state
+            for (const auto& client : ioClients) {
+                std::promise<void> done;
+                auto finished = done.get_future();
+                if (!client->post([&warmup, &done]() {
+                        warmup.run();
+                        done.set_value();
+                    })) {
+                    LOG_WARN("Skipping warmup of {}: not connected", client->getName());
+                    continue;
+                }
+                finished.wait();
+            }
+            tickers.removeTicker(warmupInstrument);
+            trades.removeTape(warmupInstrument);
+            options.removeOption(warmupInstrument);
+            return true;
+        });
+        
+        startup.addStep("strategies", {"authenticate", "warmup"}, [&]() {
+            if (StrategyEngine::size() > 0) {
+                books.setOnBookUpdated([&strategies](const deribit::order::OrderBook& book) {
+                    strategies.onBookUpdated(book);
+                });
+                trades.setOnTradesAppended(
+                    [&strategies](const deribit::order::TradeTape& tape, uint64_t first, uint64_t end) {
+                        strategies.onTrades(tape, first, end);
+                    }
+                );
+                router.setOnOrderEvent([&strategies](const deribit::strategy::OrderEvent& event) {
+                    strategies.onOrderEvent(event);
+                });
+                router.start();
+            }
+            return true;
+        });
+        
+        // Initial book snapshots arrive with the first message of each
+        // subscribed channel
+        std::vector<std::string> subscribeAfter{"authenticate", "instruments", "strategies"};
+        subscribeAfter.insert(subscribeAfter.end(), connectSteps.begin(), connectSteps.end());
+        std::vector<std::shared_ptr<deribit::websocket::WSClient>> redundantFeeds;
+        startup.addStep("subscribe", subscribeAfter, [&]() {
+            for (auto& feed : feedSlots) {
+                if (feed) {
+                    subscriptions.addFeed(feed);
+                    redundantFeeds.push_back(feed);
+                }
+            }
+            size_t instrumentCount = subscriptions.start(instruments);
+            LOG_INFO("Subscribed to market data for {} instruments", instrumentCount);
+            
+            // A restored universe misses listings since the snapshot
+            if (instrumentsRestored) {
+                subscriptions.requestReload();
+            }
+            return true;
+        });
+        
+        // Price indices are not per instrument, so they are subscribed
+        // directly on the primary connection
+        startup.addStep("indices", {"authenticate", "warmup"}, [&config, &wsClient, &tickers]() {
+            auto indices = config.getStringList("tickers.indices");
+            if (indices.empty()) {
+                indices = {"btc_usd", "eth_usd"};
+            }
+            std::vector<std::string> indexChannels;
+            for (const auto& index : indices) {
+                indexChannels.push_back("deribit_price_index." + index);
+            }
+            wsClient->subscribeBatch(indexChannels, [&tickers](const std::vector<deribit::api::WSMessageView>& msgs) {
+                tickers.onTickerMessages(msgs);
+            });
+            return true;
+        });
+        
+        // The timer service is the main event loop. It runs on its own thread
+        // from here on, so coroutine sleeps and request deadlines scheduled
+        // by the startup steps fire while startup is still in progress
+        auto& timers = deribit::utils::TimerService::getInstance();
+        std::thread timerThread([&timers]() {
+            timers.run(g_running);
+        });
+        
+        bool started = startup.run();
+        startup.logTimeline();
+        if (!started) {
+            LOG_ERROR("Startup failed");
+            g_running = false;
+            timers.stop();
+            timerThread.join();
+            wsServer->stop();
+            if (wsThread.joinable()) {
+                wsThread.join();
+            }
+            return 1;
         }
         
-        // Main application loop
-        LOG_INFO("Entering main application loop");
-        while (g_running) {
-            // Process any pending API tasks
+        shownInstruments = subscriptions.getInstruments();
+        terminalUI.setInstruments(shownInstruments);
+        terminalUI.start();
+        
+        // Periodic jobs run on the timer service, which is the main event loop
+        std::vector<deribit::utils::TimerId> jobs;
+        
+        // Process any pending API tasks
+        jobs.push_back(timers.scheduleEvery(std::chrono::milliseconds(10), [&apiClient]() {
             apiClient->processEvents();
-            
-            // Update performance metrics
+        }));
+        
+        // Drop expired instruments and pick up new listings. Reloading the
+        // universe is a REST round trip, so it runs on the task pool, one
+        // refresh at a time, and never holds up the event loop
+        std::atomic<bool> refreshPending{false};
+        jobs.push_back(timers.scheduleEvery(std::chrono::seconds(1), [&subscriptions, &pool, &refreshPending]() {
+            if (refreshPending.exchange(true)) {
+                return;
+            }
+            bool queued = pool.submit([&subscriptions, &refreshPending]() {
+                subscriptions.refresh();
+                refreshPending = false;
+            });
+            if (!queued) {
+                refreshPending = false;
+            }
+        }));
+        
+        // Roll option expiries forward for time decay. Repricing the whole
+        // chain takes milliseconds, so it runs on the task pool
+        std::atomic<bool> repricePending{false};
+        jobs.push_back(timers.scheduleEvery(std::chrono::seconds(1), [&options, &pool, &repricePending]() {
+            if (repricePending.exchange(true)) {
+                return;
+            }
+            bool queued = pool.submit([&options, &repricePending]() {
+                options.recompute(true);
+                repricePending = false;
+            });
+            if (!queued) {
+                repricePending = false;
+            }
+        }));
+        
+        // Refit the volatility surfaces whose quotes moved, on the task pool
+        auto surfaceConfig = deribit::analytics::VolSurfaceConfig::fromConfig(config);
+        deribit::analytics::VolSurfaceBuilder surfaces(surfaceConfig, pool);
+        if (surfaces.start()) {
+            jobs.push_back(timers.scheduleEvery(surfaceConfig.refreshInterval, [&surfaces]() {
+                surfaces.refresh();
+            }));
+        }
+        
+        // Save the trading state on the task pool, one snapshot at a time
+        std::atomic<bool> snapshotPending{false};
+        auto takeSnapshot = [&openOrders, &positions, &subscriptions]() {
+            deribit::order::TradingState state;
+            state.orders = openOrders.getOrders();
+            state.positions = positions.getPositions();
+            state.instruments = subscriptions.getInstrumentMetadata();
+            state.takenAt = std::chrono::system_clock::now();
+            return state;
+        };
+        if (snapshotOpen) {
+            jobs.push_back(timers.scheduleEvery(snapshot.getConfig().interval, [&]() {
+                if (snapshotPending.exchange(true)) {
+                    return;
+                }
+                auto state = std::make_shared<deribit::order::TradingState>(takeSnapshot());
+                bool queued = pool.submit([&snapshot, &snapshotPending, state]() {
+                    snapshot.save(*state);
+                    snapshotPending = false;
+                });
+                if (!queued) {
+                    snapshotPending = false;
+                }
+            }));
+        }
+        
+        // Update performance metrics
+        jobs.push_back(timers.scheduleEvery(std::chrono::milliseconds(100), [&metrics]() {
             metrics.update();
-            
-            // Sleep to avoid busy-waiting
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }));
+        
+        // Reload the configuration on SIGHUP or when the file changes. The
+        // order router reads risk limits and throttles from the live
+        // snapshot on every action; connection settings only apply to new
+        // connections, so they need a restart
+        config.setOnReload([&subscriptions, &config, &settings](const deribit::utils::Settings& reloaded) {
+            subscriptions.setConfig(deribit::api::SubscriptionConfig::fromConfig(config));
+            if (reloaded.apiKey != settings.apiKey || reloaded.wsPort != settings.wsPort ||
+                reloaded.testnet != settings.testnet ||
+                reloaded.marketDataConnections != settings.marketDataConnections ||
+                reloaded.reconnectInitialDelay != settings.reconnectInitialDelay ||
+                reloaded.reconnectMaxDelay != settings.reconnectMaxDelay ||
+                reloaded.reconnectMaxAttempts != settings.reconnectMaxAttempts ||
+                reloaded.probeAfter != settings.probeAfter ||
+                reloaded.staleAfter != settings.staleAfter) {
+                LOG_WARN("Connection settings changed; they take effect after a restart");
+            }
+        });
+        jobs.push_back(timers.scheduleEvery(std::chrono::milliseconds(250), [&config]() {
+            config.pollReload();
+        }));
+        
+        if (StrategyEngine::size() > 0) {
+            jobs.push_back(timers.scheduleEvery(
+                std::chrono::milliseconds(config.getUInt("strategy.timer_interval_ms", 100)),
+                [&strategies]() { strategies.onTimer(); }
+            ));
+        }
+        
+        // Main application loop: the timer thread sleeps until the next
+        // timer is due, and returns once a signal clears g_running
+        LOG_INFO("Entering main application loop");
+        timerThread.join();
+        
+        for (auto job : jobs) {
+            timers.cancel(job);
         }
         
         // Cleanup and shutdown
         LOG_INFO("Shutting down Deribit Trading System...");
+        terminalUI.stop();
+        surfaces.stop();
+        pool.stop();
+        
+        // Stop sending order actions; strategy actions queued from now on are dropped
+        router.stop();
+        
+        // Final snapshot for the next warm start
+        if (snapshotOpen) {
+            snapshot.save(takeSnapshot());
+        }
         
         // Unsubscribe from all channels
-        for (const auto& instrument : instruments) {
-            wsClient->unsubscribe("book." + instrument + ".100ms");
+        subscriptions.stop();
+        for (auto& feed : redundantFeeds) {
+            feed->disconnect();
         }
+        wsClient->disconnect();
         
         // Stop WebSocket server
         wsServer->stop();
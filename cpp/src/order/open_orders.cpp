@@ -0,0 +1,206 @@
+/**
+ * @file open_orders.cpp
+ * @brief Open orders implementation
+ */
+
+#include "open_orders.h"
+#include "../utils/logger.h"
+#include "../utils/arena_json.h"
+#include <algorithm>
+
+namespace deribit {
+namespace order {
+
+using utils::ArenaJson;
+
+namespace {
+
+/**
+ * @brief Convert a millisecond timestamp field to a time point
+ */
+std::chrono::system_clock::time_point timestamp(const ArenaJson& object, const char* key) {
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(object.value(key, int64_t{0})));
+}
+
+/**
+ * @brief Read an order from a notification
+ *
+ * Market orders report "market_price" instead of a numeric price, read as 0.
+ */
+bool parseOrder(const ArenaJson& object, api::Order& order) {
+    if (!object.is_object()) {
+        return false;
+    }
+    auto price = object.find("price");
+    order.order_id = utils::stringField(object, "order_id");
+    order.instrument_name = utils::stringField(object, "instrument_name");
+    order.direction = utils::stringField(object, "direction");
+    order.price = price != object.end() && price->is_number() ? price->get<double>() : 0.0;
+    order.amount = object.value("amount", 0.0);
+    order.order_type = utils::stringField(object, "order_type");
+    order.order_state = utils::stringField(object, "order_state");
+    order.created_at = timestamp(object, "creation_timestamp");
+    order.last_updated_at = timestamp(object, "last_update_timestamp");
+    return !order.order_id.empty();
+}
+
+// Closed orders are remembered for longer than an open orders request takes
+constexpr auto kClosedRetention = std::chrono::minutes(5);
+constexpr size_t kClosedPruneThreshold = 1024;
+
+/**
+ * @brief Check whether two copies of an order differ in what matters for trading
+ */
+bool differs(const api::Order& a, const api::Order& b) {
+    return a.order_state != b.order_state || a.price != b.price || a.amount != b.amount;
+}
+
+} // namespace
+
+OpenOrders& OpenOrders::getInstance() {
+    static OpenOrders instance;
+    return instance;
+}
+
+size_t OpenOrders::onOrderMessages(const std::vector<api::WSMessageView>& msgs) {
+    size_t updated = 0;
+    api::Order order;
+    for (const auto& msg : msgs) {
+        if (msg.channel.compare(0, 12, "user.orders.") != 0) {
+            continue;
+        }
+        utils::ArenaScope scope;
+        const ArenaJson& data = utils::parseJson(msg.data);
+        if (data.is_discarded()) {
+            LOG_WARN("Malformed notification on {}", msg.channel);
+            continue;
+        }
+
+        // Raw channels carry one order, aggregated ones an array of them
+        if (data.is_array()) {
+            for (const auto& entry : data) {
+                if (parseOrder(entry, order)) {
+                    onOrder(order);
+                    ++updated;
+                }
+            }
+        } else if (parseOrder(data, order)) {
+            onOrder(order);
+            ++updated;
+        }
+    }
+    return updated;
+}
+
+void OpenOrders::onOrder(const api::Order& order) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (isOpen(order.order_state)) {
+        m_orders[order.order_id] = order;
+        return;
+    }
+    m_orders.erase(order.order_id);
+    auto& closedAt = m_closed[order.order_id];
+    closedAt = std::max(closedAt, order.last_updated_at);
+    if (m_closed.size() > kClosedPruneThreshold) {
+        pruneClosed(std::chrono::system_clock::now());
+    }
+}
+
+void OpenOrders::pruneClosed(std::chrono::system_clock::time_point now) {
+    for (auto it = m_closed.begin(); it != m_closed.end();) {
+        if (it->second + kClosedRetention < now) {
+            it = m_closed.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void OpenOrders::setOrders(const std::vector<api::Order>& orders) {
+    std::map<std::string, api::Order> entries;
+    for (const auto& order : orders) {
+        if (isOpen(order.order_state)) {
+            entries[order.order_id] = order;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_orders.swap(entries);
+}
+
+OpenOrders::Delta OpenOrders::reconcile(const std::vector<api::Order>& exchange,
+                                        std::chrono::system_clock::time_point asOf) {
+    std::map<std::string, const api::Order*> remote;
+    for (const auto& order : exchange) {
+        if (isOpen(order.order_state)) {
+            remote[order.order_id] = &order;
+        }
+    }
+
+    Delta delta;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_orders.begin(); it != m_orders.end();) {
+        auto found = remote.find(it->first);
+        if (found == remote.end()) {
+            // Placed or updated after the list was requested
+            if (it->second.last_updated_at > asOf) {
+                ++delta.unchanged;
+                ++it;
+                continue;
+            }
+            it = m_orders.erase(it);
+            ++delta.removed;
+            continue;
+        }
+        const api::Order& theirs = *found->second;
+        if (it->second.last_updated_at > theirs.last_updated_at) {
+            ++delta.unchanged;
+        } else if (differs(it->second, theirs)) {
+            it->second = theirs;
+            ++delta.changed;
+        } else {
+            ++delta.unchanged;
+        }
+        remote.erase(found);
+        ++it;
+    }
+    for (const auto& entry : remote) {
+        // Closed by a notification newer than the exchange's copy
+        auto closed = m_closed.find(entry.first);
+        if (closed != m_closed.end() && closed->second >= entry.second->last_updated_at) {
+            continue;
+        }
+        m_orders.emplace(entry.first, *entry.second);
+        ++delta.added;
+    }
+    pruneClosed(std::chrono::system_clock::now());
+    return delta;
+}
+
+bool OpenOrders::getOrder(const std::string& orderId, api::Order& order) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_orders.find(orderId);
+    if (it == m_orders.end()) {
+        return false;
+    }
+    order = it->second;
+    return true;
+}
+
+std::vector<api::Order> OpenOrders::getOrders() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<api::Order> orders;
+    orders.reserve(m_orders.size());
+    for (const auto& entry : m_orders) {
+        orders.push_back(entry.second);
+    }
+    return orders;
+}
+
+size_t OpenOrders::size() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_orders.size();
+}
+
+} // namespace order
+} // namespace deribit
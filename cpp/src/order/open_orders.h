@@ -0,0 +1,137 @@
+/**
+ * @file open_orders.h
+ * @brief Open orders of the account
+ *
+ * This file contains the store of the account's open orders, kept up to
+ * date from the user.orders.* subscription channels and reconciled with
+ * the exchange at startup.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <cstddef>
+#include "../api/deribit_api.h"
+
+namespace deribit {
+namespace order {
+
+/**
+ * @class OpenOrders
+ * @brief Class tracking the open orders of the account
+ *
+ * Orders are added and updated from order notifications and dropped once
+ * they leave the "open" and "untriggered" states. At startup the orders
+ * restored from a snapshot are reconciled with the exchange's list.
+ */
+class OpenOrders {
+public:
+    /**
+     * @struct Delta
+     * @brief Structure for the outcome of a reconciliation
+     */
+    struct Delta {
+        size_t added = 0;       // open on the exchange, unknown locally
+        size_t changed = 0;     // known locally with another state, price or amount
+        size_t removed = 0;     // known locally, no longer open on the exchange
+        size_t unchanged = 0;
+    };
+
+    /**
+     * @brief Get the instance (singleton)
+     * @return Reference to OpenOrders instance
+     */
+    static OpenOrders& getInstance();
+
+    /**
+     * @brief Apply the order notifications of a batch
+     *
+     * Notifications on channels other than user.orders.* are skipped.
+     *
+     * @param msgs WebSocket messages
+     * @return Number of orders updated
+     */
+    size_t onOrderMessages(const std::vector<api::WSMessageView>& msgs);
+
+    /**
+     * @brief Add, update or remove an order according to its state
+     * @param order Order
+     */
+    void onOrder(const api::Order& order);
+
+    /**
+     * @brief Replace all orders, e.g. from a snapshot
+     * @param orders Orders; those not open are skipped
+     */
+    void setOrders(const std::vector<api::Order>& orders);
+
+    /**
+     * @brief Bring the orders in line with the exchange's list of open orders
+     *
+     * Orders updated locally after the exchange's copy was taken, e.g. by
+     * a notification received in the meantime, are kept, and orders closed
+     * by such a notification are not added back.
+     *
+     * @param exchange Open orders reported by the exchange
+     * @param asOf Time the list was requested
+     * @return Differences found
+     */
+    Delta reconcile(const std::vector<api::Order>& exchange, std::chrono::system_clock::time_point asOf);
+
+    /**
+     * @brief Get an open order
+     * @param orderId Order ID
+     * @param order Output order
+     * @return true if the order is open, false otherwise
+     */
+    bool getOrder(const std::string& orderId, api::Order& order);
+
+    /**
+     * @brief Get all open orders
+     * @return Vector of orders
+     */
+    std::vector<api::Order> getOrders();
+
+    /**
+     * @brief Get the number of open orders
+     * @return Number of orders
+     */
+    size_t size();
+
+    /**
+     * @brief Check whether an order state counts as open
+     * @param state Deribit order state
+     * @return true for "open" and "untriggered", false otherwise
+     */
+    static bool isOpen(const std::string& state) {
+        return state == "open" || state == "untriggered";
+    }
+
+private:
+    // Private constructor for singleton
+    OpenOrders() = default;
+
+    // Prevent copying and assignment
+    OpenOrders(const OpenOrders&) = delete;
+    OpenOrders& operator=(const OpenOrders&) = delete;
+
+    /**
+     * @brief Drop tombstones older than the retention window
+     * @param now Current time
+     */
+    void pruneClosed(std::chrono::system_clock::time_point now);
+
+    std::map<std::string, api::Order> m_orders;
+
+    // Last update time of recently closed orders, so a stale list from
+    // the exchange cannot bring them back
+    std::map<std::string, std::chrono::system_clock::time_point> m_closed;
+    std::mutex m_mutex;
+};
+
+} // namespace order
+} // namespace deribit
@@ -0,0 +1,314 @@
+/**
+ * @file orderbook.cpp
+ * @brief Orderbook implementation
+ */
+
+#include "orderbook.h"
+#include "../api/deribit_api.h"
+#include "../utils/logger.h"
+#include "../utils/arena_json.h"
+#include "../utils/huge_pages.h"
+
+namespace deribit {
+namespace order {
+
+using utils::ArenaJson;
+
+namespace {
+
+/**
+ * @brief Apply Deribit level updates (["new"|"change"|"delete", price, amount])
+ */
+template <typename Levels>
+void applyLevels(Levels& levels, const ArenaJson& update, const char* side) {
+    auto updates = update.find(side);
+    if (updates == update.end() || !updates->is_array()) {
+        return;
+    }
+    for (const auto& level : *updates) {
+        if (!level.is_array() || level.size() < 3 || !level[0].is_string()) {
+            continue;
+        }
+        const auto& action = level[0].get_ref<const ArenaJson::string_t&>();
+        double price = level[1].get<double>();
+        double amount = level[2].get<double>();
+        if (action == "delete" || amount == 0.0) {
+            levels.erase(price);
+        } else {
+            levels[price] = amount;
+        }
+    }
+}
+
+/**
+ * @brief Extract the instrument of a "book.<instrument>.<interval>" channel
+ */
+std::string_view bookInstrument(std::string_view channel) {
+    auto begin = channel.find('.') + 1;
+    auto end = channel.find('.', begin);
+    return channel.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+}
+
+} // namespace
+
+bool BookDepth::operator==(const BookDepth& other) const {
+    if (valid != other.valid || bidCount != other.bidCount || askCount != other.askCount) {
+        return false;
+    }
+    for (size_t i = 0; i < bidCount; ++i) {
+        if (bids[i].price != other.bids[i].price || bids[i].amount != other.bids[i].amount) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < askCount; ++i) {
+        if (asks[i].price != other.asks[i].price || asks[i].amount != other.asks[i].amount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+OrderBook::OrderBook(const std::string& instrument)
+    : m_instrument(instrument), m_levelPool(&utils::HugePageResource::getInstance()),
+      m_bids(&m_levelPool), m_asks(&m_levelPool),
+      m_changeId(0), m_valid(false), m_depthLevels(0) {}
+
+BookUpdateResult OrderBook::applyUpdate(std::string_view data) {
+    utils::ArenaScope scope;
+    const ArenaJson& update = utils::parseJson(data);
+    if (update.is_discarded() || !update.is_object()) {
+        return BookUpdateResult::IGNORED;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (utils::stringField(update, "type") == "snapshot") {
+        // Released levels go back to m_levelPool, so the rebuild reuses their nodes
+        m_bids.clear();
+        m_asks.clear();
+        applyLevels(m_bids, update, "bids");
+        applyLevels(m_asks, update, "asks");
+        m_changeId = update.value("change_id", int64_t{0});
+        m_valid = true;
+        publishTop();
+        return BookUpdateResult::SNAPSHOT;
+    }
+
+    if (!m_valid) {
+        return BookUpdateResult::IGNORED;
+    }
+
+    int64_t prevChangeId = update.value("prev_change_id", int64_t{0});
+    if (prevChangeId != m_changeId) {
+        LOG_WARN("Orderbook gap on {}: expected prev_change_id {}, got {}",
+                 m_instrument, m_changeId, prevChangeId);
+        m_valid = false;
+        publishTop();
+        return BookUpdateResult::GAP;
+    }
+
+    applyLevels(m_bids, update, "bids");
+    applyLevels(m_asks, update, "asks");
+    m_changeId = update.value("change_id", m_changeId);
+    publishTop();
+    return BookUpdateResult::APPLIED;
+}
+
+void OrderBook::invalidate() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_valid = false;
+    publishTop();
+}
+
+void OrderBook::publishTop() {
+    BookTop top;
+    top.changeId = m_changeId;
+    top.valid = m_valid;
+    top.hasBid = !m_bids.empty();
+    top.hasAsk = !m_asks.empty();
+    if (top.hasBid) {
+        top.bid = PriceLevel(m_bids.begin()->first, m_bids.begin()->second);
+    }
+    if (top.hasAsk) {
+        top.ask = PriceLevel(m_asks.begin()->first, m_asks.begin()->second);
+    }
+    m_top.store(top);
+
+    if (m_depthLevels > 0) {
+        publishDepth();
+    }
+}
+
+void OrderBook::publishDepth(bool force) {
+    BookDepth depth;
+    depth.valid = m_valid;
+    for (auto it = m_bids.begin(); it != m_bids.end() && depth.bidCount < m_depthLevels; ++it) {
+        depth.bids[depth.bidCount++] = PriceLevel(it->first, it->second);
+    }
+    for (auto it = m_asks.begin(); it != m_asks.end() && depth.askCount < m_depthLevels; ++it) {
+        depth.asks[depth.askCount++] = PriceLevel(it->first, it->second);
+    }
+
+    // Changes below the watched levels are not worth a redraw
+    if (!force && depth == m_lastDepth) {
+        return;
+    }
+    m_lastDepth = depth;
+    m_depth.store(depth);
+    if (m_depthChanges) {
+        m_depthChanges->fetch_add(1, std::memory_order_release);
+    }
+}
+
+void OrderBook::watchDepth(size_t levels, std::shared_ptr<std::atomic<uint64_t>> changes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_depthLevels = std::min(levels, BookDepth::kMaxLevels);
+    m_depthChanges = levels > 0 ? std::move(changes) : nullptr;
+    if (m_depthLevels > 0) {
+        // Publish the current levels so the watcher does not wait for the next update
+        publishDepth(true);
+    }
+}
+
+bool OrderBook::isValid() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_valid;
+}
+
+int64_t OrderBook::getChangeId() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_changeId;
+}
+
+bool OrderBook::getBestBid(PriceLevel& level) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_valid || m_bids.empty()) {
+        return false;
+    }
+    level = PriceLevel(m_bids.begin()->first, m_bids.begin()->second);
+    return true;
+}
+
+bool OrderBook::getBestAsk(PriceLevel& level) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_valid || m_asks.empty()) {
+        return false;
+    }
+    level = PriceLevel(m_asks.begin()->first, m_asks.begin()->second);
+    return true;
+}
+
+std::vector<PriceLevel> OrderBook::getBids(size_t depth) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<PriceLevel> levels;
+    levels.reserve(std::min(depth, m_bids.size()));
+    for (auto it = m_bids.begin(); it != m_bids.end() && levels.size() < depth; ++it) {
+        levels.emplace_back(it->first, it->second);
+    }
+    return levels;
+}
+
+std::vector<PriceLevel> OrderBook::getAsks(size_t depth) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<PriceLevel> levels;
+    levels.reserve(std::min(depth, m_asks.size()));
+    for (auto it = m_asks.begin(); it != m_asks.end() && levels.size() < depth; ++it) {
+        levels.emplace_back(it->first, it->second);
+    }
+    return levels;
+}
+
+OrderBookManager& OrderBookManager::getInstance() {
+    static OrderBookManager instance;
+    return instance;
+}
+
+BookUpdateResult OrderBookManager::onBookMessage(std::string_view instrument, std::string_view data) {
+    std::shared_ptr<OrderBook> book;
+    {
+        std::lock_guard<std::mutex> lock(m_booksMutex);
+        auto it = m_books.find(instrument);
+        if (it == m_books.end()) {
+            std::string name(instrument);
+            it = m_books.emplace(name, std::make_shared<OrderBook>(name)).first;
+        }
+        book = it->second;
+    }
+
+    BookUpdateResult result = book->applyUpdate(data);
+    if (result == BookUpdateResult::GAP && m_onResyncRequired) {
+        m_onResyncRequired(book->getInstrument());
+    } else if ((result == BookUpdateResult::SNAPSHOT || result == BookUpdateResult::APPLIED) && m_onBookUpdated) {
+        std::lock_guard<std::mutex> batchLock(m_batchMutex);
+        m_onBookUpdated(*book);
+    }
+    return result;
+}
+
+size_t OrderBookManager::onBookMessages(const std::vector<api::WSMessageView>& msgs) {
+    // Redundant feeds deliver batches from several I/O threads
+    std::lock_guard<std::mutex> batchLock(m_batchMutex);
+    m_batchBooks.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_booksMutex);
+        for (const auto& msg : msgs) {
+            if (msg.channel.compare(0, 5, "book.") != 0) {
+                m_batchBooks.push_back(nullptr);
+                continue;
+            }
+            auto instrument = bookInstrument(msg.channel);
+            auto it = m_books.find(instrument);
+            if (it == m_books.end()) {
+                std::string name(instrument);
+                it = m_books.emplace(name, std::make_shared<OrderBook>(name)).first;
+            }
+            m_batchBooks.push_back(it->second);
+        }
+    }
+
+    size_t applied = 0;
+    std::vector<std::string> gaps;
+    for (size_t i = 0; i < msgs.size(); ++i) {
+        if (!m_batchBooks[i]) {
+            continue;
+        }
+        BookUpdateResult result = m_batchBooks[i]->applyUpdate(msgs[i].data);
+        if (result == BookUpdateResult::SNAPSHOT || result == BookUpdateResult::APPLIED) {
+            ++applied;
+            if (m_onBookUpdated) {
+                m_onBookUpdated(*m_batchBooks[i]);
+            }
+        } else if (result == BookUpdateResult::GAP) {
+            gaps.push_back(m_batchBooks[i]->getInstrument());
+        }
+    }
+    m_batchBooks.clear();
+
+    if (m_onResyncRequired) {
+        for (const auto& instrument : gaps) {
+            m_onResyncRequired(instrument);
+        }
+    }
+    return applied;
+}
+
+std::shared_ptr<OrderBook> OrderBookManager::getBook(const std::string& instrument) {
+    std::lock_guard<std::mutex> lock(m_booksMutex);
+    auto it = m_books.find(instrument);
+    return it != m_books.end() ? it->second : nullptr;
+}
+
+void OrderBookManager::removeBook(const std::string& instrument) {
+    std::lock_guard<std::mutex> lock(m_booksMutex);
+    m_books.erase(instrument);
+}
+
+void OrderBookManager::invalidateAll() {
+    std::lock_guard<std::mutex> lock(m_booksMutex);
+    for (auto& entry : m_books) {
+        entry.second->invalidate();
+    }
+}
+
+} // namespace order
+} // namespace deribit
@@ -0,0 +1,359 @@
+/**
+ * @file orderbook.h
+ * @brief Orderbook data structures
+ *
+ * This file contains the local orderbook maintained from the Deribit
+ * book.* subscription channels, and the manager holding one book per
+ * instrument.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include "../utils/seqlock.h"
+
+namespace deribit {
+
+namespace api {
+struct WSMessageView;
+} // namespace api
+
+namespace order {
+
+/**
+ * @struct PriceLevel
+ * @brief Structure representing an aggregated price level
+ */
+struct PriceLevel {
+    double price;
+    double amount;
+
+    PriceLevel() : price(0.0), amount(0.0) {}
+    PriceLevel(double p, double a) : price(p), amount(a) {}
+};
+
+/**
+ * @struct BookTop
+ * @brief Structure for the top of a book, published without locks
+ */
+struct BookTop {
+    PriceLevel bid;
+    PriceLevel ask;
+    int64_t changeId;
+    bool valid;
+    bool hasBid;
+    bool hasAsk;
+
+    BookTop() : changeId(0), valid(false), hasBid(false), hasAsk(false) {}
+};
+
+/**
+ * @struct BookDepth
+ * @brief Structure for the top levels of a book, published without locks
+ */
+struct BookDepth {
+    static constexpr size_t kMaxLevels = 10;
+
+    PriceLevel bids[kMaxLevels];
+    PriceLevel asks[kMaxLevels];
+    uint8_t bidCount;
+    uint8_t askCount;
+    bool valid;
+
+    BookDepth() : bidCount(0), askCount(0), valid(false) {}
+
+    bool operator==(const BookDepth& other) const;
+    bool operator!=(const BookDepth& other) const { return !(*this == other); }
+};
+
+/**
+ * @struct BookView
+ * @brief Structure giving read access to the live levels of a book
+ *
+ * Only valid inside the visitor passed to OrderBook::visit(), which holds
+ * the book's lock.
+ */
+struct BookView {
+    const std::string& instrument;
+    const std::pmr::map<double, double, std::greater<double>>& bids;  // best first
+    const std::pmr::map<double, double>& asks;                        // best first
+    int64_t changeId;
+    bool valid;
+};
+
+/**
+ * @enum BookUpdateResult
+ * @brief Enum representing the outcome of applying a book notification
+ */
+enum class BookUpdateResult {
+    SNAPSHOT,   // Book rebuilt from a snapshot
+    APPLIED,    // Incremental change applied
+    GAP,        // Sequence gap detected, book invalidated until the next snapshot
+    IGNORED     // Change received while waiting for a snapshot, or malformed
+};
+
+/**
+ * @class OrderBook
+ * @brief Class representing the local orderbook of an instrument
+ *
+ * The book is rebuilt from "snapshot" notifications and updated by
+ * "change" notifications. Each change must carry a prev_change_id equal
+ * to the last applied change_id, otherwise the book is invalidated and
+ * stays invalid until a new snapshot arrives.
+ */
+class OrderBook {
+public:
+    /**
+     * @brief Constructor
+     * @param instrument Instrument name
+     */
+    explicit OrderBook(const std::string& instrument);
+
+    /**
+     * @brief Apply a book notification
+     * @param data Serialized "data" object of the notification
+     * @return Result of the update
+     */
+    BookUpdateResult applyUpdate(std::string_view data);
+
+    /**
+     * @brief Invalidate the book until the next snapshot
+     */
+    void invalidate();
+
+    /**
+     * @brief Get the instrument
+     * @return Instrument name
+     */
+    const std::string& getInstrument() const { return m_instrument; }
+
+    /**
+     * @brief Check whether the book is in sync with the exchange
+     * @return true if valid, false otherwise
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Get the last applied change ID
+     * @return Change ID
+     */
+    int64_t getChangeId() const;
+
+    /**
+     * @brief Get the best bid
+     * @param level Output price level
+     * @return true if the book is valid and has bids, false otherwise
+     */
+    bool getBestBid(PriceLevel& level) const;
+
+    /**
+     * @brief Get the best ask
+     * @param level Output price level
+     * @return true if the book is valid and has asks, false otherwise
+     */
+    bool getBestAsk(PriceLevel& level) const;
+
+    /**
+     * @brief Get the top bid levels
+     * @param depth Maximum number of levels
+     * @return Vector of price levels, best first
+     */
+    std::vector<PriceLevel> getBids(size_t depth) const;
+
+    /**
+     * @brief Get the top ask levels
+     * @param depth Maximum number of levels
+     * @return Vector of price levels, best first
+     */
+    std::vector<PriceLevel> getAsks(size_t depth) const;
+
+    /**
+     * @brief Read the live levels without copying them
+     *
+     * The visitor runs with the book's lock held, so it must be short and
+     * must not call back into the book.
+     *
+     * @param visitor Callable taking a const BookView&
+     * @return Result of the visitor
+     */
+    template <typename Visitor>
+    auto visit(Visitor&& visitor) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return visitor(BookView{m_instrument, m_bids, m_asks, m_changeId, m_valid});
+    }
+
+    /**
+     * @brief Get the top of the book without taking the book's lock
+     *
+     * For readers off the market data path, such as the UI, that must
+     * never contend with updates.
+     *
+     * @return Last published top of the book
+     */
+    BookTop getTop() const { return m_top.load(); }
+
+    /**
+     * @brief Get the version of the published top of the book
+     * @return Version, changes whenever the book is updated or invalidated
+     */
+    uint64_t getTopVersion() const { return m_top.getVersion(); }
+
+    /**
+     * @brief Start or stop publishing the top levels of the book
+     *
+     * While watched, the book publishes its top levels after every update
+     * that changes them and then increments changes, so a reader can wait
+     * on a single counter for any number of books. Updates below the
+     * watched levels publish nothing.
+     *
+     * @param levels Number of levels per side, 0 to stop, at most BookDepth::kMaxLevels
+     * @param changes Counter incremented after each publication
+     */
+    void watchDepth(size_t levels, std::shared_ptr<std::atomic<uint64_t>> changes);
+
+    /**
+     * @brief Get the top levels without taking the book's lock
+     * @return Last published depth, empty unless watched
+     */
+    BookDepth getDepth() const { return m_depth.load(); }
+
+    /**
+     * @brief Get the version of the published depth
+     * @return Version, changes whenever the watched levels change
+     */
+    uint64_t getDepthVersion() const { return m_depth.getVersion(); }
+
+private:
+    std::string m_instrument;
+    // Level nodes are recycled through the pool, which takes its chunks
+    // from huge pages, see HugePageResource
+    std::pmr::unsynchronized_pool_resource m_levelPool;
+    std::pmr::map<double, double, std::greater<double>> m_bids;
+    std::pmr::map<double, double> m_asks;
+    int64_t m_changeId;
+    bool m_valid;
+    mutable std::mutex m_mutex;
+    utils::SeqLock<BookTop> m_top;
+
+    // Depth publication, only while watched
+    size_t m_depthLevels;
+    std::shared_ptr<std::atomic<uint64_t>> m_depthChanges;
+    BookDepth m_lastDepth;
+    utils::SeqLock<BookDepth> m_depth;
+
+    /**
+     * @brief Publish the top of the book and the watched depth, called with m_mutex held
+     */
+    void publishTop();
+
+    /**
+     * @brief Publish the watched depth if it changed, called with m_mutex held
+     * @param force Publish even if unchanged
+     */
+    void publishDepth(bool force = false);
+};
+
+/**
+ * @class OrderBookManager
+ * @brief Class for managing the local orderbooks of all instruments
+ */
+class OrderBookManager {
+public:
+    /**
+     * @brief Get the instance (singleton)
+     * @return Reference to OrderBookManager instance
+     */
+    static OrderBookManager& getInstance();
+
+    /**
+     * @brief Apply a book notification for an instrument
+     * @param instrument Instrument name
+     * @param data Serialized "data" object of the notification
+     * @return Result of the update
+     */
+    BookUpdateResult onBookMessage(std::string_view instrument, std::string_view data);
+
+    /**
+     * @brief Apply a batch of notifications
+     *
+     * Books are looked up under a single lock for the whole batch, and
+     * notifications on channels other than book.* are skipped. Resync
+     * callbacks are invoked after the batch has been applied.
+     *
+     * @param msgs WebSocket messages
+     * @return Number of notifications applied, including snapshots
+     */
+    size_t onBookMessages(const std::vector<api::WSMessageView>& msgs);
+
+    /**
+     * @brief Get the book for an instrument
+     * @param instrument Instrument name
+     * @return Shared pointer to OrderBook, or nullptr if not found
+     */
+    std::shared_ptr<OrderBook> getBook(const std::string& instrument);
+
+    /**
+     * @brief Remove the book for an instrument
+     * @param instrument Instrument name
+     */
+    void removeBook(const std::string& instrument);
+
+    /**
+     * @brief Invalidate all books, e.g. after the feed connection dropped
+     */
+    void invalidateAll();
+
+    /**
+     * @brief Set callback for books that need a fresh snapshot
+     *
+     * Invoked once per detected sequence gap.
+     *
+     * @param callback Callback function
+     */
+    void setOnResyncRequired(std::function<void(const std::string&)> callback) {
+        m_onResyncRequired = callback;
+    }
+
+    /**
+     * @brief Set callback for books changed by a snapshot or an update
+     *
+     * Invoked on the market data thread right after the book changed,
+     * one call at a time even with several feed connections.
+     *
+     * @param callback Callback function
+     */
+    void setOnBookUpdated(std::function<void(const OrderBook&)> callback) {
+        m_onBookUpdated = callback;
+    }
+
+private:
+    // Private constructor for singleton
+    OrderBookManager() = default;
+
+    // Prevent copying and assignment
+    OrderBookManager(const OrderBookManager&) = delete;
+    OrderBookManager& operator=(const OrderBookManager&) = delete;
+
+    std::map<std::string, std::shared_ptr<OrderBook>, std::less<>> m_books;
+    std::mutex m_booksMutex;
+
+    // Batch state, only touched by the thread delivering the batch; the
+    // lock also serializes m_onBookUpdated calls across feed threads
+    std::vector<std::shared_ptr<OrderBook>> m_batchBooks;
+    std::mutex m_batchMutex;
+
+    std::function<void(const std::string&)> m_onResyncRequired;
+    std::function<void(const OrderBook&)> m_onBookUpdated;
+};
+
+} // namespace order
+} // namespace deribit
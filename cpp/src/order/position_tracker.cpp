@@ -0,0 +1,178 @@
+/**
+ * @file position_tracker.cpp
+ * @brief Position tracker implementation
+ */
+
+#include "position_tracker.h"
+#include "../utils/logger.h"
+#include "../utils/arena_json.h"
+
+namespace deribit {
+namespace order {
+
+using utils::ArenaJson;
+
+namespace {
+
+/**
+ * @brief Read a numeric field, treating missing and null fields as 0
+ */
+double number(const ArenaJson& object, const char* key) {
+    auto it = object.find(key);
+    return it != object.end() && it->is_number() ? it->get<double>() : 0.0;
+}
+
+/**
+ * @brief Check whether an instrument is an inverse contract
+ *
+ * Options have four name parts (BTC-27DEC24-50000-C); USDC-settled
+ * instruments carry the settlement currency (BTC_USDC-PERPETUAL).
+ */
+bool isInverse(const std::string& instrument) {
+    size_t dashes = 0;
+    for (char c : instrument) {
+        if (c == '-') {
+            ++dashes;
+        }
+    }
+    auto base = instrument.substr(0, instrument.find('-'));
+    return dashes < 3 && base.find('_') == std::string::npos;
+}
+
+} // namespace
+
+PositionTracker& PositionTracker::getInstance() {
+    static PositionTracker instance;
+    return instance;
+}
+
+void PositionTracker::setPositions(const std::vector<api::Position>& positions) {
+    std::map<std::string, Entry, std::less<>> entries;
+    for (const auto& position : positions) {
+        if (position.size != 0) {
+            entries[position.instrument_name] = makeEntry(position);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_positions.swap(entries);
+}
+
+void PositionTracker::setPosition(const api::Position& position) {
+    Entry entry = makeEntry(position);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (position.size == 0) {
+        m_positions.erase(position.instrument_name);
+    } else {
+        m_positions[position.instrument_name] = std::move(entry);
+    }
+}
+
+size_t PositionTracker::onChangeMessages(const std::vector<api::WSMessageView>& msgs) {
+    size_t updated = 0;
+    api::Position position;
+    for (const auto& msg : msgs) {
+        if (msg.channel.compare(0, 13, "user.changes.") != 0) {
+            continue;
+        }
+        utils::ArenaScope scope;
+        const ArenaJson& data = utils::parseJson(msg.data);
+        if (data.is_discarded() || !data.is_object()) {
+            LOG_WARN("Malformed notification on {}", msg.channel);
+            continue;
+        }
+        auto changed = data.find("positions");
+        if (changed == data.end() || !changed->is_array()) {
+            continue;
+        }
+
+        // Each entry is the full position after the change, a closed one has size 0
+        for (const auto& entry : *changed) {
+            if (!entry.is_object()) {
+                continue;
+            }
+            position.instrument_name = utils::stringField(entry, "instrument_name");
+            if (position.instrument_name.empty()) {
+                continue;
+            }
+            position.size = number(entry, "size");
+            position.entry_price = number(entry, "average_price");
+            position.mark_price = number(entry, "mark_price");
+            position.unrealized_pnl = number(entry, "floating_profit_loss");
+            position.realized_pnl = number(entry, "realized_profit_loss");
+            position.liquidation_price = number(entry, "estimated_liquidation_price");
+            setPosition(position);
+            ++updated;
+        }
+    }
+    return updated;
+}
+
+void PositionTracker::onTicker(const std::string& instrument, const Ticker& ticker) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_positions.find(instrument);
+    if (it != m_positions.end()) {
+        mark(it->second, ticker.markPrice);
+    }
+}
+
+bool PositionTracker::getPosition(const std::string& instrument, api::Position& position) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_positions.find(instrument);
+    if (it == m_positions.end()) {
+        return false;
+    }
+    position = it->second.position;
+    return true;
+}
+
+std::vector<api::Position> PositionTracker::getPositions() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<api::Position> positions;
+    positions.reserve(m_positions.size());
+    for (const auto& entry : m_positions) {
+        positions.push_back(entry.second.position);
+    }
+    return positions;
+}
+
+double PositionTracker::getUnrealizedPnl(const std::string& currency) {
+    // Match the whole currency part, so "BTC" leaves out BTC_USDC-* instruments
+    std::string prefix = currency.empty() ? currency : currency + "-";
+    std::lock_guard<std::mutex> lock(m_mutex);
+    double pnl = 0;
+    for (const auto& entry : m_positions) {
+        if (entry.first.compare(0, prefix.size(), prefix) == 0) {
+            pnl += entry.second.position.unrealized_pnl;
+        }
+    }
+    return pnl;
+}
+
+PositionTracker::Entry PositionTracker::makeEntry(const api::Position& position) {
+    Entry entry{position, isInverse(position.instrument_name)};
+    Ticker ticker;
+    if (TickerCache::getInstance().getTicker(position.instrument_name, ticker) && ticker.valid) {
+        mark(entry, ticker.markPrice);
+    }
+    return entry;
+}
+
+void PositionTracker::mark(Entry& entry, double markPrice) {
+    auto& position = entry.position;
+    if (markPrice <= 0) {
+        return;
+    }
+    position.mark_price = markPrice;
+    if (entry.inverse) {
+        // Size in USD, PnL in the base currency
+        position.unrealized_pnl = position.entry_price > 0
+            ? position.size * (1.0 / position.entry_price - 1.0 / markPrice)
+            : 0.0;
+    } else {
+        position.unrealized_pnl = position.size * (markPrice - position.entry_price);
+    }
+}
+
+} // namespace order
+} // namespace deribit
@@ -0,0 +1,133 @@
+/**
+ * @file position_tracker.h
+ * @brief Positions marked to market from the ticker cache
+ *
+ * This file contains the tracker keeping the account positions and
+ * updating their mark price and unrealized PnL on every ticker.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include "../api/deribit_api.h"
+#include "ticker_cache.h"
+
+namespace deribit {
+namespace order {
+
+/**
+ * @class PositionTracker
+ * @brief Class for marking positions to market incrementally
+ *
+ * Positions are seeded once, e.g. from DeribitAPI::getPositions(),
+ * resized from the user.changes.* notifications sent after each fill, and
+ * revalued from each ticker of their instrument instead of polling the
+ * exchange. Futures quoted in USD and settled in the base currency
+ * (e.g. BTC-PERPETUAL) are valued as inverse contracts; options and
+ * USDC-settled instruments as linear ones.
+ */
+class PositionTracker {
+public:
+    /**
+     * @brief Get the instance (singleton)
+     * @return Reference to PositionTracker instance
+     */
+    static PositionTracker& getInstance();
+
+    /**
+     * @brief Replace all positions
+     *
+     * Positions are marked right away from the cached tickers.
+     *
+     * @param positions Positions
+     */
+    void setPositions(const std::vector<api::Position>& positions);
+
+    /**
+     * @brief Add or replace the position of an instrument
+     * @param position Position; a size of 0 removes it
+     */
+    void setPosition(const api::Position& position);
+
+    /**
+     * @brief Apply the position changes of a notification batch
+     *
+     * Notifications on channels other than user.changes.* are skipped.
+     *
+     * @param msgs WebSocket messages
+     * @return Number of positions updated
+     */
+    size_t onChangeMessages(const std::vector<api::WSMessageView>& msgs);
+
+    /**
+     * @brief Revalue the position of an instrument, see TickerCache::setOnTicker()
+     * @param instrument Instrument name
+     * @param ticker Latest ticker
+     */
+    void onTicker(const std::string& instrument, const Ticker& ticker);
+
+    /**
+     * @brief Get the position of an instrument
+     * @param instrument Instrument name
+     * @param position Output position
+     * @return true if a position is held, false otherwise
+     */
+    bool getPosition(const std::string& instrument, api::Position& position);
+
+    /**
+     * @brief Get all positions
+     * @return Vector of positions
+     */
+    std::vector<api::Position> getPositions();
+
+    /**
+     * @brief Get the unrealized PnL summed over all positions
+     *
+     * Inverse positions are in the base currency and linear ones in the
+     * settlement currency, so sums are only meaningful per currency.
+     *
+     * @param currency Currency of the instruments, e.g. "BTC" or "BTC_USDC" (empty for all)
+     * @return Unrealized PnL
+     */
+    double getUnrealizedPnl(const std::string& currency = "");
+
+private:
+    // Private constructor for singleton
+    PositionTracker() = default;
+
+    // Prevent copying and assignment
+    PositionTracker(const PositionTracker&) = delete;
+    PositionTracker& operator=(const PositionTracker&) = delete;
+
+    /**
+     * @struct Entry
+     * @brief Structure for a tracked position
+     */
+    struct Entry {
+        api::Position position;
+        bool inverse;
+    };
+
+    /**
+     * @brief Build a position entry marked from the cached ticker
+     * @param position Position
+     * @return Entry
+     */
+    static Entry makeEntry(const api::Position& position);
+
+    /**
+     * @brief Update the mark price and unrealized PnL of a position
+     * @param entry Position
+     * @param markPrice Mark price
+     */
+    static void mark(Entry& entry, double markPrice);
+
+    std::map<std::string, Entry, std::less<>> m_positions;
+    std::mutex m_mutex;
+};
+
+} // namespace order
+} // namespace deribit
@@ -0,0 +1,202 @@
+/**
+ * @file state_snapshot.cpp
+ * @brief State snapshot implementation
+ */
+
+#include "state_snapshot.h"
+#include "../utils/config.h"
+#include "../utils/logger.h"
+
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+namespace order {
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr int kFormatVersion = 1;
+
+int64_t toMillis(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromMillis(int64_t millis) {
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(millis));
+}
+
+} // namespace
+
+SnapshotConfig SnapshotConfig::fromConfig(const utils::Config& config) {
+    SnapshotConfig result;
+    result.enabled = config.getBool("snapshot.enabled", result.enabled);
+    result.path = config.getString("snapshot.path", result.path);
+    result.interval = std::chrono::milliseconds(config.getUInt(
+        "snapshot.interval_ms", static_cast<unsigned int>(result.interval.count())));
+    result.fileBytes = static_cast<size_t>(
+        config.getUInt("snapshot.file_mb", static_cast<unsigned int>(result.fileBytes >> 20))) << 20;
+    result.sync = config.getBool("snapshot.sync", result.sync);
+    result.maxAge = std::chrono::seconds(config.getUInt(
+        "snapshot.max_age_s", static_cast<unsigned int>(result.maxAge.count())));
+    return result;
+}
+
+StateSnapshot::StateSnapshot(SnapshotConfig config) : m_config(std::move(config)) {}
+
+bool StateSnapshot::open() {
+    if (!m_config.enabled) {
+        return false;
+    }
+    return m_file.open(m_config.path, m_config.fileBytes, m_config.sync);
+}
+
+bool StateSnapshot::load(TradingState& state) {
+    std::string payload;
+    uint64_t sequence = 0;
+    if (!m_file.read(payload, sequence)) {
+        return false;
+    }
+    if (!decode(payload, state)) {
+        LOG_WARN("Snapshot {} in {} is unreadable, ignoring it", sequence, m_config.path);
+        return false;
+    }
+
+    auto age = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now() - state.takenAt);
+    if (age > m_config.maxAge) {
+        LOG_INFO("Snapshot {} is {} s old, ignoring it", sequence, age.count());
+        return false;
+    }
+    LOG_INFO("Loaded snapshot {} from {} s ago: {} orders, {} positions, {} instruments",
+             sequence, age.count(), state.orders.size(), state.positions.size(), state.instruments.size());
+    return true;
+}
+
+bool StateSnapshot::save(const TradingState& state) {
+    if (!m_file.isOpen()) {
+        return false;
+    }
+    std::string payload = encode(state);
+    if (!m_file.write(payload)) {
+        LOG_WARN("Snapshot of {} bytes does not fit in {} ({} bytes per snapshot)",
+                 payload.size(), m_config.path, m_file.getCapacity());
+        return false;
+    }
+    return true;
+}
+
+std::string StateSnapshot::encode(const TradingState& state) {
+    json orders = json::array();
+    for (const auto& order : state.orders) {
+        orders.push_back({
+            {"order_id", order.order_id},
+            {"instrument_name", order.instrument_name},
+            {"direction", order.direction},
+            {"price", order.price},
+            {"amount", order.amount},
+            {"order_type", order.order_type},
+            {"order_state", order.order_state},
+            {"created_at", toMillis(order.created_at)},
+            {"last_updated_at", toMillis(order.last_updated_at)}
+        });
+    }
+
+    json positions = json::array();
+    for (const auto& position : state.positions) {
+        positions.push_back({
+            {"instrument_name", position.instrument_name},
+            {"size", position.size},
+            {"entry_price", position.entry_price},
+            {"mark_price", position.mark_price},
+            {"unrealized_pnl", position.unrealized_pnl},
+            {"realized_pnl", position.realized_pnl},
+            {"liquidation_price", position.liquidation_price}
+        });
+    }
+
+    json instruments = json::array();
+    for (const auto& instrument : state.instruments) {
+        instruments.push_back({
+            {"instrument_name", instrument.instrument_name},
+            {"currency", instrument.currency},
+            {"kind", instrument.kind},
+            {"option_type", instrument.option_type},
+            {"strike", instrument.strike},
+            {"tick_size", instrument.tick_size},
+            {"contract_size", instrument.contract_size},
+            {"min_trade_amount", instrument.min_trade_amount},
+            {"is_active", instrument.is_active},
+            {"expiration", toMillis(instrument.expiration)}
+        });
+    }
+
+    json snapshot = {
+        {"version", kFormatVersion},
+        {"taken_at", toMillis(state.takenAt)},
+        {"orders", std::move(orders)},
+        {"positions", std::move(positions)},
+        {"instruments", std::move(instruments)}
+    };
+    return snapshot.dump();
+}
+
+bool StateSnapshot::decode(std::string_view payload, TradingState& state) {
+    json snapshot = json::parse(payload, nullptr, false);
+    if (snapshot.is_discarded() || !snapshot.is_object() || snapshot.value("version", 0) != kFormatVersion) {
+        return false;
+    }
+
+    try {
+        TradingState result;
+        result.takenAt = fromMillis(snapshot.at("taken_at").get<int64_t>());
+
+        for (const auto& entry : snapshot.at("orders")) {
+            api::Order order;
+            order.order_id = entry.at("order_id").get<std::string>();
+            order.instrument_name = entry.at("instrument_name").get<std::string>();
+            order.direction = entry.at("direction").get<std::string>();
+            order.price = entry.at("price").get<double>();
+            order.amount = entry.at("amount").get<double>();
+            order.order_type = entry.at("order_type").get<std::string>();
+            order.order_state = entry.at("order_state").get<std::string>();
+            order.created_at = fromMillis(entry.at("created_at").get<int64_t>());
+            order.last_updated_at = fromMillis(entry.at("last_updated_at").get<int64_t>());
+            result.orders.push_back(std::move(order));
+        }
+
+        for (const auto& entry : snapshot.at("positions")) {
+            api::Position position;
+            position.instrument_name = entry.at("instrument_name").get<std::string>();
+            position.size = entry.at("size").get<double>();
+            position.entry_price = entry.at("entry_price").get<double>();
+            position.mark_price = entry.at("mark_price").get<double>();
+            position.unrealized_pnl = entry.at("unrealized_pnl").get<double>();
+            position.realized_pnl = entry.at("realized_pnl").get<double>();
+            position.liquidation_price = entry.at("liquidation_price").get<double>();
+            result.positions.push_back(std::move(position));
+        }
+
+        for (const auto& entry : snapshot.at("instruments")) {
+            api::Instrument instrument;
+            instrument.instrument_name = entry.at("instrument_name").get<std::string>();
+            instrument.currency = entry.at("currency").get<std::string>();
+            instrument.kind = entry.at("kind").get<std::string>();
+            instrument.option_type = entry.at("option_type").get<std::string>();
+            instrument.strike = entry.at("strike").get<double>();
+            instrument.tick_size = entry.at("tick_size").get<double>();
+            instrument.contract_size = entry.at("contract_size").get<double>();
+            instrument.min_trade_amount = entry.at("min_trade_amount").get<double>();
+            instrument.is_active = entry.at("is_active").get<bool>();
+            instrument.expiration = fromMillis(entry.at("expiration").get<int64_t>());
+            result.instruments.push_back(std::move(instrument));
+        }
+
+        state = std::move(result);
+        return true;
+    } catch (const json::exception&) {
+        return false;
+    }
+}
+
+} // namespace order
+} // namespace deribit
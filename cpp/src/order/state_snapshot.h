@@ -0,0 +1,130 @@
+/**
+ * @file state_snapshot.h
+ * @brief Persistent snapshots of the trading state for warm restarts
+ *
+ * This file contains the periodic snapshot of open orders, positions and
+ * instrument metadata to a memory-mapped file, and its loading at startup
+ * so that only the changes since the snapshot are fetched from the
+ * exchange.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include "../api/deribit_api.h"
+#include "../utils/snapshot_file.h"
+
+namespace deribit {
+
+namespace utils {
+class Config;
+} // namespace utils
+
+namespace order {
+
+/**
+ * @struct SnapshotConfig
+ * @brief Structure for the snapshot settings
+ */
+struct SnapshotConfig {
+    bool enabled;
+    std::string path;
+    std::chrono::milliseconds interval;     // between snapshots
+    size_t fileBytes;                       // holds two snapshots
+    bool sync;                              // flush each snapshot to disk
+    std::chrono::seconds maxAge;            // older snapshots are ignored at startup
+
+    SnapshotConfig() :
+        enabled(false),
+        path("state/trading-state.snap"),
+        interval(std::chrono::seconds(1)),
+        fileBytes(64 << 20),
+        sync(false),
+        maxAge(std::chrono::hours(1)) {}
+
+    /**
+     * @brief Build from the "snapshot" section of the configuration
+     * @param config Configuration
+     * @return Snapshot configuration
+     */
+    static SnapshotConfig fromConfig(const utils::Config& config);
+};
+
+/**
+ * @struct TradingState
+ * @brief Structure for the state kept across restarts
+ */
+struct TradingState {
+    std::vector<api::Order> orders;             // open orders
+    std::vector<api::Position> positions;
+    std::vector<api::Instrument> instruments;   // subscribed universe
+    std::chrono::system_clock::time_point takenAt;
+};
+
+/**
+ * @class StateSnapshot
+ * @brief Class saving and loading the trading state
+ *
+ * Snapshots are stored in a SnapshotFile, so a crash while saving leaves
+ * the previous snapshot intact. Saving may run on any thread; calls are
+ * serialized by the file.
+ */
+class StateSnapshot {
+public:
+    /**
+     * @brief Constructor
+     * @param config Snapshot configuration
+     */
+    explicit StateSnapshot(SnapshotConfig config);
+
+    /**
+     * @brief Open the snapshot file
+     * @return true if open, false if disabled or the file cannot be mapped
+     */
+    bool open();
+
+    /**
+     * @brief Load the latest snapshot
+     * @param state Output state
+     * @return true if a snapshot younger than the maximum age was loaded, false otherwise
+     */
+    bool load(TradingState& state);
+
+    /**
+     * @brief Save a snapshot
+     * @param state State to save
+     * @return true if saved, false otherwise
+     */
+    bool save(const TradingState& state);
+
+    /**
+     * @brief Get the configuration
+     * @return Snapshot configuration
+     */
+    const SnapshotConfig& getConfig() const { return m_config; }
+
+    /**
+     * @brief Encode a state as a snapshot payload
+     * @param state State
+     * @return Payload
+     */
+    static std::string encode(const TradingState& state);
+
+    /**
+     * @brief Decode a snapshot payload
+     * @param payload Payload
+     * @param state Output state
+     * @return true if decoded, false if malformed
+     */
+    static bool decode(std::string_view payload, TradingState& state);
+
+private:
+    SnapshotConfig m_config;
+    utils::SnapshotFile m_file;
+};
+
+} // namespace order
+} // namespace deribit
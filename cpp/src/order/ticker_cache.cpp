@@ -0,0 +1,148 @@
+/**
+ * @file ticker_cache.cpp
+ * @brief Ticker cache implementation
+ */
+
+#include "ticker_cache.h"
+#include "../api/deribit_api.h"
+#include "../utils/logger.h"
+#include "../utils/arena_json.h"
+
+namespace deribit {
+namespace order {
+
+using utils::ArenaJson;
+
+namespace {
+
+/**
+ * @brief Read a numeric field, treating missing and null fields as 0
+ */
+double number(const ArenaJson& object, const char* key) {
+    auto it = object.find(key);
+    return it != object.end() && it->is_number() ? it->get<double>() : 0.0;
+}
+
+} // namespace
+
+TickerCache& TickerCache::getInstance() {
+    static TickerCache instance;
+    return instance;
+}
+
+size_t TickerCache::onTickerMessages(const std::vector<api::WSMessageView>& msgs) {
+    std::lock_guard<std::mutex> batchLock(m_batchMutex);
+    size_t stored = 0;
+
+    for (const auto& msg : msgs) {
+        bool isTicker = msg.channel.compare(0, 7, "ticker.") == 0;
+        bool isIndex = !isTicker && msg.channel.compare(0, 20, "deribit_price_index.") == 0;
+        if (!isTicker && !isIndex) {
+            continue;
+        }
+        utils::ArenaScope scope;
+        const ArenaJson& data = utils::parseJson(msg.data);
+        if (data.is_discarded() || !data.is_object()) {
+            LOG_WARN("Malformed notification on {}", msg.channel);
+            continue;
+        }
+
+        if (isIndex) {
+            IndexPrice price;
+            price.price = number(data, "price");
+            price.timestamp = data.value("timestamp", int64_t{0});
+            price.valid = true;
+
+            std::shared_ptr<IndexSlot> slot;
+            {
+                auto indexName = utils::stringField(data, "index_name");
+                std::lock_guard<std::mutex> lock(m_slotsMutex);
+                auto it = m_indices.find(indexName);
+                if (it == m_indices.end()) {
+                    it = m_indices.emplace(std::string(indexName), std::make_shared<IndexSlot>()).first;
+                }
+                slot = it->second;
+            }
+            slot->store(price);
+            ++stored;
+            continue;
+        }
+
+        Ticker ticker;
+        ticker.markPrice = number(data, "mark_price");
+        ticker.indexPrice = number(data, "index_price");
+        ticker.lastPrice = number(data, "last_price");
+        ticker.bestBidPrice = number(data, "best_bid_price");
+        ticker.bestBidAmount = number(data, "best_bid_amount");
+        ticker.bestAskPrice = number(data, "best_ask_price");
+        ticker.bestAskAmount = number(data, "best_ask_amount");
+        ticker.underlyingPrice = number(data, "underlying_price");
+        ticker.markIv = number(data, "mark_iv");
+        ticker.openInterest = number(data, "open_interest");
+        ticker.currentFunding = number(data, "current_funding");
+        ticker.funding8h = number(data, "funding_8h");
+        ticker.timestamp = data.value("timestamp", int64_t{0});
+        ticker.valid = true;
+
+        auto name = utils::stringField(data, "instrument_name");
+        std::shared_ptr<TickerEntry> entry;
+        {
+            std::lock_guard<std::mutex> lock(m_slotsMutex);
+            auto it = m_tickers.find(name);
+            if (it == m_tickers.end()) {
+                it = m_tickers.emplace(std::string(name), std::make_shared<TickerEntry>(std::string(name))).first;
+            }
+            // The entry keeps the name alive if removeTicker() erases the node meanwhile
+            entry = it->second;
+        }
+        entry->slot.store(ticker);
+        ++stored;
+
+        if (m_onTicker) {
+            m_onTicker(entry->instrument, ticker);
+        }
+    }
+    return stored;
+}
+
+std::shared_ptr<const TickerSlot> TickerCache::getTickerSlot(const std::string& instrument) {
+    std::lock_guard<std::mutex> lock(m_slotsMutex);
+    auto it = m_tickers.find(instrument);
+    if (it == m_tickers.end()) {
+        return nullptr;
+    }
+    // Share ownership of the entry, the slot is a member of it
+    return std::shared_ptr<const TickerSlot>(it->second, &it->second->slot);
+}
+
+bool TickerCache::getTicker(const std::string& instrument, Ticker& ticker) {
+    auto slot = getTickerSlot(instrument);
+    if (!slot) {
+        return false;
+    }
+    ticker = slot->load();
+    return true;
+}
+
+std::shared_ptr<const IndexSlot> TickerCache::getIndexSlot(const std::string& indexName) {
+    std::lock_guard<std::mutex> lock(m_slotsMutex);
+    auto it = m_indices.find(indexName);
+    return it != m_indices.end() ? it->second : nullptr;
+}
+
+bool TickerCache::getIndexPrice(const std::string& indexName, IndexPrice& price) {
+    auto slot = getIndexSlot(indexName);
+    if (!slot) {
+        return false;
+    }
+    price = slot->load();
+    return true;
+}
+
+void TickerCache::removeTicker(const std::string& instrument) {
+    std::lock_guard<std::mutex> lock(m_slotsMutex);
+    m_tickers.erase(instrument);
+}
+
+} // namespace order
+} // namespace deribit
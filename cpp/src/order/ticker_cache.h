@@ -0,0 +1,176 @@
+/**
+ * @file ticker_cache.h
+ * @brief Cache of the latest tickers and index prices
+ *
+ * This file contains the per-instrument ticker cache filled from the
+ * Deribit ticker.* and deribit_price_index.* subscription channels.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+#include "../utils/seqlock.h"
+
+namespace deribit {
+
+namespace api {
+struct WSMessageView;
+} // namespace api
+
+namespace order {
+
+/**
+ * @struct Ticker
+ * @brief Structure representing the latest ticker of an instrument
+ */
+struct Ticker {
+    double markPrice;
+    double indexPrice;
+    double lastPrice;
+    double bestBidPrice;
+    double bestBidAmount;
+    double bestAskPrice;
+    double bestAskAmount;
+    double underlyingPrice;  // options and futures, 0 otherwise
+    double markIv;           // options, 0 otherwise
+    double openInterest;
+    double currentFunding;   // perpetuals, 0 otherwise
+    double funding8h;        // perpetuals, 0 otherwise
+    int64_t timestamp;       // milliseconds since epoch
+    bool valid;
+
+    Ticker() : markPrice(0), indexPrice(0), lastPrice(0), bestBidPrice(0), bestBidAmount(0),
+               bestAskPrice(0), bestAskAmount(0), underlyingPrice(0), markIv(0), openInterest(0),
+               currentFunding(0), funding8h(0), timestamp(0), valid(false) {}
+};
+
+/**
+ * @struct IndexPrice
+ * @brief Structure representing the latest value of a price index
+ */
+struct IndexPrice {
+    double price;
+    int64_t timestamp;       // milliseconds since epoch
+    bool valid;
+
+    IndexPrice() : price(0), timestamp(0), valid(false) {}
+};
+
+using TickerSlot = utils::SeqLock<Ticker>;
+using IndexSlot = utils::SeqLock<IndexPrice>;
+
+/**
+ * @class TickerCache
+ * @brief Class for managing the latest tickers and index prices
+ *
+ * Each instrument and index has a slot written by the market data thread.
+ * Readers on other threads look a slot up once and then load it without
+ * locking; a slot stays valid for as long as the reader holds it.
+ */
+class TickerCache {
+public:
+    /**
+     * @brief Get the instance (singleton)
+     * @return Reference to TickerCache instance
+     */
+    static TickerCache& getInstance();
+
+    /**
+     * @brief Store the tickers and index prices of a notification batch
+     *
+     * Notifications on channels other than ticker.* and
+     * deribit_price_index.* are skipped.
+     *
+     * @param msgs WebSocket messages
+     * @return Number of tickers and index prices stored
+     */
+    size_t onTickerMessages(const std::vector<api::WSMessageView>& msgs);
+
+    /**
+     * @brief Get the ticker slot of an instrument
+     * @param instrument Instrument name
+     * @return Shared pointer to the slot, or nullptr if no ticker was seen
+     */
+    std::shared_ptr<const TickerSlot> getTickerSlot(const std::string& instrument);
+
+    /**
+     * @brief Get the latest ticker of an instrument
+     * @param instrument Instrument name
+     * @param ticker Output ticker
+     * @return true if a ticker was seen, false otherwise
+     */
+    bool getTicker(const std::string& instrument, Ticker& ticker);
+
+    /**
+     * @brief Get the slot of a price index
+     * @param indexName Index name, e.g. "btc_usd"
+     * @return Shared pointer to the slot, or nullptr if no price was seen
+     */
+    std::shared_ptr<const IndexSlot> getIndexSlot(const std::string& indexName);
+
+    /**
+     * @brief Get the latest value of a price index
+     * @param indexName Index name, e.g. "btc_usd"
+     * @param price Output price
+     * @return true if a price was seen, false otherwise
+     */
+    bool getIndexPrice(const std::string& indexName, IndexPrice& price);
+
+    /**
+     * @brief Remove the ticker of an instrument
+     * @param instrument Instrument name
+     */
+    void removeTicker(const std::string& instrument);
+
+    /**
+     * @brief Set callback for stored tickers
+     *
+     * Invoked on the market data thread after each ticker is published,
+     * one call at a time.
+     *
+     * @param callback Callback receiving the instrument name and ticker
+     */
+    void setOnTicker(std::function<void(const std::string&, const Ticker&)> callback) {
+        m_onTicker = callback;
+    }
+
+private:
+    // Private constructor for singleton
+    TickerCache() = default;
+
+    // Prevent copying and assignment
+    TickerCache(const TickerCache&) = delete;
+    TickerCache& operator=(const TickerCache&) = delete;
+
+    /**
+     * @struct TickerEntry
+     * @brief Ticker slot together with its instrument name
+     *
+     * The name lives in the shared entry so the market data thread can
+     * hand it to the callback after removeTicker() dropped the map node.
+     */
+    struct TickerEntry {
+        std::string instrument;
+        TickerSlot slot;
+
+        explicit TickerEntry(std::string name) : instrument(std::move(name)) {}
+    };
+
+    std::map<std::string, std::shared_ptr<TickerEntry>, std::less<>> m_tickers;
+    std::map<std::string, std::shared_ptr<IndexSlot>, std::less<>> m_indices;
+    std::mutex m_slotsMutex;
+
+    // Serializes writers, redundant feeds deliver batches from several I/O threads
+    std::mutex m_batchMutex;
+
+    std::function<void(const std::string&, const Ticker&)> m_onTicker;
+};
+
+} // namespace order
+} // namespace deribit
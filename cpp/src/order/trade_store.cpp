@@ -0,0 +1,264 @@
+/**
+ * @file trade_store.cpp
+ * @brief Trade store implementation
+ */
+
+#include "trade_store.h"
+#include "../api/deribit_api.h"
+#include "../utils/logger.h"
+#include "../utils/arena_json.h"
+#include "../utils/huge_pages.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace deribit {
+namespace order {
+
+using utils::ArenaJson;
+
+namespace {
+
+size_t roundUp(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    return size;
+}
+
+/**
+ * @brief Parse the numeric part of a trade ID such as "ETH-2696097" or "2696097"
+ */
+uint64_t parseTradeId(std::string_view id) {
+    auto dash = id.rfind('-');
+    if (dash != std::string_view::npos) {
+        id.remove_prefix(dash + 1);
+    }
+    uint64_t value = 0;
+    for (char c : id) {
+        if (c < '0' || c > '9') {
+            return 0;
+        }
+        value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return value;
+}
+
+} // namespace
+
+TradeTape::TradeTape(const std::string& instrument, size_t capacity)
+    : m_instrument(instrument),
+      m_capacity(roundUp(capacity)),
+      m_mask(m_capacity - 1),
+      m_timestamps(m_capacity, 0, &utils::HugePageResource::getInstance()),
+      m_priceTicks(m_capacity, 0, &utils::HugePageResource::getInstance()),
+      m_amounts(m_capacity, 0.0, &utils::HugePageResource::getInstance()),
+      m_directions(m_capacity, 0, &utils::HugePageResource::getInstance()),
+      m_tradeIds(m_capacity, 0, &utils::HugePageResource::getInstance()) {}
+
+void TradeTape::append(const TradeRecord& trade) {
+    uint64_t sequence = m_count.load(std::memory_order_relaxed);
+    // Keep the slot writes behind the previous count store, as intact()
+    // relies on the count having moved past any slot it sees overwritten
+    std::atomic_thread_fence(std::memory_order_release);
+    size_t index = sequence & m_mask;
+    m_timestamps[index] = trade.timestamp;
+    m_priceTicks[index] = std::llround(trade.price / kPriceTick);
+    m_amounts[index] = trade.amount;
+    m_directions[index] = trade.side == OrderSide::BUY ? 1 : -1;
+    m_tradeIds[index] = trade.tradeId;
+    m_count.store(sequence + 1, std::memory_order_release);
+}
+
+bool TradeTape::get(uint64_t sequence, TradeRecord& trade) const {
+    uint64_t count = getCount();
+    if (sequence >= count || count - sequence >= m_capacity) {
+        return false;
+    }
+    size_t index = sequence & m_mask;
+    trade.timestamp = m_timestamps[index];
+    trade.price = static_cast<double>(m_priceTicks[index]) * kPriceTick;
+    trade.amount = m_amounts[index];
+    trade.side = m_directions[index] > 0 ? OrderSide::BUY : OrderSide::SELL;
+    trade.tradeId = m_tradeIds[index];
+    return intact(sequence);
+}
+
+size_t TradeTape::getLast(size_t count, std::vector<TradeRecord>& trades) const {
+    for (;;) {
+        trades.clear();
+        uint64_t end = getCount();
+        uint64_t begin = end - std::min<uint64_t>({count, end, m_capacity - 1});
+        trades.resize(end - begin);
+        for (uint64_t sequence = begin; sequence < end; ++sequence) {
+            size_t index = sequence & m_mask;
+            TradeRecord& trade = trades[sequence - begin];
+            trade.timestamp = m_timestamps[index];
+            trade.price = static_cast<double>(m_priceTicks[index]) * kPriceTick;
+            trade.amount = m_amounts[index];
+            trade.side = m_directions[index] > 0 ? OrderSide::BUY : OrderSide::SELL;
+            trade.tradeId = m_tradeIds[index];
+        }
+        if (intact(begin)) {
+            return trades.size();
+        }
+    }
+}
+
+TradeStats TradeTape::getStatsSince(int64_t sinceTimestamp) const {
+    TradeStats stats;
+    for (;;) {
+        uint64_t end = getCount();
+        uint64_t oldest = end - std::min<uint64_t>(end, m_capacity - 1);
+
+        // Trades of an instrument arrive in time order
+        uint64_t low = oldest;
+        uint64_t high = end;
+        while (low < high) {
+            uint64_t middle = low + (high - low) / 2;
+            if (m_timestamps[middle & m_mask] < sinceTimestamp) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        if (aggregate(low, end, stats) && intact(oldest)) {
+            return stats;
+        }
+    }
+}
+
+TradeStats TradeTape::getStatsLast(size_t count) const {
+    TradeStats stats;
+    for (;;) {
+        uint64_t end = getCount();
+        uint64_t begin = end - std::min<uint64_t>({count, end, m_capacity - 1});
+        if (aggregate(begin, end, stats)) {
+            return stats;
+        }
+    }
+}
+
+bool TradeTape::aggregate(uint64_t begin, uint64_t end, TradeStats& stats) const {
+    double volume = 0;
+    double notional = 0;      // in ticks
+    double signedVolume = 0;  // buys minus sells
+
+    // At most two contiguous runs, before and after the wrap
+    size_t first = begin & m_mask;
+    size_t length = static_cast<size_t>(end - begin);
+    size_t runs[2][2] = {
+        {first, first + std::min(length, m_capacity - first)},
+        {0, length - std::min(length, m_capacity - first)},
+    };
+    for (const auto& run : runs) {
+        const double* amounts = m_amounts.data();
+        const int64_t* ticks = m_priceTicks.data();
+        const int8_t* directions = m_directions.data();
+#pragma omp simd reduction(+:volume, notional, signedVolume)
+        for (size_t i = run[0]; i < run[1]; ++i) {
+            volume += amounts[i];
+            notional += amounts[i] * static_cast<double>(ticks[i]);
+            signedVolume += amounts[i] * static_cast<double>(directions[i]);
+        }
+    }
+
+    if (!intact(begin)) {
+        return false;
+    }
+
+    stats = TradeStats();
+    stats.count = length;
+    stats.volume = volume;
+    stats.buyVolume = (volume + signedVolume) / 2;
+    stats.sellVolume = (volume - signedVolume) / 2;
+    if (volume > 0) {
+        stats.vwap = notional / volume * kPriceTick;
+        stats.imbalance = signedVolume / volume;
+    }
+    return true;
+}
+
+bool TradeTape::intact(uint64_t begin) const {
+    // The writer fills slot getCount() & mask before publishing it, so a
+    // range is intact while that slot is not one of its own
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return m_count.load(std::memory_order_relaxed) - begin < m_capacity;
+}
+
+TradeStore& TradeStore::getInstance() {
+    static TradeStore instance;
+    return instance;
+}
+
+size_t TradeStore::onTradeMessages(const std::vector<api::WSMessageView>& msgs) {
+    std::lock_guard<std::mutex> batchLock(m_batchMutex);
+    size_t appended = 0;
+
+    std::shared_ptr<TradeTape> tape;
+    uint64_t first = 0;
+    auto flush = [this, &tape, &first]() {
+        if (tape && m_onTradesAppended && tape->getCount() > first) {
+            m_onTradesAppended(*tape, first, tape->getCount());
+        }
+        tape.reset();
+    };
+
+    for (const auto& msg : msgs) {
+        if (msg.channel.compare(0, 7, "trades.") != 0) {
+            continue;
+        }
+        utils::ArenaScope scope;
+        const ArenaJson& trades = utils::parseJson(msg.data);
+        if (trades.is_discarded() || !trades.is_array()) {
+            LOG_WARN("Malformed trades notification on {}", msg.channel);
+            continue;
+        }
+
+        // Aggregated channels (trades.future.BTC.raw) mix instruments
+        for (const auto& entry : trades) {
+            if (!entry.is_object()) {
+                continue;
+            }
+            auto instrument = utils::stringField(entry, "instrument_name");
+            if (!tape || tape->getInstrument() != instrument) {
+                flush();
+                std::lock_guard<std::mutex> lock(m_tapesMutex);
+                auto it = m_tapes.find(instrument);
+                if (it == m_tapes.end()) {
+                    std::string name(instrument);
+                    it = m_tapes.emplace(name, std::make_shared<TradeTape>(name, m_capacity)).first;
+                }
+                tape = it->second;
+                first = tape->getCount();
+            }
+
+            TradeRecord trade;
+            trade.timestamp = entry.value("timestamp", int64_t{0});
+            trade.price = entry.value("price", 0.0);
+            trade.amount = entry.value("amount", 0.0);
+            trade.side = utils::stringField(entry, "direction") == "sell" ? OrderSide::SELL : OrderSide::BUY;
+            trade.tradeId = parseTradeId(utils::stringField(entry, "trade_id"));
+            tape->append(trade);
+            ++appended;
+        }
+    }
+    flush();
+    return appended;
+}
+
+std::shared_ptr<TradeTape> TradeStore::getTape(const std::string& instrument) {
+    std::lock_guard<std::mutex> lock(m_tapesMutex);
+    auto it = m_tapes.find(instrument);
+    return it != m_tapes.end() ? it->second : nullptr;
+}
+
+void TradeStore::removeTape(const std::string& instrument) {
+    std::lock_guard<std::mutex> lock(m_tapesMutex);
+    m_tapes.erase(instrument);
+}
+
+} // namespace order
+} // namespace deribit
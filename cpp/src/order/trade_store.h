@@ -0,0 +1,248 @@
+/**
+ * @file trade_store.h
+ * @brief In-memory store of recent public trades
+ *
+ * This file contains the per-instrument trade tape filled from the
+ * Deribit trades.* subscription channels, and the store holding one tape
+ * per instrument.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include "order.h"
+
+namespace deribit {
+
+namespace api {
+struct WSMessageView;
+} // namespace api
+
+namespace order {
+
+/**
+ * @struct TradeRecord
+ * @brief Structure representing a public trade
+ */
+struct TradeRecord {
+    int64_t timestamp;   // milliseconds since epoch
+    double price;
+    double amount;
+    OrderSide side;      // taker side
+    uint64_t tradeId;    // numeric part of the exchange trade ID
+
+    TradeRecord() : timestamp(0), price(0), amount(0), side(OrderSide::BUY), tradeId(0) {}
+};
+
+/**
+ * @struct TradeStats
+ * @brief Structure for aggregates over a window of trades
+ */
+struct TradeStats {
+    size_t count;
+    double volume;
+    double buyVolume;
+    double sellVolume;
+    double vwap;         // 0 if the window is empty
+    double imbalance;    // (buy - sell) / volume, in [-1, 1]
+
+    TradeStats() : count(0), volume(0), buyVolume(0), sellVolume(0), vwap(0), imbalance(0) {}
+};
+
+/**
+ * @class TradeTape
+ * @brief Class for a ring buffer of the recent trades of an instrument
+ *
+ * Trades are stored column by column (timestamp, price, amount,
+ * direction, trade ID), so aggregates over a window are plain loops over
+ * contiguous arrays that the compiler vectorizes. Prices are stored as
+ * integer ticks of kPriceTick.
+ *
+ * append() must be called from one thread at a time. Readers do not
+ * lock: they read a range, then check that the writer did not wrap over
+ * it meanwhile, and retry or report failure if it did.
+ */
+class TradeTape {
+public:
+    static constexpr double kPriceTick = 1e-8;
+    static constexpr size_t kDefaultCapacity = 1 << 16;
+
+    /**
+     * @brief Constructor
+     * @param instrument Instrument name
+     * @param capacity Number of trades kept, rounded up to a power of two
+     */
+    explicit TradeTape(const std::string& instrument, size_t capacity = kDefaultCapacity);
+
+    /**
+     * @brief Append a trade, overwriting the oldest if full
+     * @param trade Trade
+     */
+    void append(const TradeRecord& trade);
+
+    /**
+     * @brief Get the instrument
+     * @return Instrument name
+     */
+    const std::string& getInstrument() const { return m_instrument; }
+
+    /**
+     * @brief Get the capacity
+     * @return Number of trades kept
+     */
+    size_t getCapacity() const { return m_capacity; }
+
+    /**
+     * @brief Get the number of trades appended since creation
+     *
+     * Trade sequence numbers run from 0 to getCount() - 1; the last
+     * getCapacity() of them are retained.
+     *
+     * @return Trade count
+     */
+    uint64_t getCount() const { return m_count.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Get a trade by sequence number
+     * @param sequence Sequence number
+     * @param trade Output trade
+     * @return true if the trade is retained, false otherwise
+     */
+    bool get(uint64_t sequence, TradeRecord& trade) const;
+
+    /**
+     * @brief Copy the most recent trades
+     * @param count Maximum number of trades
+     * @param trades Output trades, oldest first; cleared first
+     * @return Number of trades copied
+     */
+    size_t getLast(size_t count, std::vector<TradeRecord>& trades) const;
+
+    /**
+     * @brief Aggregate the retained trades at or after a time
+     * @param sinceTimestamp Start of the window, milliseconds since epoch
+     * @return Trade statistics
+     */
+    TradeStats getStatsSince(int64_t sinceTimestamp) const;
+
+    /**
+     * @brief Aggregate the most recent trades
+     * @param count Number of trades
+     * @return Trade statistics
+     */
+    TradeStats getStatsLast(size_t count) const;
+
+private:
+    std::string m_instrument;
+    size_t m_capacity;
+    uint64_t m_mask;
+
+    // Columns live in huge pages, see HugePageResource
+    std::pmr::vector<int64_t> m_timestamps;
+    std::pmr::vector<int64_t> m_priceTicks;
+    std::pmr::vector<double> m_amounts;
+    std::pmr::vector<int8_t> m_directions;  // +1 buy, -1 sell
+    std::pmr::vector<uint64_t> m_tradeIds;
+
+    alignas(64) std::atomic<uint64_t> m_count{0};
+
+    /**
+     * @brief Aggregate a range of sequence numbers
+     * @param begin First sequence number
+     * @param end One past the last sequence number
+     * @param stats Output statistics
+     * @return true if the range was not overwritten while reading, false otherwise
+     */
+    bool aggregate(uint64_t begin, uint64_t end, TradeStats& stats) const;
+
+    /**
+     * @brief Check whether a range read earlier has been overwritten since
+     * @param begin First sequence number that was read
+     * @return true if still intact, false otherwise
+     */
+    bool intact(uint64_t begin) const;
+};
+
+/**
+ * @class TradeStore
+ * @brief Class for managing the trade tapes of all instruments
+ */
+class TradeStore {
+public:
+    /**
+     * @brief Get the instance (singleton)
+     * @return Reference to TradeStore instance
+     */
+    static TradeStore& getInstance();
+
+    /**
+     * @brief Append the trades of a notification batch
+     *
+     * Notifications on channels other than trades.* are skipped. Each
+     * trade is parsed once; consumers read the tapes.
+     *
+     * @param msgs WebSocket messages
+     * @return Number of trades appended
+     */
+    size_t onTradeMessages(const std::vector<api::WSMessageView>& msgs);
+
+    /**
+     * @brief Get the tape of an instrument
+     * @param instrument Instrument name
+     * @return Shared pointer to TradeTape, or nullptr if no trade was seen
+     */
+    std::shared_ptr<TradeTape> getTape(const std::string& instrument);
+
+    /**
+     * @brief Remove the tape of an instrument
+     * @param instrument Instrument name
+     */
+    void removeTape(const std::string& instrument);
+
+    /**
+     * @brief Set the capacity of tapes created from now on
+     * @param capacity Number of trades kept per instrument
+     */
+    void setCapacity(size_t capacity) { m_capacity = capacity; }
+
+    /**
+     * @brief Set callback for appended trades
+     *
+     * Invoked on the market data thread once per tape and notification,
+     * with the sequence numbers of the new trades, one call at a time.
+     *
+     * @param callback Callback receiving the tape, first and one past the last sequence number
+     */
+    void setOnTradesAppended(std::function<void(const TradeTape&, uint64_t, uint64_t)> callback) {
+        m_onTradesAppended = callback;
+    }
+
+private:
+    // Private constructor for singleton
+    TradeStore() = default;
+
+    // Prevent copying and assignment
+    TradeStore(const TradeStore&) = delete;
+    TradeStore& operator=(const TradeStore&) = delete;
+
+    std::map<std::string, std::shared_ptr<TradeTape>, std::less<>> m_tapes;
+    std::mutex m_tapesMutex;
+    std::atomic<size_t> m_capacity{TradeTape::kDefaultCapacity};
+
+    // Serializes writers, redundant feeds deliver batches from several I/O threads
+    std::mutex m_batchMutex;
+
+    std::function<void(const TradeTape&, uint64_t, uint64_t)> m_onTradesAppended;
+};
+
+} // namespace order
+} // namespace deribit
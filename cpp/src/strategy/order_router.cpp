@@ -0,0 +1,234 @@
+/**
+ * @file order_router.cpp
+ * @brief Order router implementation
+ */
+
+#include "order_router.h"
+#include "../order/open_orders.h"
+#include "../order/position_tracker.h"
+#include "../utils/config.h"
+#include "../utils/logger.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace deribit {
+namespace strategy {
+
+namespace {
+
+// Empty polls before the router thread starts sleeping between polls
+const int kSpinPolls = 1000;
+const std::chrono::microseconds kIdleSleep{50};
+
+const char* orderTypeName(order::OrderType type) {
+    switch (type) {
+        case order::OrderType::MARKET: return "market";
+        case order::OrderType::STOP_LIMIT: return "stop_limit";
+        case order::OrderType::STOP_MARKET: return "stop_market";
+        default: return "limit";
+    }
+}
+
+OrderEvent eventFor(const OrderAction& action) {
+    OrderEvent event;
+    event.strategy = action.strategy;
+    event.clientId = action.clientId;
+    event.instrument = action.instrument;
+    event.orderId = action.orderId;
+    event.price = action.price;
+    event.amount = action.amount;
+    return event;
+}
+
+} // namespace
+
+OrderRouter::OrderRouter(std::shared_ptr<api::DeribitAPI> api, OrderActionQueue& actions)
+    : m_api(std::move(api)), m_actions(actions) {}
+
+OrderRouter::~OrderRouter() {
+    stop();
+}
+
+bool OrderRouter::start() {
+    if (m_running.exchange(true)) {
+        return false;
+    }
+    m_thread = std::thread(&OrderRouter::run, this);
+    return true;
+}
+
+void OrderRouter::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void OrderRouter::run() {
+    OrderAction action;
+    int idlePolls = 0;
+    while (m_running) {
+        bool busy = false;
+        while (m_actions.tryPop(action)) {
+            route(action);
+            busy = true;
+        }
+        busy = complete(false) > 0 || busy;
+
+        if (busy) {
+            idlePolls = 0;
+        } else if (++idlePolls > kSpinPolls) {
+            std::this_thread::sleep_for(kIdleSleep);
+        }
+    }
+    complete(true);
+}
+
+bool OrderRouter::admit(const OrderAction& action, std::string& reason) {
+    const utils::Settings& settings = utils::Config::getInstance().getSettings();
+    const utils::RiskLimits& risk = settings.risk;
+    const utils::ThrottleLimits& throttle = settings.throttle;
+    bool isOrder = action.type != OrderAction::Type::CANCEL;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_windowStart >= std::chrono::seconds(1)) {
+        m_windowStart = now;
+        m_ordersInWindow = 0;
+        m_requestsInWindow = 0;
+    }
+    if (throttle.maxRequestsPerSecond > 0 && m_requestsInWindow >= throttle.maxRequestsPerSecond) {
+        reason = "request rate limit reached";
+        return false;
+    }
+    if (isOrder && throttle.maxOrdersPerSecond > 0 && m_ordersInWindow >= throttle.maxOrdersPerSecond) {
+        reason = "order rate limit reached";
+        return false;
+    }
+
+    if (isOrder && risk.maxOrderAmount > 0 && action.amount > risk.maxOrderAmount) {
+        reason = "order amount above limit";
+        return false;
+    }
+    if (action.type == OrderAction::Type::PLACE) {
+        if (risk.maxOpenOrders > 0) {
+            size_t pending = 0;
+            for (const auto& request : m_inFlight) {
+                pending += request.action.type == OrderAction::Type::PLACE;
+            }
+            if (order::OpenOrders::getInstance().size() + pending >= risk.maxOpenOrders) {
+                reason = "open order limit reached";
+                return false;
+            }
+        }
+        if (risk.maxPositionAmount > 0) {
+            api::Position position;
+            double size = order::PositionTracker::getInstance().getPosition(action.instrument, position)
+                ? position.size : 0.0;
+            size += action.side == order::OrderSide::BUY ? action.amount : -action.amount;
+            if (std::abs(size) > risk.maxPositionAmount) {
+                reason = "position limit reached";
+                return false;
+            }
+        }
+    }
+
+    ++m_requestsInWindow;
+    m_ordersInWindow += isOrder;
+    return true;
+}
+
+void OrderRouter::reject(const OrderAction& action, const std::string& reason) {
+    OrderEvent event = eventFor(action);
+    event.status = order::OrderStatus::REJECTED;
+    event.error = reason;
+    if (m_onOrderEvent) {
+        m_onOrderEvent(event);
+    }
+}
+
+void OrderRouter::route(const OrderAction& action) {
+    std::string reason;
+    if (!admit(action, reason)) {
+        LOG_WARN("Order action {} of strategy {} refused: {}", action.clientId, action.strategy, reason);
+        reject(action, reason);
+        return;
+    }
+
+    InFlight request;
+    request.action = action;
+    try {
+        switch (action.type) {
+            case OrderAction::Type::PLACE:
+                request.order = m_api->placeOrderAsync(
+                    action.instrument,
+                    action.side == order::OrderSide::BUY ? "buy" : "sell",
+                    action.amount,
+                    action.price,
+                    orderTypeName(action.orderType)
+                );
+                break;
+            case OrderAction::Type::CANCEL:
+                request.cancelled = m_api->cancelOrderAsync(action.orderId);
+                break;
+            case OrderAction::Type::MODIFY:
+                request.order = m_api->modifyOrderAsync(action.orderId, action.amount, action.price);
+                break;
+        }
+    } catch (const std::exception& e) {
+        reject(action, e.what());
+        return;
+    }
+    ++m_routed;
+    m_inFlight.push_back(std::move(request));
+}
+
+size_t OrderRouter::complete(bool wait) {
+    size_t completed = 0;
+    for (size_t i = 0; i < m_inFlight.size();) {
+        auto& request = m_inFlight[i];
+        bool isCancel = request.action.type == OrderAction::Type::CANCEL;
+        bool ready = wait || (isCancel
+            ? request.cancelled.wait_for(std::chrono::seconds(0)) == std::future_status::ready
+            : request.order.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        if (!ready) {
+            ++i;
+            continue;
+        }
+
+        OrderEvent event = eventFor(request.action);
+        try {
+            if (isCancel) {
+                event.status = request.cancelled.get() ? order::OrderStatus::CANCELED : order::OrderStatus::REJECTED;
+            } else {
+                api::Order result = request.order.get();
+                event.orderId = result.order_id;
+                event.instrument = result.instrument_name;
+                event.price = result.price;
+                event.amount = result.amount;
+                event.status = parseOrderState(result.order_state);
+            }
+        } catch (const std::exception& e) {
+            LOG_WARN("Order action {} of strategy {} failed: {}", request.action.clientId,
+                     request.action.strategy, e.what());
+            event.status = order::OrderStatus::REJECTED;
+            event.error = e.what();
+        }
+        if (m_onOrderEvent) {
+            m_onOrderEvent(event);
+        }
+
+        // Order does not matter, swap the last request in
+        if (i + 1 < m_inFlight.size()) {
+            request = std::move(m_inFlight.back());
+        }
+        m_inFlight.pop_back();
+        ++completed;
+    }
+    return completed;
+}
+
+} // namespace strategy
+} // namespace deribit
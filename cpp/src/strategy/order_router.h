@@ -0,0 +1,141 @@
+/**
+ * @file order_router.h
+ * @brief Order router for strategy actions
+ *
+ * This file contains the router that takes the order actions queued by
+ * strategies and sends them to the exchange on its own thread.
+ */
+
+#pragma once
+
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <string>
+#include "strategy.h"
+
+namespace deribit {
+namespace strategy {
+
+/**
+ * @class OrderRouter
+ * @brief Class sending queued order actions without blocking the strategies
+ *
+ * The router is the single consumer of an order action queue. Requests
+ * are sent asynchronously and their results are reported as OrderEvents
+ * carrying the strategy index and client ID of the action. Each action is
+ * first checked against the risk limits and throttles of the live
+ * configuration snapshot, so a reload applies from the next action on.
+ */
+class OrderRouter {
+public:
+    /**
+     * @brief Constructor
+     * @param api API client
+     * @param actions Order action queue, must outlive the router
+     */
+    OrderRouter(std::shared_ptr<api::DeribitAPI> api, OrderActionQueue& actions);
+
+    /**
+     * @brief Destructor, stops the router
+     */
+    ~OrderRouter();
+
+    // Prevent copying and assignment
+    OrderRouter(const OrderRouter&) = delete;
+    OrderRouter& operator=(const OrderRouter&) = delete;
+
+    /**
+     * @brief Set callback for request results
+     *
+     * Invoked on the router thread. Set before start().
+     *
+     * @param callback Callback function
+     */
+    void setOnOrderEvent(std::function<void(const OrderEvent&)> callback) {
+        m_onOrderEvent = std::move(callback);
+    }
+
+    /**
+     * @brief Start the router thread
+     * @return true if started, false if already running
+     */
+    bool start();
+
+    /**
+     * @brief Stop the router thread
+     *
+     * Actions still queued are dropped; requests in flight are awaited.
+     */
+    void stop();
+
+    /**
+     * @brief Get the number of actions sent
+     * @return Number of actions
+     */
+    uint64_t getRoutedCount() const { return m_routed; }
+
+private:
+    /**
+     * @struct InFlight
+     * @brief Structure for a request awaiting its result
+     */
+    struct InFlight {
+        OrderAction action;
+        std::future<api::Order> order;       // place and modify
+        std::future<bool> cancelled;         // cancel
+    };
+
+    std::shared_ptr<api::DeribitAPI> m_api;
+    OrderActionQueue& m_actions;
+    std::function<void(const OrderEvent&)> m_onOrderEvent;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64_t> m_routed{0};
+    std::vector<InFlight> m_inFlight;  // router thread only
+
+    // Throttle window, router thread only
+    std::chrono::steady_clock::time_point m_windowStart;
+    unsigned int m_ordersInWindow = 0;
+    unsigned int m_requestsInWindow = 0;
+
+    /**
+     * @brief Router thread main loop
+     */
+    void run();
+
+    /**
+     * @brief Check an action against the risk limits and throttles
+     * @param action Order action
+     * @param reason Output reason if the action is refused
+     * @return true if the action may be sent, false otherwise
+     */
+    bool admit(const OrderAction& action, std::string& reason);
+
+    /**
+     * @brief Report an action as rejected
+     * @param action Order action
+     * @param reason Rejection reason
+     */
+    void reject(const OrderAction& action, const std::string& reason);
+
+    /**
+     * @brief Send an action
+     * @param action Order action
+     */
+    void route(const OrderAction& action);
+
+    /**
+     * @brief Report the requests that completed
+     * @param wait Wait for all requests instead of only collecting finished ones
+     * @return Number of requests completed
+     */
+    size_t complete(bool wait);
+};
+
+} // namespace strategy
+} // namespace deribit
@@ -0,0 +1,52 @@
+/**
+ * @file strategy.cpp
+ * @brief Strategy event parsing
+ */
+
+#include "strategy.h"
+
+#include "../utils/arena_json.h"
+
+namespace deribit {
+namespace strategy {
+
+using utils::ArenaJson;
+
+bool parseOrderEvent(std::string_view data, OrderEvent& event) {
+    utils::ArenaScope scope;
+    const ArenaJson& parsed = utils::parseJson(data);
+    if (parsed.is_discarded() || !parsed.is_object()) {
+        return false;
+    }
+
+    event = OrderEvent();
+    event.orderId = utils::stringField(parsed, "order_id");
+    event.instrument = utils::stringField(parsed, "instrument_name");
+    event.status = parseOrderState(utils::stringField(parsed, "order_state"));
+    event.price = parsed.value("price", 0.0);
+    event.amount = parsed.value("amount", 0.0);
+    event.filledAmount = parsed.value("filled_amount", 0.0);
+    if (event.status == order::OrderStatus::OPEN && event.filledAmount > 0) {
+        event.status = order::OrderStatus::PARTIALLY_FILLED;
+    }
+    return !event.orderId.empty();
+}
+
+order::OrderStatus parseOrderState(std::string_view state) {
+    if (state == "open") {
+        return order::OrderStatus::OPEN;
+    }
+    if (state == "filled") {
+        return order::OrderStatus::FILLED;
+    }
+    if (state == "cancelled") {
+        return order::OrderStatus::CANCELED;
+    }
+    if (state == "rejected") {
+        return order::OrderStatus::REJECTED;
+    }
+    return order::OrderStatus::PENDING;  // "untriggered" and unknown states
+}
+
+} // namespace strategy
+} // namespace deribit
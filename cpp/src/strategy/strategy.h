@@ -0,0 +1,397 @@
+/**
+ * @file strategy.h
+ * @brief Strategy interface and engine
+ *
+ * This file contains the events delivered to strategies, the order
+ * actions they emit, the CRTP base class for strategies and the engine
+ * composing a fixed set of strategies at compile time.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <mutex>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include "../api/deribit_api.h"
+#include "../order/order.h"
+#include "../order/orderbook.h"
+#include "../order/trade_store.h"
+#include "../utils/spsc_queue.h"
+#include "../utils/huge_pages.h"
+
+namespace deribit {
+namespace strategy {
+
+/**
+ * @brief Strategy index meaning all strategies, for events not caused by a strategy
+ */
+constexpr uint32_t kAllStrategies = UINT32_MAX;
+
+/**
+ * @struct OrderEvent
+ * @brief Structure representing an order acknowledgement, update or rejection
+ */
+struct OrderEvent {
+    uint32_t strategy;       // strategy index, kAllStrategies for exchange notifications
+    uint64_t clientId;       // ID returned when the action was emitted, 0 if unknown
+    std::string orderId;
+    std::string instrument;
+    order::OrderStatus status;
+    double price;
+    double amount;
+    double filledAmount;
+    std::string error;       // set when the request failed
+
+    OrderEvent() :
+        strategy(kAllStrategies),
+        clientId(0),
+        status(order::OrderStatus::PENDING),
+        price(0),
+        amount(0),
+        filledAmount(0) {}
+};
+
+/**
+ * @struct OrderAction
+ * @brief Structure for an order action emitted by a strategy
+ *
+ * Trivially copyable with fixed-size names, so queueing an action never
+ * allocates.
+ */
+struct OrderAction {
+    enum class Type {
+        PLACE,
+        CANCEL,
+        MODIFY
+    };
+
+    static constexpr size_t kMaxNameLength = 63;
+
+    Type type;
+    uint32_t strategy;
+    uint64_t clientId;
+    order::OrderType orderType;
+    order::OrderSide side;
+    double price;
+    double amount;
+    char instrument[kMaxNameLength + 1];
+    char orderId[kMaxNameLength + 1];
+
+    OrderAction() :
+        type(Type::PLACE),
+        strategy(0),
+        clientId(0),
+        orderType(order::OrderType::LIMIT),
+        side(order::OrderSide::BUY),
+        price(0),
+        amount(0),
+        instrument{},
+        orderId{} {}
+
+    /**
+     * @brief Copy a name into a fixed-size field
+     * @return true if it fit, false otherwise
+     */
+    static bool setName(char (&field)[kMaxNameLength + 1], std::string_view name) {
+        if (name.size() > kMaxNameLength) {
+            return false;
+        }
+        std::memcpy(field, name.data(), name.size());
+        field[name.size()] = '\0';
+        return true;
+    }
+};
+
+using OrderActionQueue = utils::SpscQueue<OrderAction>;
+
+/**
+ * @brief Parse the data of a user.orders.* notification
+ * @param data Serialized "data" object of the notification
+ * @param event Output event
+ * @return true if parsed, false otherwise
+ */
+bool parseOrderEvent(std::string_view data, OrderEvent& event);
+
+/**
+ * @brief Map a Deribit order_state to an order status
+ * @param state Order state, e.g. "open" or "filled"
+ * @return Order status
+ */
+order::OrderStatus parseOrderState(std::string_view state);
+
+template <typename... Strategies>
+class StrategyEngine;
+
+/**
+ * @class Strategy
+ * @brief CRTP base class for strategies
+ *
+ * A strategy derives from Strategy<Itself> and hides the hooks it needs:
+ *
+ *     class Quoter : public Strategy<Quoter> {
+ *     public:
+ *         void onBookUpdate(const order::BookView& book) { ... placeOrder(...); }
+ *     };
+ *
+ * Hooks are called directly on the derived type, so there is no virtual
+ * dispatch. They run on the market data thread, or the timer thread for
+ * onTimer(), one at a time, and must not block. Order helpers only queue
+ * an action for the order router and return immediately.
+ */
+template <typename Derived>
+class Strategy {
+public:
+    /**
+     * @brief Called after a book changed; book is the live book
+     */
+    void onBookUpdate(const order::BookView&) {}
+
+    /**
+     * @brief Called for each public trade; tape holds the recent trades of the instrument
+     */
+    void onTrade(const order::TradeTape&, const order::TradeRecord&) {}
+
+    /**
+     * @brief Called for acknowledgements of this strategy's actions and for exchange order updates
+     */
+    void onOrderEvent(const OrderEvent&) {}
+
+    /**
+     * @brief Called at the engine's timer interval
+     */
+    void onTimer(std::chrono::steady_clock::time_point) {}
+
+protected:
+    /**
+     * @brief Queue a new order
+     * @param instrument Instrument name
+     * @param side Order side
+     * @param amount Amount
+     * @param price Price (ignored for market orders)
+     * @param type Order type
+     * @return Client ID reported in the resulting OrderEvent, 0 if the queue is full
+     */
+    uint64_t placeOrder(
+        std::string_view instrument,
+        order::OrderSide side,
+        double amount,
+        double price,
+        order::OrderType type = order::OrderType::LIMIT
+    ) {
+        OrderAction action = makeAction(OrderAction::Type::PLACE);
+        if (!OrderAction::setName(action.instrument, instrument)) {
+            return 0;
+        }
+        action.side = side;
+        action.amount = amount;
+        action.price = price;
+        action.orderType = type;
+        return emit(action) ? action.clientId : 0;
+    }
+
+    /**
+     * @brief Queue a cancellation
+     * @param orderId Exchange order ID
+     * @return true if queued, false if the queue is full
+     */
+    bool cancelOrder(std::string_view orderId) {
+        OrderAction action = makeAction(OrderAction::Type::CANCEL);
+        return OrderAction::setName(action.orderId, orderId) && emit(action);
+    }
+
+    /**
+     * @brief Queue a modification
+     * @param orderId Exchange order ID
+     * @param amount New amount
+     * @param price New price
+     * @return true if queued, false if the queue is full
+     */
+    bool modifyOrder(std::string_view orderId, double amount, double price) {
+        OrderAction action = makeAction(OrderAction::Type::MODIFY);
+        action.amount = amount;
+        action.price = price;
+        return OrderAction::setName(action.orderId, orderId) && emit(action);
+    }
+
+    /**
+     * @brief Get the strategy's index in its engine
+     * @return Strategy index
+     */
+    uint32_t getStrategyIndex() const { return m_index; }
+
+    Derived& derived() { return static_cast<Derived&>(*this); }
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+private:
+    template <typename... Strategies>
+    friend class StrategyEngine;
+
+    OrderActionQueue* m_actions = nullptr;
+    uint32_t m_index = 0;
+    uint64_t m_nextClientId = 0;
+
+    OrderAction makeAction(OrderAction::Type type) {
+        OrderAction action;
+        action.type = type;
+        action.strategy = m_index;
+        action.clientId = ++m_nextClientId;
+        return action;
+    }
+
+    bool emit(const OrderAction& action) {
+        return m_actions && m_actions->tryPush(action);
+    }
+};
+
+/**
+ * @class StrategyEngine
+ * @brief Class dispatching market data and order events to a fixed set of strategies
+ *
+ * The strategies are held by value and every hook is a direct call,
+ * resolved at compile time. All hooks run under one engine lock, so the
+ * strategies see a single thread at a time and the engine is the only
+ * producer of the order action queue.
+ */
+template <typename... Strategies>
+class StrategyEngine {
+public:
+    static constexpr size_t kDefaultActionCapacity = 4096;
+
+    /**
+     * @brief Constructor
+     * @param actionCapacity Capacity of the order action queue
+     * @param strategies Strategies, moved into the engine
+     */
+    explicit StrategyEngine(size_t actionCapacity = kDefaultActionCapacity, Strategies... strategies)
+        : m_strategies(std::move(strategies)...),
+          m_actions(actionCapacity, &utils::HugePageResource::getInstance()) {
+        bind(std::index_sequence_for<Strategies...>());
+    }
+
+    StrategyEngine(const StrategyEngine&) = delete;
+    StrategyEngine& operator=(const StrategyEngine&) = delete;
+
+    /**
+     * @brief Dispatch a book change, see OrderBookManager::setOnBookUpdated()
+     * @param book Changed book
+     */
+    void onBookUpdated(const order::OrderBook& book) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        book.visit([this](const order::BookView& view) {
+            forEach([&view](auto& strategy) { strategy.onBookUpdate(view); });
+        });
+    }
+
+    /**
+     * @brief Dispatch appended trades, see TradeStore::setOnTradesAppended()
+     * @param tape Trade tape
+     * @param first First new sequence number
+     * @param end One past the last new sequence number
+     */
+    void onTrades(const order::TradeTape& tape, uint64_t first, uint64_t end) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        order::TradeRecord trade;
+        for (uint64_t sequence = first; sequence < end; ++sequence) {
+            if (tape.get(sequence, trade)) {
+                forEach([&tape, &trade](auto& strategy) { strategy.onTrade(tape, trade); });
+            }
+        }
+    }
+
+    /**
+     * @brief Dispatch the order updates of a notification batch
+     *
+     * Notifications on other channels are skipped.
+     *
+     * @param msgs WebSocket messages
+     */
+    void onMessages(const std::vector<api::WSMessageView>& msgs) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& msg : msgs) {
+            if (msg.channel.compare(0, 12, "user.orders.") == 0) {
+                if (parseOrderEvent(msg.data, m_orderEvent)) {
+                    dispatchOrderEvent(m_orderEvent);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Dispatch an order event, e.g. from the order router
+     * @param event Order event
+     */
+    void onOrderEvent(const OrderEvent& event) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        dispatchOrderEvent(event);
+    }
+
+    /**
+     * @brief Dispatch a timer tick
+     * @param now Current time
+     */
+    void onTimer(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        forEach([now](auto& strategy) { strategy.onTimer(now); });
+    }
+
+    /**
+     * @brief Get the queue of actions emitted by the strategies
+     * @return Order action queue, consumed by a single thread
+     */
+    OrderActionQueue& getActions() { return m_actions; }
+
+    /**
+     * @brief Get a strategy
+     *
+     * Access outside the hooks must be synchronized by the caller.
+     *
+     * @return Strategy at index I
+     */
+    template <size_t I>
+    auto& getStrategy() { return std::get<I>(m_strategies); }
+
+    /**
+     * @brief Get the number of strategies
+     * @return Number of strategies
+     */
+    static constexpr size_t size() { return sizeof...(Strategies); }
+
+private:
+    std::tuple<Strategies...> m_strategies;
+    OrderActionQueue m_actions;
+    std::mutex m_mutex;
+
+    // Reused parse buffer, guarded by m_mutex
+    OrderEvent m_orderEvent;
+
+    template <size_t... I>
+    void bind(std::index_sequence<I...>) {
+        ((std::get<I>(m_strategies).m_actions = &m_actions,
+          std::get<I>(m_strategies).m_index = static_cast<uint32_t>(I)), ...);
+    }
+
+    template <typename Function>
+    void forEach(Function&& function) {
+        std::apply([&function](auto&... strategies) { (function(strategies), ...); }, m_strategies);
+    }
+
+    void dispatchOrderEvent(const OrderEvent& event) {
+        dispatchOrderEvent(event, std::index_sequence_for<Strategies...>());
+    }
+
+    template <size_t... I>
+    void dispatchOrderEvent(const OrderEvent& event, std::index_sequence<I...>) {
+        ((event.strategy == I || event.strategy == kAllStrategies
+              ? std::get<I>(m_strategies).onOrderEvent(event)
+              : void()), ...);
+    }
+};
+
+} // namespace strategy
+} // namespace deribit
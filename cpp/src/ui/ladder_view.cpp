@@ -0,0 +1,157 @@
+/**
+ * @file ladder_view.cpp
+ * @brief Depth ladder view implementation
+ */
+
+#include "ladder_view.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace deribit {
+namespace ui {
+
+namespace {
+
+const char* const kAskColor = "\x1b[31m";
+const char* const kBidColor = "\x1b[32m";
+const char* const kResetColor = "\x1b[0m";
+
+size_t terminalWidth() {
+#ifdef __linux__
+    winsize size{};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) {
+        return size.ws_col;
+    }
+#endif
+    return 120;
+}
+
+void appendCursor(std::string& out, size_t row, size_t column) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "\x1b[%zu;%zuH", row + 1, column + 1);
+    out.append(buffer, static_cast<size_t>(length));
+}
+
+} // namespace
+
+LadderView::LadderView(size_t levels)
+    : m_levels(std::max<size_t>(1, std::min(levels, order::BookDepth::kMaxLevels))),
+      m_rowsUsed(0),
+      m_clear(true) {}
+
+void LadderView::setInstruments(const std::vector<std::string>& instruments) {
+    size_t columns = std::max<size_t>(1, terminalWidth() / kPanelWidth);
+    size_t panelHeight = 2 * m_levels + 2;  // header, levels, blank separator
+
+    m_panels.assign(instruments.size(), Panel());
+    for (size_t i = 0; i < instruments.size(); ++i) {
+        Panel& panel = m_panels[i];
+        panel.instrument = instruments[i];
+        panel.lines.resize(2 * m_levels + 1);
+
+        size_t top = (i / columns) * panelHeight;
+        size_t left = (i % columns) * kPanelWidth;
+        for (size_t line = 0; line < panel.lines.size(); ++line) {
+            panel.lines[line].row = top + line;
+            panel.lines[line].column = left;
+        }
+
+        char header[kPanelWidth + 16];
+        std::snprintf(header, sizeof(header), "\x1b[1m%-*.*s%s",
+                      static_cast<int>(kPanelWidth - 1), static_cast<int>(kPanelWidth - 1),
+                      panel.instrument.c_str(), kResetColor);
+        panel.lines[0].text = header;
+        for (size_t line = 1; line < panel.lines.size(); ++line) {
+            formatLevel(panel.lines[line], nullptr, kResetColor);
+        }
+    }
+
+    m_rowsUsed = ((instruments.size() + columns - 1) / columns) * panelHeight;
+    m_status.row = m_rowsUsed;
+    m_status.column = 0;
+    m_status.drawn.clear();
+    m_clear = true;
+}
+
+void LadderView::update(size_t panel, const order::BookDepth& depth) {
+    if (panel >= m_panels.size()) {
+        return;
+    }
+    auto& lines = m_panels[panel].lines;
+
+    // Asks are drawn deepest first, so the best ask sits right above the best bid
+    for (size_t i = 0; i < m_levels; ++i) {
+        size_t level = m_levels - 1 - i;
+        formatLevel(lines[1 + i], depth.valid && level < depth.askCount ? &depth.asks[level] : nullptr,
+                    kAskColor);
+    }
+    for (size_t i = 0; i < m_levels; ++i) {
+        formatLevel(lines[1 + m_levels + i], depth.valid && i < depth.bidCount ? &depth.bids[i] : nullptr,
+                    kBidColor);
+    }
+}
+
+void LadderView::setStatus(const std::string& status) {
+    m_status.text = status;
+}
+
+size_t LadderView::flush(std::string& out) {
+    if (m_clear) {
+        out.append("\x1b[2J");
+        for (auto& panel : m_panels) {
+            for (auto& line : panel.lines) {
+                line.drawn.clear();
+            }
+        }
+        m_status.drawn.clear();
+        m_clear = false;
+    }
+
+    size_t written = 0;
+    for (auto& panel : m_panels) {
+        for (auto& line : panel.lines) {
+            written += drawLine(line, false, out) ? 1 : 0;
+        }
+    }
+    written += drawLine(m_status, true, out) ? 1 : 0;
+
+    if (written > 0) {
+        // Park the cursor below the view
+        appendCursor(out, m_rowsUsed + 1, 0);
+    }
+    return written;
+}
+
+void LadderView::formatLevel(Line& line, const order::PriceLevel* level, const char* color) {
+    char buffer[64];
+    if (level) {
+        std::snprintf(buffer, sizeof(buffer), "%s%14.4f %14.2f%s  ",
+                      color, level->price, level->amount, kResetColor);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%s%14s %14s%s  ", color, "-", "-", kResetColor);
+    }
+    line.text = buffer;
+}
+
+bool LadderView::drawLine(Line& line, bool eraseTail, std::string& out) {
+    if (line.text == line.drawn) {
+        return false;
+    }
+    appendCursor(out, line.row, line.column);
+    out.append(line.text);
+    if (eraseTail) {
+        // Panel lines have a fixed width; the status line does not
+        out.append("\x1b[K");
+    }
+    line.drawn = line.text;
+    return true;
+}
+
+} // namespace ui
+} // namespace deribit
@@ -0,0 +1,121 @@
+/**
+ * @file ladder_view.h
+ * @brief Depth ladder view with incremental redraw
+ *
+ * This file contains the depth ladder shown by the terminal UI. It keeps
+ * the text last drawn on every line and only rewrites the lines whose
+ * price levels changed.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "../order/orderbook.h"
+
+namespace deribit {
+namespace ui {
+
+/**
+ * @class LadderView
+ * @brief Class laying out one depth ladder panel per instrument
+ *
+ * Panels are laid out in a grid that fits the terminal width. Each panel
+ * has a header line, the asks from the deepest down to the best, and the
+ * bids from the best down to the deepest, so the spread is in the middle.
+ *
+ * Not thread-safe; owned by the render thread.
+ */
+class LadderView {
+public:
+    static constexpr size_t kPanelWidth = 32;
+
+    /**
+     * @brief Constructor
+     * @param levels Levels shown per side, at most order::BookDepth::kMaxLevels
+     */
+    explicit LadderView(size_t levels);
+
+    /**
+     * @brief Set the instruments shown, one panel each
+     *
+     * Lays the panels out again; the next flush() clears the screen and
+     * draws everything.
+     *
+     * @param instruments Instrument names
+     */
+    void setInstruments(const std::vector<std::string>& instruments);
+
+    /**
+     * @brief Update the levels of a panel
+     * @param panel Panel index, in the order passed to setInstruments()
+     * @param depth Published book depth
+     */
+    void update(size_t panel, const order::BookDepth& depth);
+
+    /**
+     * @brief Set the status line below the panels
+     * @param status Status text
+     */
+    void setStatus(const std::string& status);
+
+    /**
+     * @brief Append the terminal output for the lines changed since the last flush
+     * @param out Output buffer
+     * @return Number of lines written
+     */
+    size_t flush(std::string& out);
+
+    /**
+     * @brief Get the number of levels shown per side
+     * @return Levels
+     */
+    size_t getLevels() const { return m_levels; }
+
+private:
+    /**
+     * @struct Line
+     * @brief Structure for a screen line, with the text last drawn there
+     */
+    struct Line {
+        size_t row = 0;
+        size_t column = 0;
+        std::string text;
+        std::string drawn;
+    };
+
+    /**
+     * @struct Panel
+     * @brief Structure for an instrument panel
+     */
+    struct Panel {
+        std::string instrument;
+        std::vector<Line> lines;  // header, asks, bids
+    };
+
+    size_t m_levels;
+    size_t m_rowsUsed;
+    std::vector<Panel> m_panels;
+    Line m_status;
+    bool m_clear;
+
+    /**
+     * @brief Format a price level into a line's text
+     * @param line Output line
+     * @param level Price level, or nullptr for an empty level
+     * @param color ANSI color sequence
+     */
+    static void formatLevel(Line& line, const order::PriceLevel* level, const char* color);
+
+    /**
+     * @brief Append a line if its text changed
+     * @param line Line
+     * @param eraseTail Clear the rest of the terminal line after the text
+     * @param out Output buffer
+     * @return true if written, false otherwise
+     */
+    static bool drawLine(Line& line, bool eraseTail, std::string& out);
+};
+
+} // namespace ui
+} // namespace deribit
@@ -0,0 +1,370 @@
+/**
+ * @file terminal_ui.cpp
+ * @brief Terminal user interface implementation
+ */
+
+#include "terminal_ui.h"
+#include "../utils/config.h"
+#include "../utils/logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+#include <ftxui/dom/elements.hpp>
+#include <ftxui/screen/screen.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace deribit {
+namespace ui {
+
+namespace {
+
+// Books are looked up by name under the book manager's lock, so the
+// render thread does it rarely; it picks up replaced books within this
+const std::chrono::seconds kResolveInterval{1};
+
+// Window of the trade statistics in the top view
+const int64_t kTradeWindowMs = 60000;
+
+std::string formatNumber(double value, int precision) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+    return buffer;
+}
+
+ftxui::Element cell(const std::string& value, int width) {
+    return ftxui::text(value) | ftxui::size(ftxui::WIDTH, ftxui::EQUAL, width);
+}
+
+} // namespace
+
+UIConfig UIConfig::fromConfig(const utils::Config& config) {
+    UIConfig result;
+    result.enabled = config.getBool("ui.enabled", result.enabled);
+    result.view = config.getString("ui.view", result.view);
+    result.frameRate = std::max(1u, config.getUInt("ui.frame_rate", result.frameRate));
+    result.cpu = static_cast<int>(config.getDouble("ui.cpu", result.cpu));
+    result.maxInstruments = config.getUInt(
+        "ui.max_instruments",
+        static_cast<unsigned int>(result.maxInstruments)
+    );
+    result.ladderLevels = config.getUInt(
+        "ui.ladder_levels",
+        static_cast<unsigned int>(result.ladderLevels)
+    );
+    result.instruments = config.getStringList("ui.instruments");
+    return result;
+}
+
+void TerminalUI::displayWelcomeMessage() {
+    using namespace ftxui;
+    auto document = vbox({
+        text("Deribit Trading System") | bold | center,
+        separator(),
+        text("Order management and market data for Deribit") | center,
+        text("Press Ctrl+C to exit") | dim | center,
+    }) | border;
+    auto screen = Screen::Create(Dimension::Full(), Dimension::Fit(document));
+    Render(screen, document);
+    std::cout << screen.ToString() << std::endl;
+}
+
+TerminalUI::TerminalUI(const UIConfig& config)
+    : m_config(config),
+      m_pendingInstruments(config.instruments),
+      m_instrumentsChanged(true),
+      m_seenDepthChanges(0) {
+    m_config.frameRate = std::max(1u, m_config.frameRate);
+    if (m_config.view == "ladder") {
+        m_ladder = std::make_unique<LadderView>(m_config.ladderLevels);
+        m_depthChanges = std::make_shared<std::atomic<uint64_t>>(0);
+    } else if (m_config.view != "top") {
+        LOG_WARN("Unknown UI view '{}', showing the top of book", m_config.view);
+    }
+}
+
+TerminalUI::~TerminalUI() {
+    stop();
+}
+
+void TerminalUI::setInstruments(const std::vector<std::string>& instruments) {
+    if (!m_config.instruments.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_instrumentsMutex);
+    m_pendingInstruments = instruments;
+    m_instrumentsChanged = true;
+}
+
+bool TerminalUI::start() {
+    if (!m_config.enabled || m_running.exchange(true)) {
+        return false;
+    }
+    m_thread = std::thread(&TerminalUI::run, this);
+    return true;
+}
+
+void TerminalUI::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        if (!m_running.exchange(false)) {
+            return;
+        }
+    }
+    m_stopCondition.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void TerminalUI::run() {
+    configureThread();
+
+    const auto framePeriod = std::chrono::microseconds(1000000 / m_config.frameRate);
+    auto nextFrame = std::chrono::steady_clock::now();
+    bool dirty = true;
+
+    while (m_running) {
+        auto now = std::chrono::steady_clock::now();
+        resolveBooks(now);
+        dirty = (m_ladder ? collectDepth() : collect()) || dirty;
+        if (dirty) {
+            if (m_ladder) {
+                renderLadder();
+            } else {
+                render();
+            }
+            ++m_frames;
+            dirty = false;
+        }
+
+        // Fixed cadence; frames missed while the thread was descheduled are dropped
+        nextFrame += framePeriod;
+        if (nextFrame < now) {
+            nextFrame = now + framePeriod;
+        }
+        std::unique_lock<std::mutex> lock(m_stopMutex);
+        m_stopCondition.wait_until(lock, nextFrame, [this]() { return !m_running; });
+    }
+
+    for (auto& row : m_rows) {
+        watchRow(row, false);
+    }
+}
+
+void TerminalUI::configureThread() {
+#ifdef __linux__
+    pthread_setname_np(pthread_self(), "terminal-ui");
+
+    if (m_config.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(m_config.cpu, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+            LOG_WARN("Failed to pin the UI thread to CPU {}", m_config.cpu);
+        }
+    }
+
+    // Only runs when the trading threads leave a core idle
+    sched_param param{};
+    if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) != 0) {
+        LOG_WARN("Failed to lower the UI thread priority");
+    }
+#endif
+}
+
+void TerminalUI::resolveBooks(std::chrono::steady_clock::time_point now) {
+    {
+        std::lock_guard<std::mutex> lock(m_instrumentsMutex);
+        if (m_instrumentsChanged) {
+            for (auto& row : m_rows) {
+                watchRow(row, false);
+            }
+            size_t count = std::min(m_pendingInstruments.size(), m_config.maxInstruments);
+            m_rows.assign(count, Row());
+            for (size_t i = 0; i < count; ++i) {
+                m_rows[i].instrument = m_pendingInstruments[i];
+            }
+            if (m_ladder) {
+                std::vector<std::string> names(m_pendingInstruments.begin(), m_pendingInstruments.begin() + count);
+                m_ladder->setInstruments(names);
+            }
+            m_instrumentsChanged = false;
+            m_lastResolve = std::chrono::steady_clock::time_point();
+        }
+    }
+
+    if (now - m_lastResolve < kResolveInterval) {
+        return;
+    }
+    m_lastResolve = now;
+
+    auto& books = order::OrderBookManager::getInstance();
+    auto& trades = order::TradeStore::getInstance();
+    for (auto& row : m_rows) {
+        // Also rolls the trade window forward when no trade arrives
+        row.tape = trades.getTape(row.instrument);
+        row.tradeCount = 0;
+
+        auto book = books.getBook(row.instrument);
+        if (book != row.book) {
+            watchRow(row, false);
+            row.book = std::move(book);
+            row.version = 0;
+            row.depthVersion = 0;
+            row.top = order::BookTop();
+            watchRow(row, true);
+        }
+    }
+}
+
+void TerminalUI::watchRow(Row& row, bool watch) {
+    if (!m_ladder || !row.book) {
+        return;
+    }
+    if (watch) {
+        row.book->watchDepth(m_ladder->getLevels(), m_depthChanges);
+    } else {
+        row.book->watchDepth(0, nullptr);
+    }
+}
+
+bool TerminalUI::collect() {
+    bool changed = false;
+    for (auto& row : m_rows) {
+        if (!row.book) {
+            continue;
+        }
+        uint64_t version = row.book->getTopVersion();
+        if (version != row.version) {
+            row.version = version;
+            row.top = row.book->getTop();
+            changed = true;
+        }
+    }
+
+    for (auto& row : m_rows) {
+        if (!row.tape) {
+            continue;
+        }
+        uint64_t count = row.tape->getCount();
+        if (count != row.tradeCount && row.tape->get(count - 1, row.lastTrade)) {
+            row.tradeCount = count;
+            auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            row.minuteStats = row.tape->getStatsSince(now - kTradeWindowMs);
+            changed = true;
+        }
+    }
+
+    auto metrics = utils::Metrics::getInstance().getSnapshot();
+    if (metrics.updatedAtMs != m_metrics.updatedAtMs) {
+        m_metrics = metrics;
+        changed = true;
+    }
+    return changed;
+}
+
+bool TerminalUI::collectDepth() {
+    // Read the counter before the versions, so a change published while
+    // scanning is picked up no later than the next frame
+    uint64_t changes = m_depthChanges->load(std::memory_order_acquire);
+    bool changed = false;
+    if (changes != m_seenDepthChanges) {
+        m_seenDepthChanges = changes;
+        for (size_t i = 0; i < m_rows.size(); ++i) {
+            auto& row = m_rows[i];
+            if (!row.book) {
+                continue;
+            }
+            uint64_t version = row.book->getDepthVersion();
+            if (version != row.depthVersion) {
+                row.depthVersion = version;
+                m_ladder->update(i, row.book->getDepth());
+                changed = true;
+            }
+        }
+    }
+
+    auto metrics = utils::Metrics::getInstance().getSnapshot();
+    if (metrics.updatedAtMs != m_metrics.updatedAtMs) {
+        m_metrics = metrics;
+        changed = true;
+    }
+    return changed;
+}
+
+void TerminalUI::render() {
+    using namespace ftxui;
+
+    Elements rows;
+    rows.push_back(hbox({
+        cell("Instrument", 24), cell("Bid size", 12), cell("Bid", 12),
+        cell("Ask", 12), cell("Ask size", 12), cell("Last", 12),
+        cell("1m volume", 12), cell("1m imbal", 10), cell("Change ID", 14),
+    }) | bold);
+    rows.push_back(separator());
+
+    for (const auto& row : m_rows) {
+        const auto& top = row.top;
+        if (!top.valid) {
+            rows.push_back(hbox({cell(row.instrument, 24), text("waiting for snapshot") | dim}));
+            continue;
+        }
+        rows.push_back(hbox({
+            cell(row.instrument, 24),
+            cell(top.hasBid ? formatNumber(top.bid.amount, 2) : "-", 12),
+            cell(top.hasBid ? formatNumber(top.bid.price, 4) : "-", 12) | color(Color::Green),
+            cell(top.hasAsk ? formatNumber(top.ask.price, 4) : "-", 12) | color(Color::Red),
+            cell(top.hasAsk ? formatNumber(top.ask.amount, 2) : "-", 12),
+            cell(row.tradeCount > 0 ? formatNumber(row.lastTrade.price, 4) : "-", 12),
+            cell(formatNumber(row.minuteStats.volume, 2), 12),
+            cell(formatNumber(row.minuteStats.imbalance, 2), 10),
+            cell(std::to_string(top.changeId), 14),
+        }));
+    }
+
+    const auto& metrics = m_metrics;
+    auto document = vbox({
+        vbox(std::move(rows)) | border,
+        hbox({
+            text("Market data: " + formatNumber(metrics.marketDataRate, 0) + "/s"),
+            filler(),
+            text("Place p50/p99: " + formatNumber(metrics.orderPlacement.p50, 2) + "/" +
+                 formatNumber(metrics.orderPlacement.p99, 2) + " ms"),
+            filler(),
+            text("Cancel p50/p99: " + formatNumber(metrics.orderCancellation.p50, 2) + "/" +
+                 formatNumber(metrics.orderCancellation.p99, 2) + " ms"),
+            filler(),
+            text("Stale: " + std::to_string(metrics.staleConnections)),
+        }),
+    });
+
+    auto screen = Screen::Create(Dimension::Full(), Dimension::Fit(document));
+    Render(screen, document);
+    std::cout << m_resetPosition << screen.ToString() << std::flush;
+    m_resetPosition = screen.ResetPosition();
+}
+
+void TerminalUI::renderLadder() {
+    m_ladder->setStatus(
+        "Market data: " + formatNumber(m_metrics.marketDataRate, 0) + "/s  " +
+        "Place p50/p99: " + formatNumber(m_metrics.orderPlacement.p50, 2) + "/" +
+        formatNumber(m_metrics.orderPlacement.p99, 2) + " ms  " +
+        "Stale: " + std::to_string(m_metrics.staleConnections)
+    );
+
+    m_output.clear();
+    if (m_ladder->flush(m_output) > 0) {
+        std::cout.write(m_output.data(), static_cast<std::streamsize>(m_output.size()));
+        std::cout.flush();
+    }
+}
+
+} // namespace ui
+} // namespace deribit
@@ -0,0 +1,222 @@
+/**
+ * @file terminal_ui.h
+ * @brief Terminal user interface
+ *
+ * This file contains the terminal UI. The live view renders on its own
+ * thread at a capped frame rate from lock-free snapshots, so drawing the
+ * terminal never takes locks held by the order or market data path. It
+ * shows either the top of book of each instrument or a depth ladder per
+ * instrument.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "../order/orderbook.h"
+#include "../order/trade_store.h"
+#include "../utils/metrics.h"
+#include "ladder_view.h"
+
+namespace deribit {
+
+namespace utils {
+class Config;
+} // namespace utils
+
+namespace ui {
+
+/**
+ * @struct UIConfig
+ * @brief Structure for the live view settings
+ */
+struct UIConfig {
+    bool enabled;
+    std::string view;                      // "top" or "ladder"
+    unsigned int frameRate;                // maximum frames per second
+    int cpu;                               // core the render thread is pinned to, -1 for none
+    size_t maxInstruments;                 // rows or ladders shown at most
+    size_t ladderLevels;                   // levels per side in the ladder view
+    std::vector<std::string> instruments;  // instruments shown, empty for the subscribed ones
+
+    UIConfig() :
+        enabled(true),
+        view("top"),
+        frameRate(10),
+        cpu(-1),
+        maxInstruments(20),
+        ladderLevels(5) {}
+
+    /**
+     * @brief Build from the "ui" section of the configuration
+     * @param config Configuration
+     * @return UI configuration
+     */
+    static UIConfig fromConfig(const utils::Config& config);
+};
+
+/**
+ * @class TerminalUI
+ * @brief Class for rendering the terminal UI
+ *
+ * The live view shows the top of book of the selected instruments and the
+ * headline metrics. The render thread runs at a low scheduling priority,
+ * optionally pinned to a non-critical core, and reads only
+ * OrderBook::getTop() and Metrics::getSnapshot(). Frames in which no
+ * snapshot changed are skipped.
+ *
+ * The ladder view watches the depth of the shown books instead. Books
+ * bump a shared counter when their watched levels change, so an idle
+ * frame costs one atomic load, and only the lines of changed levels are
+ * rewritten on the terminal.
+ */
+class TerminalUI {
+public:
+    /**
+     * @brief Display the welcome message
+     */
+    static void displayWelcomeMessage();
+
+    /**
+     * @brief Constructor
+     * @param config UI configuration
+     */
+    explicit TerminalUI(const UIConfig& config = UIConfig());
+
+    /**
+     * @brief Destructor, stops the render thread
+     */
+    ~TerminalUI();
+
+    // Prevent copying and assignment
+    TerminalUI(const TerminalUI&) = delete;
+    TerminalUI& operator=(const TerminalUI&) = delete;
+
+    /**
+     * @brief Set the instruments shown
+     *
+     * Ignored if instruments are set in the configuration. At most
+     * maxInstruments are shown. May be called from any thread.
+     *
+     * @param instruments Instrument names
+     */
+    void setInstruments(const std::vector<std::string>& instruments);
+
+    /**
+     * @brief Start the render thread
+     * @return true if started, false if disabled or already running
+     */
+    bool start();
+
+    /**
+     * @brief Stop the render thread
+     */
+    void stop();
+
+    /**
+     * @brief Check whether the render thread is running
+     * @return true if running, false otherwise
+     */
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief Get the number of frames drawn
+     * @return Frame count
+     */
+    uint64_t getFrameCount() const { return m_frames; }
+
+private:
+    /**
+     * @struct Row
+     * @brief Structure for an instrument row, owned by the render thread
+     */
+    struct Row {
+        std::string instrument;
+        std::shared_ptr<order::OrderBook> book;
+        uint64_t version = 0;
+        uint64_t depthVersion = 0;
+        order::BookTop top;
+        std::shared_ptr<order::TradeTape> tape;
+        uint64_t tradeCount = 0;
+        order::TradeRecord lastTrade;
+        order::TradeStats minuteStats;
+    };
+
+    UIConfig m_config;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64_t> m_frames{0};
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCondition;
+
+    std::vector<std::string> m_pendingInstruments;
+    bool m_instrumentsChanged;
+    std::mutex m_instrumentsMutex;
+
+    // Render thread state
+    std::vector<Row> m_rows;
+    utils::MetricsSnapshot m_metrics;
+    std::chrono::steady_clock::time_point m_lastResolve;
+    std::string m_resetPosition;
+
+    // Ladder view state
+    std::unique_ptr<LadderView> m_ladder;
+    std::shared_ptr<std::atomic<uint64_t>> m_depthChanges;
+    uint64_t m_seenDepthChanges;
+    std::string m_output;
+
+    /**
+     * @brief Render thread main loop
+     */
+    void run();
+
+    /**
+     * @brief Pin the render thread and lower its priority
+     */
+    void configureThread();
+
+    /**
+     * @brief Pick up instrument changes and look up their books
+     * @param now Current time
+     */
+    void resolveBooks(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Start or stop watching the depth of a row's book
+     * @param row Row
+     * @param watch true to watch, false to stop
+     */
+    void watchRow(Row& row, bool watch);
+
+    /**
+     * @brief Copy the snapshots that changed since the last frame
+     * @return true if anything changed, false otherwise
+     */
+    bool collect();
+
+    /**
+     * @brief Copy the depth of the books that changed since the last frame
+     * @return true if anything changed, false otherwise
+     */
+    bool collectDepth();
+
+    /**
+     * @brief Draw a frame
+     */
+    void render();
+
+    /**
+     * @brief Draw the changed lines of the ladder view
+     */
+    void renderLadder();
+};
+
+} // namespace ui
+} // namespace deribit
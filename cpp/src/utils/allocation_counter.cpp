@@ -0,0 +1,75 @@
+/**
+ * @file allocation_counter.cpp
+ * @brief Counting replacements of the global allocation functions
+ */
+
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local uint64_t t_allocations = 0;
+
+void* allocate(std::size_t size) {
+    ++t_allocations;
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    ++t_allocations;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc requires a size multiple of the alignment
+    void* memory = std::aligned_alloc(align, (size + align - 1) / align * align);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+} // namespace
+
+namespace deribit {
+namespace utils {
+
+uint64_t AllocationCounter::getThreadCount() {
+    return t_allocations;
+}
+
+} // namespace utils
+} // namespace deribit
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
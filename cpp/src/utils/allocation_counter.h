@@ -0,0 +1,32 @@
+/**
+ * @file allocation_counter.h
+ * @brief Heap allocation counting for benchmarks
+ *
+ * Linking allocation_counter.cpp replaces the global operator new and
+ * operator delete with versions that count allocations per thread, so a
+ * benchmark can check that a code path does not touch the heap. Only the
+ * benchmarks link it; the trading system keeps the default allocator.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @class AllocationCounter
+ * @brief Class reading the heap allocation count of the calling thread
+ */
+class AllocationCounter {
+public:
+    /**
+     * @brief Get the number of operator new calls made by the calling thread
+     * @return Allocation count since the thread started
+     */
+    static uint64_t getThreadCount();
+};
+
+} // namespace utils
+} // namespace deribit
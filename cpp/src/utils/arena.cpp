@@ -0,0 +1,58 @@
+/**
+ * @file arena.cpp
+ * @brief Arena allocator implementation
+ */
+
+#include "arena.h"
+
+#include <algorithm>
+
+namespace deribit {
+namespace utils {
+
+Arena::Arena(size_t chunkSize)
+    : m_chunkSize(chunkSize), m_current(0), m_offset(0) {}
+
+Arena::~Arena() = default;
+
+void Arena::rewind(const Mark& mark) {
+    m_stats.highWater = std::max(m_stats.highWater, m_stats.used);
+    m_stats.used = mark.used;
+    if (mark.used == 0) {
+        ++m_stats.resets;
+    }
+    m_current = mark.chunk;
+    m_offset = mark.offset;
+}
+
+Arena& Arena::local() {
+    thread_local Arena arena;
+    return arena;
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    // Carve from the current chunk, then from the chunks kept from earlier batches
+    while (m_current < m_chunks.size()) {
+        Chunk& chunk = m_chunks[m_current];
+        size_t begin = (reinterpret_cast<uintptr_t>(chunk.memory.get()) + m_offset + alignment - 1) & ~(alignment - 1);
+        size_t offset = begin - reinterpret_cast<uintptr_t>(chunk.memory.get());
+        if (offset + bytes <= chunk.size) {
+            m_offset = offset + bytes;
+            m_stats.used += bytes;
+            return chunk.memory.get() + offset;
+        }
+        ++m_current;
+        m_offset = 0;
+    }
+
+    size_t size = std::max(m_chunkSize, bytes + alignment);
+    m_chunks.push_back(Chunk{std::make_unique_for_overwrite<std::byte[]>(size), size});
+    m_stats.capacity += size;
+    ++m_stats.chunks;
+    m_current = m_chunks.size() - 1;
+    m_offset = 0;
+    return do_allocate(bytes, alignment);
+}
+
+} // namespace utils
+} // namespace deribit
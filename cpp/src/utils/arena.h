@@ -0,0 +1,180 @@
+/**
+ * @file arena.h
+ * @brief Per-thread bump allocator for transient objects
+ *
+ * This file contains the arena that per-message work allocates from
+ * through std::pmr, and the allocator bound to the arena of the calling
+ * thread. The arena is rewound after each message and each message
+ * batch, so once it has grown to the size of the largest batch, parsing
+ * messages no longer touches the heap.
+ */
+
+#pragma once
+
+#include <memory_resource>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @class Arena
+ * @brief Class for a bump allocator rewound as a whole
+ *
+ * Allocations are carved from chunks obtained from the heap; deallocate()
+ * is a no-op and reset() makes all chunks available again. Chunks are
+ * kept until the arena is destroyed. Not thread-safe: each thread uses
+ * its own arena, see local().
+ */
+class Arena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kDefaultChunkSize = 256 * 1024;
+
+    /**
+     * @struct Stats
+     * @brief Structure for arena counters
+     */
+    struct Stats {
+        size_t used = 0;            // bytes allocated since the last reset
+        size_t highWater = 0;       // largest use between resets
+        size_t capacity = 0;        // bytes held in chunks
+        uint64_t chunks = 0;        // chunks taken from the heap
+        uint64_t resets = 0;
+    };
+
+    /**
+     * @brief Constructor
+     * @param chunkSize Size of each chunk; larger allocations get a chunk of their own
+     */
+    explicit Arena(size_t chunkSize = kDefaultChunkSize);
+
+    ~Arena() override;
+
+    // Prevent copying and assignment
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @struct Mark
+     * @brief Structure for a position in the arena to rewind to
+     */
+    struct Mark {
+        size_t chunk = 0;
+        size_t offset = 0;
+        size_t used = 0;
+    };
+
+    /**
+     * @brief Get the current position
+     * @return Mark for rewind()
+     */
+    Mark getMark() const { return Mark{m_current, m_offset, m_stats.used}; }
+
+    /**
+     * @brief Make the memory allocated since a mark available again
+     *
+     * Everything allocated since the mark must be destroyed first.
+     *
+     * @param mark Mark from getMark()
+     */
+    void rewind(const Mark& mark);
+
+    /**
+     * @brief Make all memory available again
+     *
+     * Everything allocated from the arena must be destroyed first.
+     */
+    void reset() { rewind(Mark()); }
+
+    /**
+     * @brief Get the arena counters
+     * @return Counters
+     */
+    const Stats& getStats() const { return m_stats; }
+
+    /**
+     * @brief Get the arena of the calling thread
+     * @return Arena, created on first use
+     */
+    static Arena& local();
+
+private:
+    /**
+     * @struct Chunk
+     * @brief Structure for a block of memory carved by the arena
+     */
+    struct Chunk {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size;
+    };
+
+    size_t m_chunkSize;
+    std::vector<Chunk> m_chunks;
+    size_t m_current;       // chunk being carved
+    size_t m_offset;        // next free byte in the current chunk
+    Stats m_stats;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+/**
+ * @class ArenaAllocator
+ * @brief Class for a polymorphic allocator defaulting to the thread's arena
+ *
+ * Containers that default-construct their allocators, such as the JSON
+ * parser's, allocate from Arena::local() of the thread creating them.
+ */
+template <typename T>
+class ArenaAllocator : public std::pmr::polymorphic_allocator<T> {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept : std::pmr::polymorphic_allocator<T>(&Arena::local()) {}
+    ArenaAllocator(std::pmr::memory_resource* resource) noexcept : std::pmr::polymorphic_allocator<T>(resource) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : std::pmr::polymorphic_allocator<T>(other.resource()) {}
+
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U>;
+    };
+
+    // Copies of a container allocate from the arena of the copying thread
+    ArenaAllocator select_on_container_copy_construction() const noexcept { return ArenaAllocator(); }
+};
+
+/**
+ * @brief String allocated from the thread's arena
+ */
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+/**
+ * @class ArenaScope
+ * @brief Class rewinding the thread's arena when leaving a scope
+ *
+ * Memory allocated from Arena::local() inside the scope is reclaimed on
+ * exit; scopes nest, so a message parsed inside a batch scope gives its
+ * memory back as soon as it is handled.
+ */
+class ArenaScope {
+public:
+    ArenaScope() : m_arena(Arena::local()), m_mark(m_arena.getMark()) {}
+    ~ArenaScope() { m_arena.rewind(m_mark); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena& m_arena;
+    Arena::Mark m_mark;
+};
+
+} // namespace utils
+} // namespace deribit
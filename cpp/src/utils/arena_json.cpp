@@ -0,0 +1,321 @@
+/**
+ * @file arena_json.cpp
+ * @brief JSON reader building documents in the thread's arena
+ */
+
+#include "arena_json.h"
+
+#include <charconv>
+#include <new>
+
+namespace deribit {
+namespace utils {
+
+namespace {
+
+constexpr int kMaxDepth = 256;
+
+/**
+ * @class Reader
+ * @brief Class for a recursive descent JSON reader
+ *
+ * Accepts RFC 8259 JSON like nlohmann::json::parse(). Non-negative
+ * integers are stored unsigned and negative ones signed, as nlohmann
+ * does, and a repeated object key keeps its last value.
+ */
+class Reader {
+public:
+    explicit Reader(std::string_view text) : m_pos(text.data()), m_end(text.data() + text.size()) {}
+
+    bool parseDocument(ArenaJson& value) {
+        if (!parseValue(value, 0)) {
+            return false;
+        }
+        skipWhitespace();
+        return m_pos == m_end;
+    }
+
+private:
+    const char* m_pos;
+    const char* m_end;
+
+    void skipWhitespace() {
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t')) {
+            ++m_pos;
+        }
+    }
+
+    bool consume(char c) {
+        skipWhitespace();
+        if (m_pos < m_end && *m_pos == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool consumeLiteral(std::string_view literal) {
+        if (static_cast<size_t>(m_end - m_pos) < literal.size() ||
+            std::string_view(m_pos, literal.size()) != literal) {
+            return false;
+        }
+        m_pos += literal.size();
+        return true;
+    }
+
+    bool parseValue(ArenaJson& value, int depth) {
+        skipWhitespace();
+        if (m_pos == m_end) {
+            return false;
+        }
+        switch (*m_pos) {
+            case '{':
+                return parseObject(value, depth + 1);
+            case '[':
+                return parseArray(value, depth + 1);
+            case '"': {
+                value = ArenaJson(ArenaJson::value_t::string);
+                return parseString(value.get_ref<ArenaJson::string_t&>());
+            }
+            case 't':
+                value = true;
+                return consumeLiteral("true");
+            case 'f':
+                value = false;
+                return consumeLiteral("false");
+            case 'n':
+                value = nullptr;
+                return consumeLiteral("null");
+            default:
+                return parseNumber(value);
+        }
+    }
+
+    bool parseObject(ArenaJson& value, int depth) {
+        if (depth > kMaxDepth) {
+            return false;
+        }
+        ++m_pos;
+        value = ArenaJson(ArenaJson::value_t::object);
+        auto& object = value.get_ref<ArenaJson::object_t&>();
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            skipWhitespace();
+            ArenaString key;
+            if (m_pos == m_end || *m_pos != '"' || !parseString(key) || !consume(':')) {
+                return false;
+            }
+            if (!parseValue(object[std::move(key)], depth)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}');
+    }
+
+    bool parseArray(ArenaJson& value, int depth) {
+        if (depth > kMaxDepth) {
+            return false;
+        }
+        ++m_pos;
+        value = ArenaJson(ArenaJson::value_t::array);
+        auto& array = value.get_ref<ArenaJson::array_t&>();
+        if (consume(']')) {
+            return true;
+        }
+        do {
+            array.emplace_back();
+            if (!parseValue(array.back(), depth)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume(']');
+    }
+
+    /**
+     * @brief Parse a string, m_pos being on the opening quote
+     */
+    bool parseString(ArenaString& out) {
+        const char* begin = ++m_pos;
+
+        // Strings without escapes are copied in one go
+        while (m_pos < m_end && *m_pos != '"' && *m_pos != '\\') {
+            if (static_cast<unsigned char>(*m_pos) < 0x20) {
+                return false;
+            }
+            ++m_pos;
+        }
+        out.assign(begin, m_pos);
+
+        while (m_pos < m_end) {
+            char c = *m_pos++;
+            if (c == '"') {
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return false;
+            }
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+            if (m_pos == m_end) {
+                return false;
+            }
+            switch (*m_pos++) {
+                case '"': out.push_back('"'); break;
+                case '\\': out.push_back('\\'); break;
+                case '/': out.push_back('/'); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                case 't': out.push_back('\t'); break;
+                case 'u':
+                    if (!parseCodePoint(out)) {
+                        return false;
+                    }
+                    break;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    bool parseHex(uint32_t& value) {
+        if (m_end - m_pos < 4) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *m_pos++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= static_cast<uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                value |= static_cast<uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                value |= static_cast<uint32_t>(c - 'A' + 10);
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Decode a \\u escape, m_pos being after the "u", and append it as UTF-8
+     */
+    bool parseCodePoint(ArenaString& out) {
+        uint32_t code;
+        if (!parseHex(code)) {
+            return false;
+        }
+        if (code >= 0xDC00 && code <= 0xDFFF) {
+            return false;
+        }
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            uint32_t low;
+            if (!consumeLiteral("\\u") || !parseHex(low) || low < 0xDC00 || low > 0xDFFF) {
+                return false;
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        return true;
+    }
+
+    bool skipDigits() {
+        const char* begin = m_pos;
+        while (m_pos < m_end && *m_pos >= '0' && *m_pos <= '9') {
+            ++m_pos;
+        }
+        return m_pos != begin;
+    }
+
+    bool parseNumber(ArenaJson& value) {
+        const char* begin = m_pos;
+        bool negative = *m_pos == '-';
+        if (negative) {
+            ++m_pos;
+        }
+        if (m_pos < m_end && *m_pos == '0') {
+            ++m_pos;
+        } else if (!skipDigits()) {
+            return false;
+        }
+
+        bool integer = true;
+        if (m_pos < m_end && *m_pos == '.') {
+            ++m_pos;
+            integer = false;
+            if (!skipDigits()) {
+                return false;
+            }
+        }
+        if (m_pos < m_end && (*m_pos == 'e' || *m_pos == 'E')) {
+            ++m_pos;
+            integer = false;
+            if (m_pos < m_end && (*m_pos == '+' || *m_pos == '-')) {
+                ++m_pos;
+            }
+            if (!skipDigits()) {
+                return false;
+            }
+        }
+
+        // Integers too large for 64 bits fall back to double
+        if (integer && negative) {
+            int64_t number;
+            if (std::from_chars(begin, m_pos, number).ec == std::errc()) {
+                value = number;
+                return true;
+            }
+        } else if (integer) {
+            uint64_t number;
+            if (std::from_chars(begin, m_pos, number).ec == std::errc()) {
+                value = number;
+                return true;
+            }
+        }
+        double number;
+        if (std::from_chars(begin, m_pos, number).ec != std::errc()) {
+            return false;
+        }
+        value = number;
+        return true;
+    }
+};
+
+} // namespace
+
+const ArenaJson& parseJson(std::string_view text) {
+    static const ArenaJson discarded(ArenaJson::value_t::discarded);
+
+    // Never destroyed: destroying a document would flatten it into a heap
+    // allocated stack, and rewinding the arena releases it anyway
+    Arena& arena = Arena::local();
+    ArenaJson* value = new (arena.allocate(sizeof(ArenaJson), alignof(ArenaJson))) ArenaJson();
+    Reader reader(text);
+    return reader.parseDocument(*value) ? *value : discarded;
+}
+
+} // namespace utils
+} // namespace deribit
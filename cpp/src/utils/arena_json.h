@@ -0,0 +1,62 @@
+/**
+ * @file arena_json.h
+ * @brief JSON documents allocated from the thread's arena
+ *
+ * This file contains the JSON type used to parse messages on the market
+ * data path and the reader producing it. nlohmann::basic_json::parse()
+ * keeps its token and state buffers on the heap, and destroying a
+ * basic_json document allocates too, so messages are read with
+ * parseJson() instead, which allocates from the arena only and leaves
+ * the document to be released by rewinding the arena.
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <string_view>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "arena.h"
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @brief JSON document whose nodes and strings live in Arena::local()
+ *
+ * For parsing messages on the market data path: a document must not
+ * outlive the arena scope it was created in, nor be handed to another
+ * thread.
+ */
+using ArenaJson = nlohmann::basic_json<std::map, std::vector, ArenaString, bool, std::int64_t, std::uint64_t,
+                                       double, ArenaAllocator>;
+
+/**
+ * @brief Parse a JSON document into the thread's arena
+ *
+ * Must be called inside an ArenaScope: the document is never destroyed
+ * and stays valid until the scope ends.
+ *
+ * @param text JSON text
+ * @return Document, or a discarded value (is_discarded()) if text is not valid JSON
+ */
+const ArenaJson& parseJson(std::string_view text);
+
+/**
+ * @brief Read a string field without copying it
+ * @param object JSON object
+ * @param key Field name
+ * @return View of the field, empty if missing or not a string
+ */
+inline std::string_view stringField(const ArenaJson& object, const char* key) {
+    auto it = object.find(key);
+    if (it == object.end() || !it->is_string()) {
+        return std::string_view();
+    }
+    const auto& value = it->get_ref<const ArenaJson::string_t&>();
+    return std::string_view(value.data(), value.size());
+}
+
+} // namespace utils
+} // namespace deribit
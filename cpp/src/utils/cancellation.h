@@ -0,0 +1,159 @@
+/**
+ * @file cancellation.h
+ * @brief Cooperative cancellation
+ *
+ * This file contains a cancellation source and the tokens it hands out.
+ * Operations accept a token and register a callback with it; cancelling
+ * the source invokes all registered callbacks.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @class CancellationToken
+ * @brief Class observing a CancellationSource
+ *
+ * A default-constructed token can never be cancelled. Tokens are cheap
+ * to copy and may be used from any thread.
+ */
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    /**
+     * @brief Check whether cancellation was requested
+     * @return true if cancelled, false otherwise
+     */
+    bool isCancelled() const {
+        return m_state && m_state->cancelled.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Check whether the token is attached to a source
+     * @return true if the token can be cancelled, false otherwise
+     */
+    bool canBeCancelled() const { return static_cast<bool>(m_state); }
+
+    /**
+     * @brief Register a callback invoked on cancellation
+     *
+     * If cancellation was already requested, the callback is invoked
+     * immediately on the calling thread.
+     *
+     * @param callback Callback function
+     * @return Registration ID for unregister(), or 0 if not registered
+     */
+    uint64_t onCancel(std::function<void()> callback) const {
+        if (!m_state) {
+            return 0;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            if (!m_state->cancelled.load(std::memory_order_relaxed)) {
+                uint64_t id = ++m_state->nextId;
+                m_state->callbacks.emplace_back(id, std::move(callback));
+                return id;
+            }
+        }
+        callback();
+        return 0;
+    }
+
+    /**
+     * @brief Remove a registered callback
+     * @param id Registration ID returned by onCancel()
+     */
+    void unregister(uint64_t id) const {
+        if (!m_state || id == 0) {
+            return;
+        }
+        std::function<void()> callback;
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        auto& callbacks = m_state->callbacks;
+        for (auto it = callbacks.begin(); it != callbacks.end(); ++it) {
+            if (it->first == id) {
+                callback = std::move(it->second);
+                callbacks.erase(it);
+                break;
+            }
+        }
+    }
+
+private:
+    friend class CancellationSource;
+
+    /**
+     * @struct State
+     * @brief Structure shared by a source and its tokens
+     */
+    struct State {
+        std::atomic<bool> cancelled{false};
+        std::mutex mutex;
+        uint64_t nextId = 0;
+        std::vector<std::pair<uint64_t, std::function<void()>>> callbacks;
+    };
+
+    std::shared_ptr<State> m_state;
+
+    explicit CancellationToken(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+};
+
+/**
+ * @class CancellationSource
+ * @brief Class for requesting cancellation of the operations holding its tokens
+ */
+class CancellationSource {
+public:
+    CancellationSource() : m_state(std::make_shared<CancellationToken::State>()) {}
+
+    /**
+     * @brief Get a token observing this source
+     * @return Cancellation token
+     */
+    CancellationToken getToken() const { return CancellationToken(m_state); }
+
+    /**
+     * @brief Request cancellation
+     *
+     * Registered callbacks run on the calling thread before this returns.
+     *
+     * @return true if this call requested cancellation, false if it was already requested
+     */
+    bool cancel() {
+        std::vector<std::pair<uint64_t, std::function<void()>>> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            if (m_state->cancelled.exchange(true, std::memory_order_acq_rel)) {
+                return false;
+            }
+            callbacks.swap(m_state->callbacks);
+        }
+        for (auto& entry : callbacks) {
+            entry.second();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Check whether cancellation was requested
+     * @return true if cancelled, false otherwise
+     */
+    bool isCancelled() const { return m_state->cancelled.load(std::memory_order_acquire); }
+
+private:
+    std::shared_ptr<CancellationToken::State> m_state;
+};
+
+} // namespace utils
+} // namespace deribit
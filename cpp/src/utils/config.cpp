@@ -0,0 +1,249 @@
+/**
+ * @file config.cpp
+ * @brief Configuration loading and access implementation
+ */
+
+#include "config.h"
+#include "logger.h"
+
+#include <fstream>
+#include <system_error>
+
+namespace deribit {
+namespace utils {
+
+using json = nlohmann::json;
+
+namespace {
+
+const json* lookup(const json& root, const std::string& key) {
+    const json* node = &root;
+    size_t begin = 0;
+    while (begin <= key.size()) {
+        size_t end = key.find('.', begin);
+        if (end == std::string::npos) {
+            end = key.size();
+        }
+        if (!node->is_object()) {
+            return nullptr;
+        }
+        auto it = node->find(key.substr(begin, end - begin));
+        if (it == node->end()) {
+            return nullptr;
+        }
+        node = &*it;
+        begin = end + 1;
+    }
+    return node;
+}
+
+template <typename T>
+T value(const json* node, T defaultValue) {
+    if (!node || node->is_null()) {
+        return defaultValue;
+    }
+    try {
+        return node->get<T>();
+    } catch (const json::exception&) {
+        return defaultValue;
+    }
+}
+
+template <typename T>
+T value(const json& root, const std::string& key, T defaultValue) {
+    return value(lookup(root, key), std::move(defaultValue));
+}
+
+std::chrono::milliseconds milliseconds(const json& root, const std::string& key, std::chrono::milliseconds defaultValue) {
+    return std::chrono::milliseconds(value<int64_t>(root, key, defaultValue.count()));
+}
+
+} // namespace
+
+Config& Config::getInstance() {
+    static Config instance;
+    return instance;
+}
+
+Config::Config() {
+    auto defaults = std::make_unique<const Settings>();
+    m_settings.store(defaults.get(), std::memory_order_release);
+    m_snapshots.push_back(std::move(defaults));
+}
+
+bool Config::loadFromFile(const std::string& filename) {
+    return load(filename);
+}
+
+std::string Config::getString(const std::string& key, const std::string& defaultValue) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return value(find(key), defaultValue);
+}
+
+bool Config::getBool(const std::string& key, bool defaultValue) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return value(find(key), defaultValue);
+}
+
+unsigned int Config::getUInt(const std::string& key, unsigned int defaultValue) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return value(find(key), defaultValue);
+}
+
+double Config::getDouble(const std::string& key, double defaultValue) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return value(find(key), defaultValue);
+}
+
+std::vector<std::string> Config::getStringList(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return value(find(key), std::vector<std::string>());
+}
+
+std::vector<unsigned int> Config::getUIntList(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return value(find(key), std::vector<unsigned int>());
+}
+
+bool Config::reload() {
+    std::string filename;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        filename = m_filename;
+    }
+    if (filename.empty()) {
+        LOG_WARN("No configuration file loaded, nothing to reload");
+        return false;
+    }
+    if (!load(filename)) {
+        LOG_ERROR("Configuration reload failed, keeping version {}", getSettings().version);
+        return false;
+    }
+
+    const Settings& settings = getSettings();
+    LOG_INFO("Configuration reloaded from {} (version {})", filename, settings.version);
+
+    std::function<void(const Settings&)> callback;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        callback = m_onReload;
+    }
+    if (callback) {
+        callback(settings);
+    }
+    return true;
+}
+
+bool Config::pollReload() {
+    bool requested = m_reloadRequested.exchange(false, std::memory_order_relaxed);
+
+    std::string filename;
+    std::filesystem::file_time_type modifiedAt;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        filename = m_filename;
+        modifiedAt = m_modifiedAt;
+    }
+    if (filename.empty()) {
+        return false;
+    }
+
+    std::error_code ec;
+    auto current = std::filesystem::last_write_time(filename, ec);
+    if (!ec && current != modifiedAt) {
+        // Remember the time even if the reload fails, so a broken file is
+        // reported once rather than on every poll
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_modifiedAt = current;
+        requested = true;
+    }
+    return requested && reload();
+}
+
+bool Config::validate(const Settings& settings, std::string& error) {
+    if (settings.wsPort == 0 || settings.wsPort > 65535) {
+        error = "ws_port must be between 1 and 65535";
+    } else if (settings.reconnectInitialDelay.count() <= 0 ||
+               settings.reconnectMaxDelay < settings.reconnectInitialDelay) {
+        error = "websocket.reconnect_max_delay_ms must not be below a positive reconnect_initial_delay_ms";
+    } else if (settings.probeAfter.count() <= 0 || settings.staleAfter <= settings.probeAfter) {
+        error = "websocket.stale_after_ms must be above a positive probe_after_ms";
+    } else if (settings.marketDataConnections == 0) {
+        error = "market_data.connections must be at least 1";
+    } else if (settings.risk.maxOrderAmount < 0 || settings.risk.maxPositionAmount < 0) {
+        error = "risk limits must not be negative";
+    } else {
+        return true;
+    }
+    return false;
+}
+
+bool Config::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        LOG_ERROR("Failed to open configuration file {}", filename);
+        return false;
+    }
+
+    json config = json::parse(file, nullptr, false);
+    if (config.is_discarded() || !config.is_object()) {
+        LOG_ERROR("Failed to parse configuration file {}", filename);
+        return false;
+    }
+
+    auto settings = std::make_unique<Settings>(parse(config));
+    std::string error;
+    if (!validate(*settings, error)) {
+        LOG_ERROR("Invalid configuration in {}: {}", filename, error);
+        return false;
+    }
+
+    std::error_code ec;
+    auto modifiedAt = std::filesystem::last_write_time(filename, ec);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    settings->version = m_settings.load(std::memory_order_relaxed)->version + 1;
+    m_config = std::move(config);
+    m_filename = filename;
+    if (!ec) {
+        m_modifiedAt = modifiedAt;
+    }
+    m_settings.store(settings.get(), std::memory_order_release);
+    m_snapshots.push_back(std::move(settings));
+    return true;
+}
+
+Settings Config::parse(const json& config) {
+    Settings settings;
+    settings.apiKey = value<std::string>(config, "api_key", "");
+    settings.apiSecret = value<std::string>(config, "api_secret", "");
+    settings.testnet = value(config, "testnet", settings.testnet);
+    settings.wsPort = value(config, "ws_port", settings.wsPort);
+
+    settings.reconnectInitialDelay = milliseconds(
+        config, "websocket.reconnect_initial_delay_ms", settings.reconnectInitialDelay);
+    settings.reconnectMaxDelay = milliseconds(
+        config, "websocket.reconnect_max_delay_ms", settings.reconnectMaxDelay);
+    settings.reconnectMaxAttempts = value(
+        config, "websocket.reconnect_max_attempts", settings.reconnectMaxAttempts);
+    settings.probeAfter = milliseconds(config, "websocket.probe_after_ms", settings.probeAfter);
+    settings.staleAfter = milliseconds(config, "websocket.stale_after_ms", settings.staleAfter);
+    settings.marketDataConnections = value(config, "market_data.connections", settings.marketDataConnections);
+
+    settings.risk.maxOrderAmount = value(config, "risk.max_order_amount", settings.risk.maxOrderAmount);
+    settings.risk.maxPositionAmount = value(config, "risk.max_position_amount", settings.risk.maxPositionAmount);
+    settings.risk.maxOpenOrders = value(config, "risk.max_open_orders", settings.risk.maxOpenOrders);
+
+    settings.throttle.maxOrdersPerSecond = value(
+        config, "throttle.max_orders_per_second", settings.throttle.maxOrdersPerSecond);
+    settings.throttle.maxRequestsPerSecond = value(
+        config, "throttle.max_requests_per_second", settings.throttle.maxRequestsPerSecond);
+    return settings;
+}
+
+const json* Config::find(const std::string& key) const {
+    return lookup(m_config, key);
+}
+
+} // namespace utils
+} // namespace deribit
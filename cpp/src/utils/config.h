@@ -0,0 +1,251 @@
+/**
+ * @file config.h
+ * @brief Configuration loading and access
+ *
+ * This file contains the configuration singleton used to load the
+ * JSON configuration file and query settings by key, and the typed
+ * settings snapshot parsed from it for hot paths.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include <filesystem>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @struct RiskLimits
+ * @brief Structure for pre-trade risk limits, 0 means no limit
+ */
+struct RiskLimits {
+    double maxOrderAmount;       // per order
+    double maxPositionAmount;    // per instrument
+    unsigned int maxOpenOrders;
+
+    RiskLimits() : maxOrderAmount(0), maxPositionAmount(0), maxOpenOrders(0) {}
+};
+
+/**
+ * @struct ThrottleLimits
+ * @brief Structure for outgoing request rate limits, 0 means no limit
+ */
+struct ThrottleLimits {
+    unsigned int maxOrdersPerSecond;
+    unsigned int maxRequestsPerSecond;
+
+    ThrottleLimits() : maxOrdersPerSecond(0), maxRequestsPerSecond(0) {}
+};
+
+/**
+ * @struct Settings
+ * @brief Structure for the configuration parsed into typed fields
+ *
+ * Snapshots are immutable once published. Sections with their own
+ * fromConfig() builders, such as subscriptions and the UI, are not
+ * duplicated here.
+ */
+struct Settings {
+    std::string apiKey;
+    std::string apiSecret;
+    bool testnet;
+    unsigned int wsPort;
+
+    std::chrono::milliseconds reconnectInitialDelay;
+    std::chrono::milliseconds reconnectMaxDelay;
+    unsigned int reconnectMaxAttempts;     // 0 for unlimited
+    std::chrono::milliseconds probeAfter;
+    std::chrono::milliseconds staleAfter;
+    unsigned int marketDataConnections;
+
+    RiskLimits risk;
+    ThrottleLimits throttle;
+
+    uint64_t version;                      // 0 before the first load, incremented on each reload
+
+    Settings() :
+        testnet(true),
+        wsPort(8080),
+        reconnectInitialDelay(100),
+        reconnectMaxDelay(30000),
+        reconnectMaxAttempts(0),
+        probeAfter(250),
+        staleAfter(750),
+        marketDataConnections(1),
+        version(0) {}
+};
+
+/**
+ * @class Config
+ * @brief Class for loading and querying the JSON configuration
+ *
+ * Keys may address nested objects with a dotted path,
+ * e.g. "subscriptions.instruments".
+ */
+class Config {
+public:
+    /**
+     * @brief Get the instance (singleton)
+     * @return Reference to Config instance
+     */
+    static Config& getInstance();
+
+    /**
+     * @brief Load the configuration from a JSON file
+     * @param filename Path to the configuration file
+     * @return true if successful, false otherwise
+     */
+    bool loadFromFile(const std::string& filename);
+
+    /**
+     * @brief Get the current settings snapshot
+     *
+     * Costs an atomic load and a dereference. The reference stays valid
+     * for the lifetime of the process, so a reader may keep it for the
+     * duration of an operation and see consistent values even if the
+     * configuration is reloaded meanwhile.
+     *
+     * @return Settings
+     */
+    const Settings& getSettings() const { return *m_settings.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Reload the configuration file
+     *
+     * The file is parsed and validated before anything is replaced; on
+     * failure the current configuration stays in effect. On success the
+     * reload callback is invoked on the calling thread.
+     *
+     * @return true if successful, false otherwise
+     */
+    bool reload();
+
+    /**
+     * @brief Ask for a reload on the next pollReload()
+     *
+     * Async-signal-safe, meant to be called from a SIGHUP handler.
+     */
+    void requestReload() { m_reloadRequested.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Reload if requested or if the file was modified since the last load
+     * @return true if the configuration was reloaded, false otherwise
+     */
+    bool pollReload();
+
+    /**
+     * @brief Set callback for successful reloads
+     * @param callback Callback receiving the new settings
+     */
+    void setOnReload(std::function<void(const Settings&)> callback) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_onReload = std::move(callback);
+    }
+
+    /**
+     * @brief Check settings for values the system cannot run with
+     * @param settings Settings
+     * @param error Output description of the first problem found
+     * @return true if valid, false otherwise
+     */
+    static bool validate(const Settings& settings, std::string& error);
+
+    /**
+     * @brief Get a string value
+     * @param key Configuration key
+     * @param defaultValue Value returned when the key is missing
+     * @return String value
+     */
+    std::string getString(const std::string& key, const std::string& defaultValue = "") const;
+
+    /**
+     * @brief Get a boolean value
+     * @param key Configuration key
+     * @param defaultValue Value returned when the key is missing
+     * @return Boolean value
+     */
+    bool getBool(const std::string& key, bool defaultValue = false) const;
+
+    /**
+     * @brief Get an unsigned integer value
+     * @param key Configuration key
+     * @param defaultValue Value returned when the key is missing
+     * @return Unsigned integer value
+     */
+    unsigned int getUInt(const std::string& key, unsigned int defaultValue = 0) const;
+
+    /**
+     * @brief Get a floating point value
+     * @param key Configuration key
+     * @param defaultValue Value returned when the key is missing
+     * @return Floating point value
+     */
+    double getDouble(const std::string& key, double defaultValue = 0.0) const;
+
+    /**
+     * @brief Get a list of strings
+     * @param key Configuration key
+     * @return String values, empty if the key is missing
+     */
+    std::vector<std::string> getStringList(const std::string& key) const;
+
+    /**
+     * @brief Get a list of unsigned integers
+     * @param key Configuration key
+     * @return Unsigned integer values, empty if the key is missing
+     */
+    std::vector<unsigned int> getUIntList(const std::string& key) const;
+
+private:
+    // Private constructor for singleton
+    Config();
+
+    // Prevent copying and assignment
+    Config(const Config&) = delete;
+    Config& operator=(const Config&) = delete;
+
+    nlohmann::json m_config;
+    std::string m_filename;
+    mutable std::mutex m_mutex;
+
+    // Published snapshot; earlier snapshots are kept so references
+    // handed out by getSettings() never dangle, reloads being rare
+    std::atomic<const Settings*> m_settings;
+    std::vector<std::unique_ptr<const Settings>> m_snapshots;
+    std::atomic<bool> m_reloadRequested{false};
+    std::filesystem::file_time_type m_modifiedAt;
+    std::function<void(const Settings&)> m_onReload;
+
+    /**
+     * @brief Parse and validate a file, then publish it
+     * @param filename Path to the configuration file
+     * @return true if successful, false otherwise
+     */
+    bool load(const std::string& filename);
+
+    /**
+     * @brief Parse the typed settings from a configuration document
+     * @param config Configuration document
+     * @return Settings
+     */
+    static Settings parse(const nlohmann::json& config);
+
+    /**
+     * @brief Resolve a dotted key to a JSON node
+     * @param key Configuration key
+     * @return Pointer to the node, or nullptr if not found
+     */
+    const nlohmann::json* find(const std::string& key) const;
+};
+
+} // namespace utils
+} // namespace deribit
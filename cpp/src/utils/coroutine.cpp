@@ -0,0 +1,242 @@
+/**
+ * @file coroutine.cpp
+ * @brief Coroutine task support implementation
+ */
+
+#include "coroutine.h"
+#include "timer_service.h"
+#include "logger.h"
+
+#include <atomic>
+#include <new>
+
+namespace deribit {
+namespace utils {
+
+namespace {
+
+constexpr size_t kSizeClasses = FramePool::kMaxFrame / FramePool::kGranularity;
+
+/**
+ * @struct FreeFrame
+ * @brief Structure linking a released frame into a free list
+ */
+struct FreeFrame {
+    FreeFrame* next;
+};
+
+struct FrameOwner;
+
+/**
+ * @struct FrameHeader
+ * @brief Structure in front of each pooled frame, naming the thread it returns to
+ *
+ * Its size keeps the frame behind it at the alignment of operator new.
+ */
+struct FrameHeader {
+    FrameOwner* owner;
+    size_t sizeClass;
+};
+static_assert(sizeof(FrameHeader) % __STDCPP_DEFAULT_NEW_ALIGNMENT__ == 0,
+              "frames must keep the alignment of operator new");
+
+/**
+ * @struct FrameOwner
+ * @brief Structure for the frames other threads return to a thread
+ *
+ * Outlives its thread while frames it allocated are still in use: each
+ * such frame, and the thread itself, holds a reference.
+ */
+struct FrameOwner {
+    std::atomic<FreeFrame*> returned{nullptr};
+    std::atomic<size_t> references{1};
+    std::atomic<bool> alive{true};
+
+    void release(size_t count = 1) {
+        if (references.fetch_sub(count, std::memory_order_acq_rel) == count) {
+            delete this;
+        }
+    }
+};
+
+FrameHeader* headerOf(void* frame) {
+    return reinterpret_cast<FrameHeader*>(frame) - 1;
+}
+
+/**
+ * @brief Free frames of a dead thread's return list
+ */
+void freeReturned(FrameOwner* owner) {
+    FreeFrame* frame = owner->returned.exchange(nullptr, std::memory_order_acquire);
+    size_t freed = 0;
+    while (frame) {
+        FreeFrame* next = frame->next;
+        ::operator delete(headerOf(frame));
+        frame = next;
+        ++freed;
+    }
+    if (freed > 0) {
+        owner->release(freed);
+    }
+}
+
+/**
+ * @struct FrameLists
+ * @brief Structure for the free lists of one thread
+ */
+struct FrameLists {
+    FreeFrame* heads[kSizeClasses] = {};
+    size_t counts[kSizeClasses] = {};
+    FramePool::Stats stats;
+    FrameOwner* owner = new FrameOwner();
+
+    ~FrameLists() {
+        owner->alive.store(false, std::memory_order_seq_cst);
+        size_t freed = 0;
+        for (FreeFrame*& head : heads) {
+            while (head) {
+                FreeFrame* next = head->next;
+                ::operator delete(headerOf(head));
+                head = next;
+                ++freed;
+            }
+        }
+        if (freed > 0) {
+            owner->release(freed);
+        }
+        freeReturned(owner);
+        owner->release();
+    }
+
+    /**
+     * @brief Move the frames other threads returned onto the local lists
+     */
+    void collectReturned() {
+        FreeFrame* frame = owner->returned.exchange(nullptr, std::memory_order_acquire);
+        while (frame) {
+            FreeFrame* next = frame->next;
+            size_t index = headerOf(frame)->sizeClass - 1;
+            frame->next = heads[index];
+            heads[index] = frame;
+            ++counts[index];
+            frame = next;
+        }
+    }
+};
+
+FrameLists& frameLists() {
+    thread_local FrameLists lists;
+    return lists;
+}
+
+/**
+ * @struct Detached
+ * @brief Structure for a coroutine that frees itself when done
+ */
+struct Detached {
+    struct promise_type {
+        static void* operator new(size_t size) { return FramePool::allocate(size); }
+        static void operator delete(void* frame, size_t size) noexcept { FramePool::deallocate(frame, size); }
+
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept {}
+    };
+};
+
+Detached runDetached(Task<void> task) {
+    try {
+        co_await std::move(task);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Spawned task failed: {}", e.what());
+    }
+}
+
+} // namespace
+
+void* FramePool::allocate(size_t size) {
+    size_t sizeClass = (size + kGranularity - 1) / kGranularity;
+    if (sizeClass == 0 || sizeClass > kSizeClasses) {
+        return ::operator new(size);
+    }
+
+    FrameLists& lists = frameLists();
+    FreeFrame*& head = lists.heads[sizeClass - 1];
+    if (!head) {
+        lists.collectReturned();
+    }
+    if (head) {
+        FreeFrame* frame = head;
+        head = frame->next;
+        --lists.counts[sizeClass - 1];
+        ++lists.stats.reused;
+        return frame;
+    }
+    ++lists.stats.allocated;
+    lists.owner->references.fetch_add(1, std::memory_order_relaxed);
+    auto* header = static_cast<FrameHeader*>(::operator new(sizeof(FrameHeader) + sizeClass * kGranularity));
+    header->owner = lists.owner;
+    header->sizeClass = sizeClass;
+    return header + 1;
+}
+
+void FramePool::deallocate(void* frame, size_t size) noexcept {
+    size_t sizeClass = (size + kGranularity - 1) / kGranularity;
+    if (sizeClass == 0 || sizeClass > kSizeClasses) {
+        ::operator delete(frame);
+        return;
+    }
+
+    FrameOwner* owner = headerOf(frame)->owner;
+    FreeFrame* released = static_cast<FreeFrame*>(frame);
+    FrameLists& lists = frameLists();
+    if (owner != lists.owner) {
+        // Frames finished on another thread, e.g. the event loop, go back
+        // to the thread that allocated them
+        if (!owner->alive.load(std::memory_order_seq_cst)) {
+            ::operator delete(headerOf(frame));
+            owner->release();
+            return;
+        }
+        // Once pushed, the frame's reference may be dropped by the exiting
+        // owner at any time; pin the owner until the check below is done
+        owner->references.fetch_add(1, std::memory_order_relaxed);
+        FreeFrame* head = owner->returned.load(std::memory_order_relaxed);
+        do {
+            released->next = head;
+        } while (!owner->returned.compare_exchange_weak(head, released, std::memory_order_release,
+                                                        std::memory_order_relaxed));
+        // The owner may have exited in the meantime, without seeing the frame
+        if (!owner->alive.load(std::memory_order_seq_cst)) {
+            freeReturned(owner);
+        }
+        owner->release();
+        return;
+    }
+
+    if (lists.counts[sizeClass - 1] >= kMaxCachedBytes / (sizeClass * kGranularity)) {
+        ::operator delete(headerOf(frame));
+        owner->release();
+        return;
+    }
+    released->next = lists.heads[sizeClass - 1];
+    lists.heads[sizeClass - 1] = released;
+    ++lists.counts[sizeClass - 1];
+}
+
+FramePool::Stats FramePool::getStats() {
+    return frameLists().stats;
+}
+
+void spawn(Task<void> task) {
+    runDetached(std::move(task));
+}
+
+void resumeOnEventLoop(std::coroutine_handle<> handle, std::chrono::steady_clock::duration delay) {
+    TimerService::getInstance().schedule(delay, [handle]() { handle.resume(); });
+}
+
+} // namespace utils
+} // namespace deribit
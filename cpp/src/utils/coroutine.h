@@ -0,0 +1,268 @@
+/**
+ * @file coroutine.h
+ * @brief Coroutine tasks running on the timer service event loop
+ *
+ * This file contains the Task type returned by asynchronous operations,
+ * spawn() to start a task without awaiting it, and the pooled allocator
+ * for coroutine frames. Awaited operations resume their coroutine on the
+ * TimerService thread, so the code of all tasks runs on one thread
+ * between suspension points and needs no locking.
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @class FramePool
+ * @brief Class recycling coroutine frames
+ *
+ * Frame sizes are rounded up to a multiple of kGranularity. Released
+ * frames are kept on per-thread free lists, one per size class, so once
+ * warmed up a coroutine takes its frame from a list instead of the heap.
+ * Each frame remembers the thread that allocated it; a frame released on
+ * another thread, e.g. a coroutine finished on the event loop, is pushed
+ * onto a lock-free return list of that thread, which moves it back to
+ * its free lists on its next allocation. Frames larger than kMaxFrame
+ * always use the heap.
+ */
+class FramePool {
+public:
+    static constexpr size_t kGranularity = 64;
+    static constexpr size_t kMaxFrame = 4096;
+    static constexpr size_t kMaxCachedBytes = 8 << 20;   // kept per size class and thread
+
+    /**
+     * @struct Stats
+     * @brief Structure for the frame counters of the calling thread
+     */
+    struct Stats {
+        uint64_t allocated = 0;   // frames taken from the heap
+        uint64_t reused = 0;      // frames taken from a free list
+    };
+
+    /**
+     * @brief Get a frame
+     * @param size Frame size in bytes
+     * @return Frame
+     */
+    static void* allocate(size_t size);
+
+    /**
+     * @brief Release a frame
+     * @param frame Frame from allocate()
+     * @param size Size passed to allocate()
+     */
+    static void deallocate(void* frame, size_t size) noexcept;
+
+    /**
+     * @brief Get the counters of the calling thread
+     * @return Counters
+     */
+    static Stats getStats();
+};
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+/**
+ * @struct PromiseBase
+ * @brief Structure for the promise state shared by all tasks
+ */
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    static void* operator new(size_t size) { return FramePool::allocate(size); }
+    static void operator delete(void* frame, size_t size) noexcept { FramePool::deallocate(frame, size); }
+
+    /**
+     * @struct FinalAwaiter
+     * @brief Structure transferring control to the awaiting coroutine
+     */
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            auto continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    // Tasks start when first awaited
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+
+    template <typename U>
+    void return_value(U&& result) {
+        value.emplace(std::forward<U>(result));
+    }
+
+    T result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+
+    void return_void() const noexcept {}
+
+    void result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * @class Task
+ * @brief Class for a lazily started coroutine producing a T
+ *
+ * A task runs when awaited and resumes its awaiter when it finishes,
+ * without going through the event loop. Exceptions propagate to the
+ * awaiter. Coroutine parameters are copied into the frame, so a
+ * coroutine must take strings and other data by value, not by
+ * reference.
+ */
+template <typename T>
+class Task {
+public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(Handle handle) : m_handle(handle) {}
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    // Prevent copying
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    /**
+     * @struct Awaiter
+     * @brief Structure starting the task and returning its result
+     */
+    struct Awaiter {
+        Handle handle;
+
+        bool await_ready() const noexcept { return !handle || handle.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        T await_resume() { return handle.promise().result(); }
+    };
+
+    Awaiter operator co_await() && noexcept { return Awaiter{m_handle}; }
+
+    /**
+     * @brief Check whether the task has finished
+     * @return true if finished, false otherwise
+     */
+    bool isDone() const { return !m_handle || m_handle.done(); }
+
+private:
+    Handle m_handle;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> Promise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+/**
+ * @brief Start a task without awaiting it
+ *
+ * The task runs on the calling thread up to its first suspension and
+ * frees itself when done. Exceptions escaping it are logged.
+ *
+ * @param task Task
+ */
+void spawn(Task<void> task);
+
+/**
+ * @brief Resume a coroutine on the TimerService thread
+ * @param handle Suspended coroutine
+ * @param delay Delay before resuming
+ */
+void resumeOnEventLoop(std::coroutine_handle<> handle,
+                       std::chrono::steady_clock::duration delay = std::chrono::steady_clock::duration::zero());
+
+/**
+ * @struct SleepAwaitable
+ * @brief Structure suspending a coroutine for a while
+ */
+struct SleepAwaitable {
+    std::chrono::steady_clock::duration delay;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) const { resumeOnEventLoop(handle, delay); }
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Suspend the awaiting coroutine, resuming it on the event loop
+ * @param delay Delay, rounded up to the timer resolution
+ * @return Awaitable
+ */
+inline SleepAwaitable sleepFor(std::chrono::steady_clock::duration delay) {
+    return SleepAwaitable{delay};
+}
+
+} // namespace utils
+} // namespace deribit
@@ -0,0 +1,182 @@
+/**
+ * @file huge_pages.cpp
+ * @brief Huge page memory resource implementation
+ */
+
+#include "huge_pages.h"
+#include "config.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace deribit {
+namespace utils {
+
+namespace {
+
+// Size classes: multiples of a cache line below a page, of a page above
+constexpr size_t kLineSize = 64;
+constexpr size_t kPageSize = 4096;
+
+size_t sizeClass(size_t bytes) {
+    size_t granule = bytes < kPageSize ? kLineSize : kPageSize;
+    return (std::max<size_t>(bytes, 1) + granule - 1) / granule * granule;
+}
+
+} // namespace
+
+HugePageConfig HugePageConfig::fromConfig(const Config& config) {
+    HugePageConfig result;
+    result.enabled = config.getBool("memory.huge_pages", result.enabled);
+    result.reserveBytes = static_cast<size_t>(
+        config.getUInt("memory.reserve_mb", static_cast<unsigned int>(result.reserveBytes >> 20))) << 20;
+    result.prefault = config.getBool("memory.prefault", result.prefault);
+    result.lock = config.getBool("memory.lock", result.lock);
+    result.lockAll = config.getBool("memory.lock_all", result.lockAll);
+    return result;
+}
+
+HugePageResource& HugePageResource::getInstance() {
+    // Never destroyed, so singletons released at exit can still give memory back
+    static HugePageResource* instance = new HugePageResource();
+    return *instance;
+}
+
+HugePageResource::HugePageResource() : m_region(nullptr), m_offset(0), m_overflowWarned(false) {}
+
+bool HugePageResource::reserve(const HugePageConfig& config) {
+#ifdef __linux__
+    if (config.lockAll && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        LOG_WARN("mlockall failed: {}", std::strerror(errno));
+    }
+    if (!config.enabled || config.reserveBytes == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_region) {
+        return false;
+    }
+
+    size_t size = (config.reserveBytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    int populate = config.prefault ? MAP_POPULATE : 0;
+    int hugeFlags = MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+    hugeFlags |= 21 << MAP_HUGE_SHIFT;
+#endif
+
+    void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | hugeFlags | populate, -1, 0);
+    bool hugeTlb = region != MAP_FAILED;
+    if (!hugeTlb) {
+        LOG_WARN("No huge pages reserved for {} MB ({}), using transparent huge pages",
+                 size >> 20, std::strerror(errno));
+
+        // Over-allocate to align the region on a huge page boundary
+        void* mapping = mmap(nullptr, size + kHugePageSize, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            LOG_ERROR("Failed to map {} MB: {}", size >> 20, std::strerror(errno));
+            return false;
+        }
+        auto address = reinterpret_cast<uintptr_t>(mapping);
+        auto aligned = (address + kHugePageSize - 1) & ~(kHugePageSize - 1);
+        if (aligned > address) {
+            munmap(mapping, aligned - address);
+        }
+        munmap(reinterpret_cast<void*>(aligned + size), address + kHugePageSize - aligned);
+        region = reinterpret_cast<void*>(aligned);
+        madvise(region, size, MADV_HUGEPAGE);
+
+        // Faulting the pages in after madvise() lets the kernel back them with huge pages
+        if (config.prefault) {
+            std::memset(region, 0, size);
+        }
+    }
+
+    bool locked = false;
+    if (config.lock) {
+        locked = mlock(region, size) == 0;
+        if (!locked) {
+            LOG_WARN("Failed to lock {} MB of huge pages: {}", size >> 20, std::strerror(errno));
+        }
+    }
+
+    m_region = static_cast<std::byte*>(region);
+    m_offset = 0;
+    m_stats.reserved = size;
+    m_stats.hugeTlb = hugeTlb;
+    m_stats.locked = locked;
+    LOG_INFO("Reserved {} MB of {} huge pages{}", size >> 20, hugeTlb ? "hugetlb" : "transparent",
+             locked ? ", locked" : "");
+    return true;
+#else
+    (void)config;
+    return false;
+#endif
+}
+
+HugePageResource::Stats HugePageResource::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void* HugePageResource::do_allocate(size_t bytes, size_t alignment) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_region) {
+            size_t size = sizeClass(bytes);
+
+            // Reuse a block of the same class given back earlier
+            auto freeList = m_freeLists.find(size);
+            if (freeList != m_freeLists.end() && freeList->second &&
+                reinterpret_cast<uintptr_t>(freeList->second) % alignment == 0) {
+                void* block = freeList->second;
+                freeList->second = *static_cast<void**>(block);
+                m_stats.free -= size;
+                return block;
+            }
+
+            size_t align = std::max(alignment, kLineSize);
+            size_t begin = (m_offset + align - 1) & ~(align - 1);
+            if (begin + size <= m_stats.reserved) {
+                m_offset = begin + size;
+                m_stats.used = m_offset;
+                return m_region + begin;
+            }
+            m_stats.overflow += bytes;
+            if (!m_overflowWarned) {
+                m_overflowWarned = true;
+                LOG_WARN("Huge page region of {} MB exhausted ({} MB free for reuse), "
+                         "allocating from the heap; raise memory.reserve_mb",
+                         m_stats.reserved >> 20, m_stats.free >> 20);
+            }
+        }
+    }
+    return std::pmr::get_default_resource()->allocate(bytes, alignment);
+}
+
+void HugePageResource::do_deallocate(void* memory, size_t bytes, size_t alignment) {
+    auto* address = static_cast<std::byte*>(memory);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_region && address >= m_region && address < m_region + m_stats.reserved) {
+            size_t size = sizeClass(bytes);
+            void*& head = m_freeLists[size];
+            *static_cast<void**>(memory) = head;
+            head = memory;
+            m_stats.free += size;
+            return;
+        }
+    }
+    std::pmr::get_default_resource()->deallocate(memory, bytes, alignment);
+}
+
+} // namespace utils
+} // namespace deribit
@@ -0,0 +1,123 @@
+/**
+ * @file huge_pages.h
+ * @brief Huge page backed memory for long-lived hot data structures
+ *
+ * This file contains the memory resource that orderbooks, trade tapes and
+ * order queues allocate from. It carves a region reserved at startup from
+ * 2 MB pages, pre-faulted and locked, so these randomly accessed
+ * structures need few TLB entries and never page fault once running.
+ */
+
+#pragma once
+
+#include <memory_resource>
+#include <mutex>
+#include <map>
+#include <cstddef>
+#include <cstdint>
+
+namespace deribit {
+namespace utils {
+
+class Config;
+
+/**
+ * @struct HugePageConfig
+ * @brief Structure for the huge page settings
+ */
+struct HugePageConfig {
+    bool enabled;
+    size_t reserveBytes;    // region size, rounded up to whole huge pages
+    bool prefault;          // touch every page at startup
+    bool lock;              // mlock the region
+    bool lockAll;           // mlockall the whole process, current and future mappings
+
+    HugePageConfig() : enabled(false), reserveBytes(256 << 20), prefault(true), lock(true), lockAll(false) {}
+
+    /**
+     * @brief Build from the "memory" section of the configuration
+     * @param config Configuration
+     * @return Huge page configuration
+     */
+    static HugePageConfig fromConfig(const Config& config);
+};
+
+/**
+ * @class HugePageResource
+ * @brief Class for a memory resource carving a huge page region
+ *
+ * The region is mapped with MAP_HUGETLB when the system has huge pages
+ * reserved, otherwise with regular pages advised for transparent huge
+ * pages. Allocations are rounded up to a size class and bumped from the
+ * region; memory given back goes to a free list per size class and is
+ * handed out again for the same class, so tapes and books recreated as
+ * instruments come and go reuse their predecessors' memory. Once the
+ * region is exhausted, or before reserve(), requests go to the default
+ * heap resource. Thread-safe.
+ */
+class HugePageResource : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kHugePageSize = 2 << 20;
+
+    /**
+     * @struct Stats
+     * @brief Structure for the region counters
+     */
+    struct Stats {
+        size_t reserved = 0;        // bytes mapped
+        size_t used = 0;            // bytes carved from the region
+        size_t free = 0;            // bytes of those in the free lists
+        size_t overflow = 0;        // bytes served by the heap after the region ran out
+        bool hugeTlb = false;       // mapped from the huge page pool rather than transparent huge pages
+        bool locked = false;
+    };
+
+    /**
+     * @brief Get the instance (singleton)
+     * @return Reference to HugePageResource instance
+     */
+    static HugePageResource& getInstance();
+
+    /**
+     * @brief Map the region
+     *
+     * Must be called at startup before the books, tapes and queues are
+     * created; later calls are ignored. Falls back to regular pages, and
+     * to unlocked memory, with a warning.
+     *
+     * @param config Huge page configuration
+     * @return true if a region was mapped, false if disabled or mapping failed
+     */
+    bool reserve(const HugePageConfig& config);
+
+    /**
+     * @brief Get the region counters
+     * @return Counters
+     */
+    Stats getStats() const;
+
+private:
+    // Private constructor for singleton
+    HugePageResource();
+    ~HugePageResource() override = default;
+
+    // Prevent copying and assignment
+    HugePageResource(const HugePageResource&) = delete;
+    HugePageResource& operator=(const HugePageResource&) = delete;
+
+    mutable std::mutex m_mutex;
+    std::byte* m_region;
+    size_t m_offset;
+    Stats m_stats;
+    bool m_overflowWarned;
+
+    // Free blocks per size class, linked through their first bytes
+    std::map<size_t, void*> m_freeLists;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+} // namespace utils
+} // namespace deribit
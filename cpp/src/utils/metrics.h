@@ -16,6 +16,7 @@
 #include <deque>
 #include <atomic>
 #include <memory>
+#include "seqlock.h"
 
 namespace deribit {
 namespace utils {
@@ -36,6 +37,22 @@ struct LatencyMetric {
     LatencyMetric() : min(0), max(0), avg(0), p50(0), p90(0), p99(0), count(0) {}
 };
 
+/**
+ * @struct MetricsSnapshot
+ * @brief Structure for headline metrics, published by update() without locks
+ */
+struct MetricsSnapshot {
+    LatencyMetric orderPlacement;
+    LatencyMetric orderCancellation;
+    LatencyMetric orderModification;
+    size_t marketDataUpdates;
+    double marketDataRate;   // updates per second since the previous update()
+    size_t staleConnections;
+    int64_t updatedAtMs;     // system clock, 0 before the first update()
+
+    MetricsSnapshot() : marketDataUpdates(0), marketDataRate(0), staleConnections(0), updatedAtMs(0) {}
+};
+
 /**
  * @class Metrics
  * @brief Class for collecting and reporting performance metrics
@@ -107,6 +124,20 @@ public:
      */
     void recordOrderModification(const std::string& instrument, double latencyMs);
     
+    /**
+     * @brief Record a connection declared stale by a watchdog
+     * @param connection Connection name
+     * @param idleMs Time since the last received frame in milliseconds
+     */
+    void recordStaleConnection(const std::string& connection, double idleMs);
+    
+    /**
+     * @brief Get the number of times a connection was declared stale
+     * @param connection Connection name
+     * @return Number of stale detections
+     */
+    size_t getStaleConnectionCount(const std::string& connection);
+    
     /**
      * @brief Get latency metrics for a category and operation
      * @param category Category name
@@ -120,9 +151,21 @@ public:
     
     /**
      * @brief Update metrics (called periodically)
+     *
+     * Also publishes the snapshot returned by getSnapshot().
      */
     void update();
     
+    /**
+     * @brief Get the headline metrics as of the last update()
+     *
+     * Does not take the metrics lock, so readers such as the UI never
+     * delay the threads recording samples.
+     *
+     * @return Metrics snapshot
+     */
+    MetricsSnapshot getSnapshot() const { return m_snapshot.load(); }
+    
     /**
      * @brief Generate a metrics report
      * @param filename Output filename
@@ -181,12 +224,14 @@ private:
     std::map<uint64_t, MeasurementEntry> m_activeMeasurements;
     std::map<MetricKey, std::deque<LatencySample>> m_latencySamples;
     std::map<std::string, size_t> m_marketDataUpdates;
+    std::map<std::string, size_t> m_staleConnections;
     size_t m_maxSamples;
     std::atomic<uint64_t> m_nextMeasurementId{1};
     std::mutex m_mutex;
     
     std::map<std::string, std::map<std::string, size_t>> m_operationCounts;
     std::chrono::system_clock::time_point m_lastUpdateTime;
+    SeqLock<MetricsSnapshot> m_snapshot;  // written by update() only
     
     /**
      * @brief Calculate metrics from samples
@@ -0,0 +1,121 @@
+/**
+ * @file seqlock.h
+ * @brief Sequence lock for publishing small values to readers
+ *
+ * This file contains a sequence lock that lets a writer publish a small,
+ * trivially copyable value without ever blocking on its readers. Readers
+ * retry when they observe a write in progress.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @class SeqLock
+ * @brief Class publishing a trivially copyable value from a single writer
+ *
+ * store() must not be called concurrently, callers with several writers
+ * serialize them with a lock they already hold. load() never blocks the
+ * writer; it copies the value and retries if a store() overlapped.
+ *
+ * The value is kept in relaxed atomic words so concurrent copies are not
+ * data races.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock() : SeqLock(T()) {}
+
+    /**
+     * @brief Constructor
+     * @param value Initial value
+     */
+    explicit SeqLock(const T& value) {
+        uint64_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief Publish a value
+     * @param value Value
+     */
+    void store(const T& value) {
+        uint64_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Read the last published value
+     * @return Value
+     */
+    T load() const {
+        T value;
+        while (!tryLoad(value)) {
+        }
+        return value;
+    }
+
+    /**
+     * @brief Read the last published value without retrying
+     * @param value Output value, unchanged on failure
+     * @return true if the read was consistent, false if a store() overlapped
+     */
+    bool tryLoad(T& value) const {
+        uint64_t before = m_sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Get the number of values published since construction
+     *
+     * Readers compare versions to skip work when nothing changed.
+     *
+     * @return Version
+     */
+    uint64_t getVersion() const { return m_sequence.load(std::memory_order_acquire) >> 1; }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // Own cache line, so readers polling the sequence do not slow down neighbours
+    alignas(64) std::atomic<uint64_t> m_sequence{0};
+    std::atomic<uint64_t> m_words[kWords];
+};
+
+} // namespace utils
+} // namespace deribit
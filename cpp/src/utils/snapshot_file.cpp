@@ -0,0 +1,173 @@
+/**
+ * @file snapshot_file.cpp
+ * @brief Snapshot file implementation
+ */
+
+#include "snapshot_file.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace deribit {
+namespace utils {
+
+namespace {
+
+constexpr size_t kPageSize = 4096;
+
+} // namespace
+
+SnapshotFile::SnapshotFile() : m_data(nullptr), m_size(0), m_fd(-1), m_sync(false), m_sequence(0) {}
+
+SnapshotFile::~SnapshotFile() {
+    close();
+}
+
+bool SnapshotFile::open(const std::string& path, size_t size, bool sync) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_data) {
+        return false;
+    }
+
+    // Slots start on a page boundary so each can be flushed on its own
+    size = std::max<size_t>(size / (2 * kPageSize), 1) * 2 * kPageSize;
+
+    std::error_code error;
+    auto parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open snapshot file {}: {}", path, std::strerror(errno));
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (static_cast<size_t>(info.st_size) != size && ftruncate(fd, size) != 0)) {
+        LOG_ERROR("Failed to size snapshot file {}: {}", path, std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    if (info.st_size != 0 && static_cast<size_t>(info.st_size) != size) {
+        LOG_WARN("Snapshot file {} resized from {} to {} bytes", path, info.st_size, size);
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        LOG_ERROR("Failed to map snapshot file {}: {}", path, std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    m_data = static_cast<std::byte*>(data);
+    m_size = size;
+    m_fd = fd;
+    m_sync = sync;
+    m_sequence = std::max(validate(0), validate(1));
+    return true;
+}
+
+void SnapshotFile::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_data) {
+        return;
+    }
+    munmap(m_data, m_size);
+    ::close(m_fd);
+    m_data = nullptr;
+    m_size = 0;
+    m_fd = -1;
+}
+
+bool SnapshotFile::read(std::string& payload, uint64_t& sequence) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_data) {
+        return false;
+    }
+    uint64_t first = validate(0);
+    uint64_t second = validate(1);
+    if (first == 0 && second == 0) {
+        return false;
+    }
+
+    size_t slot = first > second ? 0 : 1;
+    const SlotHeader* slotHeader = header(slot);
+    const auto* begin = reinterpret_cast<const char*>(slotHeader) + kHeaderSize;
+    payload.assign(begin, slotHeader->length);
+    sequence = slotHeader->sequence;
+    return true;
+}
+
+bool SnapshotFile::write(std::string_view payload) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_data || payload.size() > getCapacity()) {
+        return false;
+    }
+
+    // Snapshot n lives in slot n % 2, so this overwrites the older one
+    size_t slot = (m_sequence + 1) % 2;
+    size_t slotSize = m_size / 2;
+    SlotHeader* slotHeader = header(slot);
+
+    slotHeader->sequence = 0;
+    flush(slot * slotSize, kHeaderSize);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto* begin = reinterpret_cast<std::byte*>(slotHeader) + kHeaderSize;
+    std::memcpy(begin, payload.data(), payload.size());
+    slotHeader->magic = kMagic;
+    slotHeader->length = payload.size();
+    slotHeader->checksum = checksum(begin, payload.size());
+    flush(slot * slotSize, kHeaderSize + payload.size());
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Publishing the sequence number last makes the slot valid
+    slotHeader->sequence = ++m_sequence;
+    flush(slot * slotSize, kHeaderSize);
+    return true;
+}
+
+size_t SnapshotFile::getCapacity() const {
+    return m_size / 2 - kHeaderSize;
+}
+
+SnapshotFile::SlotHeader* SnapshotFile::header(size_t slot) const {
+    return reinterpret_cast<SlotHeader*>(m_data + slot * (m_size / 2));
+}
+
+uint64_t SnapshotFile::validate(size_t slot) const {
+    const SlotHeader* slotHeader = header(slot);
+    if (slotHeader->magic != kMagic || slotHeader->sequence == 0 || slotHeader->length > getCapacity()) {
+        return 0;
+    }
+    const auto* begin = reinterpret_cast<const std::byte*>(slotHeader) + kHeaderSize;
+    return checksum(begin, slotHeader->length) == slotHeader->checksum ? slotHeader->sequence : 0;
+}
+
+void SnapshotFile::flush(size_t offset, size_t length) const {
+    if (m_sync && msync(m_data + offset, length, MS_SYNC) != 0) {
+        LOG_WARN("Failed to flush snapshot file: {}", std::strerror(errno));
+    }
+}
+
+uint64_t SnapshotFile::checksum(const std::byte* data, size_t length) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<uint64_t>(data[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+} // namespace utils
+} // namespace deribit
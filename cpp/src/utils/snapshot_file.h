@@ -0,0 +1,149 @@
+/**
+ * @file snapshot_file.h
+ * @brief Crash-consistent snapshot file
+ *
+ * This file contains a memory-mapped file holding the latest of a series
+ * of snapshots, such that a crash at any point during a write leaves
+ * either the new or the previous snapshot readable.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @class SnapshotFile
+ * @brief Class storing snapshots in two alternating slots of a mapped file
+ *
+ * The file is split into two slots, each with a header holding a
+ * sequence number, the payload length and a checksum. A write goes to the
+ * slot holding the older snapshot: its header is invalidated, the payload
+ * copied, and the header written last. A reader takes the valid slot with
+ * the highest sequence number, so a write interrupted by a crash falls
+ * back to the previous snapshot.
+ *
+ * Writes through the shared mapping survive a crash of the process; with
+ * sync enabled, each write is also flushed to disk before the header is
+ * published, so they survive a crash of the machine.
+ */
+class SnapshotFile {
+public:
+    /**
+     * @brief Constructor
+     */
+    SnapshotFile();
+
+    /**
+     * @brief Destructor, unmaps the file
+     */
+    ~SnapshotFile();
+
+    // Prevent copying and assignment
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+    /**
+     * @brief Open or create the file and map it
+     *
+     * A file of another size is resized, which loses its snapshots.
+     *
+     * @param path File path; missing parent directories are created
+     * @param size File size in bytes, holding two slots
+     * @param sync Flush every write to disk
+     * @return true if mapped, false otherwise
+     */
+    bool open(const std::string& path, size_t size, bool sync);
+
+    /**
+     * @brief Unmap and close the file
+     */
+    void close();
+
+    /**
+     * @brief Check whether the file is mapped
+     * @return true if mapped, false otherwise
+     */
+    bool isOpen() const { return m_data != nullptr; }
+
+    /**
+     * @brief Read the latest valid snapshot
+     * @param payload Output payload
+     * @param sequence Output sequence number of the snapshot
+     * @return true if a valid snapshot was found, false otherwise
+     */
+    bool read(std::string& payload, uint64_t& sequence) const;
+
+    /**
+     * @brief Write a new snapshot, replacing the older of the two slots
+     * @param payload Payload
+     * @return true if written, false if not open or the payload does not fit
+     */
+    bool write(std::string_view payload);
+
+    /**
+     * @brief Get the largest payload a slot can hold
+     * @return Capacity in bytes
+     */
+    size_t getCapacity() const;
+
+private:
+    /**
+     * @struct SlotHeader
+     * @brief Structure at the start of each slot
+     */
+    struct SlotHeader {
+        uint64_t magic;
+        uint64_t sequence;      // 0 while the slot is being written
+        uint64_t length;
+        uint64_t checksum;      // of the payload
+    };
+
+    static constexpr uint64_t kMagic = 0x50414e5354524244ULL;  // "DBRTSNAP" on disk
+    static constexpr size_t kHeaderSize = 64;
+
+    std::byte* m_data;
+    size_t m_size;
+    int m_fd;
+    bool m_sync;
+    uint64_t m_sequence;    // of the latest snapshot written or found
+    mutable std::mutex m_mutex;
+
+    /**
+     * @brief Get the header of a slot
+     * @param slot Slot index, 0 or 1
+     * @return Header
+     */
+    SlotHeader* header(size_t slot) const;
+
+    /**
+     * @brief Check a slot and get its sequence number
+     * @param slot Slot index
+     * @return Sequence number, 0 if the slot holds no valid snapshot
+     */
+    uint64_t validate(size_t slot) const;
+
+    /**
+     * @brief Flush a range of the mapping to disk if sync is enabled
+     * @param offset Offset in the file
+     * @param length Length in bytes
+     */
+    void flush(size_t offset, size_t length) const;
+
+    /**
+     * @brief Compute the checksum of a payload (64-bit FNV-1a)
+     * @param data Payload
+     * @param length Length in bytes
+     * @return Checksum
+     */
+    static uint64_t checksum(const std::byte* data, size_t length);
+};
+
+} // namespace utils
+} // namespace deribit
@@ -0,0 +1,121 @@
+/**
+ * @file spsc_queue.h
+ * @brief Lock-free single-producer single-consumer queue
+ *
+ * This file contains a bounded ring buffer for handing items from one
+ * thread to another without locks or allocations.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory_resource>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @class SpscQueue
+ * @brief Class for a bounded lock-free queue between two threads
+ *
+ * At any time at most one thread may push and one thread may pop;
+ * several producers must serialize themselves. Slots are allocated up
+ * front, the capacity is rounded up to a power of two.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Minimum number of items the queue can hold
+     * @param resource Memory for the slots (optional)
+     */
+    explicit SpscQueue(size_t capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_slots(roundUp(capacity), resource), m_mask(m_slots.size() - 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Append an item
+     * @param item Item
+     * @return true if appended, false if the queue is full
+     */
+    template <typename U>
+    bool tryPush(U&& item) {
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = std::forward<U>(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest item
+     * @param item Output item
+     * @return true if an item was removed, false if the queue is empty
+     */
+    bool tryPop(T& item) {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+        item = std::move(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Get the number of queued items, approximate while in use
+     * @return Number of items
+     */
+    size_t size() const {
+        return static_cast<size_t>(m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Check whether the queue is empty, approximate while in use
+     * @return true if empty, false otherwise
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Get the capacity
+     * @return Number of slots
+     */
+    size_t capacity() const { return m_slots.size(); }
+
+private:
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    std::pmr::vector<T> m_slots;
+    const uint64_t m_mask;
+
+    // Producer and consumer indices on separate cache lines, each with a
+    // cached copy of the other side's index to avoid cross-core traffic
+    alignas(64) std::atomic<uint64_t> m_tail{0};
+    uint64_t m_cachedHead = 0;
+    alignas(64) std::atomic<uint64_t> m_head{0};
+    uint64_t m_cachedTail = 0;
+};
+
+} // namespace utils
+} // namespace deribit
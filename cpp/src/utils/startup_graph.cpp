@@ -0,0 +1,167 @@
+/**
+ * @file startup_graph.cpp
+ * @brief Startup graph implementation
+ */
+
+#include "startup_graph.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace deribit {
+namespace utils {
+
+namespace {
+
+const char* stateName(StartupGraph::StepState state) {
+    switch (state) {
+        case StartupGraph::StepState::DONE: return "done";
+        case StartupGraph::StepState::FAILED: return "FAILED";
+        case StartupGraph::StepState::SKIPPED: return "skipped";
+        case StartupGraph::StepState::RUNNING: return "running";
+        default: return "pending";
+    }
+}
+
+} // namespace
+
+bool StartupGraph::addStep(std::string name, std::vector<std::string> dependencies, std::function<bool()> step) {
+    if (find(name) != m_steps.size()) {
+        return false;
+    }
+    Step entry;
+    for (const auto& dependency : dependencies) {
+        size_t index = find(dependency);
+        if (index == m_steps.size()) {
+            return false;
+        }
+        entry.dependencies.push_back(index);
+    }
+    entry.timing.name = std::move(name);
+    entry.run = std::move(step);
+    m_steps.push_back(std::move(entry));
+    return true;
+}
+
+bool StartupGraph::run() {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto elapsedMs = [start]() {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<std::thread> threads;
+    size_t running = 0;
+    for (auto& step : m_steps) {
+        step.timing.state = StepState::PENDING;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        // Start every step whose dependencies are done, skip those that can no longer run
+        bool progress = true;
+        while (progress) {
+            progress = false;
+            for (auto& step : m_steps) {
+                if (step.timing.state != StepState::PENDING) {
+                    continue;
+                }
+                bool ready = true;
+                bool blocked = false;
+                for (size_t dependency : step.dependencies) {
+                    StepState state = m_steps[dependency].timing.state;
+                    ready = ready && state == StepState::DONE;
+                    blocked = blocked || state == StepState::FAILED || state == StepState::SKIPPED;
+                }
+                if (blocked) {
+                    step.timing.state = StepState::SKIPPED;
+                    step.timing.startMs = step.timing.endMs = elapsedMs();
+                    progress = true;
+                } else if (ready) {
+                    step.timing.state = StepState::RUNNING;
+                    step.timing.startMs = elapsedMs();
+                    ++running;
+                    threads.emplace_back([&, current = &step]() {
+                        bool ok = false;
+                        try {
+                            ok = current->run();
+                        } catch (const std::exception& e) {
+                            LOG_ERROR("Startup step {} failed: {}", current->timing.name, e.what());
+                        }
+                        std::lock_guard<std::mutex> done(mutex);
+                        current->timing.endMs = elapsedMs();
+                        current->timing.state = ok ? StepState::DONE : StepState::FAILED;
+                        --running;
+                        finished.notify_one();
+                    });
+                }
+            }
+        }
+
+        if (running == 0) {
+            break;
+        }
+        finished.wait(lock);
+    }
+    lock.unlock();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return std::all_of(m_steps.begin(), m_steps.end(),
+                       [](const Step& step) { return step.timing.state == StepState::DONE; });
+}
+
+bool StartupGraph::succeeded(const std::string& name) const {
+    size_t index = find(name);
+    return index != m_steps.size() && m_steps[index].timing.state == StepState::DONE;
+}
+
+std::vector<StartupGraph::StepTiming> StartupGraph::getTimeline() const {
+    std::vector<StepTiming> timeline;
+    timeline.reserve(m_steps.size());
+    for (const auto& step : m_steps) {
+        timeline.push_back(step.timing);
+    }
+    return timeline;
+}
+
+void StartupGraph::logTimeline() const {
+    constexpr int kWidth = 40;
+    double total = 0;
+    size_t nameWidth = 0;
+    for (const auto& step : m_steps) {
+        total = std::max(total, step.timing.endMs);
+        nameWidth = std::max(nameWidth, step.timing.name.size());
+    }
+
+    LOG_INFO("Startup took {:.1f} ms", total);
+    for (const auto& step : m_steps) {
+        // Each step drawn as a bar on a common time axis
+        int begin = total > 0 ? std::min(static_cast<int>(step.timing.startMs / total * kWidth), kWidth - 1) : 0;
+        int end = total > 0 ? static_cast<int>(step.timing.endMs / total * kWidth) : 0;
+        std::string bar(kWidth, ' ');
+        std::fill(bar.begin() + begin, bar.begin() + std::max(end, begin + 1), '#');
+        LOG_INFO("  {:<{}} |{}| {:8.1f} -> {:8.1f} ms  {}", step.timing.name, nameWidth, bar,
+                 step.timing.startMs, step.timing.endMs, stateName(step.timing.state));
+    }
+}
+
+size_t StartupGraph::find(const std::string& name) const {
+    for (size_t i = 0; i < m_steps.size(); ++i) {
+        if (m_steps[i].timing.name == name) {
+            return i;
+        }
+    }
+    return m_steps.size();
+}
+
+} // namespace utils
+} // namespace deribit
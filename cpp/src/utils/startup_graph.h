@@ -0,0 +1,109 @@
+/**
+ * @file startup_graph.h
+ * @brief Concurrent startup steps with explicit dependencies
+ *
+ * This file contains the graph that runs the startup steps of the trading
+ * system (authentication, instrument download, connections, warmup,
+ * subscriptions) concurrently as soon as the steps they depend on are
+ * done, and reports when each step ran.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @class StartupGraph
+ * @brief Class running startup steps in dependency order, concurrently
+ *
+ * Steps are added with the names of the steps they depend on, which
+ * must already have been added, so the graph cannot have cycles. Every
+ * step runs on its own thread once all its dependencies succeeded; the
+ * dependents of a step that failed or threw are skipped.
+ */
+class StartupGraph {
+public:
+    /**
+     * @enum StepState
+     * @brief Enum representing the progress of a step
+     */
+    enum class StepState {
+        PENDING,
+        RUNNING,
+        DONE,
+        FAILED,
+        SKIPPED     // a dependency failed or was skipped
+    };
+
+    /**
+     * @struct StepTiming
+     * @brief Structure for when a step ran, relative to the start of run()
+     */
+    struct StepTiming {
+        std::string name;
+        StepState state = StepState::PENDING;
+        double startMs = 0;
+        double endMs = 0;
+    };
+
+    /**
+     * @brief Add a step
+     * @param name Step name
+     * @param dependencies Names of the steps that must succeed first
+     * @param step Callable returning true on success; exceptions count as failure
+     * @return true if added, false if the name is taken or a dependency is unknown
+     */
+    bool addStep(std::string name, std::vector<std::string> dependencies, std::function<bool()> step);
+
+    /**
+     * @brief Run all steps and wait for them to finish
+     * @return true if every step succeeded, false otherwise
+     */
+    bool run();
+
+    /**
+     * @brief Check whether a step succeeded
+     * @param name Step name
+     * @return true if the step ran and succeeded, false otherwise
+     */
+    bool succeeded(const std::string& name) const;
+
+    /**
+     * @brief Get the timeline of the last run
+     * @return Timings in the order the steps were added
+     */
+    std::vector<StepTiming> getTimeline() const;
+
+    /**
+     * @brief Log the timeline of the last run, one line per step
+     */
+    void logTimeline() const;
+
+private:
+    /**
+     * @struct Step
+     * @brief Structure for a registered step
+     */
+    struct Step {
+        StepTiming timing;
+        std::vector<size_t> dependencies;
+        std::function<bool()> run;
+    };
+
+    std::vector<Step> m_steps;
+
+    /**
+     * @brief Find a step by name
+     * @param name Step name
+     * @return Index, or m_steps.size() if not found
+     */
+    size_t find(const std::string& name) const;
+};
+
+} // namespace utils
+} // namespace deribit
@@ -0,0 +1,199 @@
+/**
+ * @file task_pool.cpp
+ * @brief Task pool implementation
+ */
+
+#include "task_pool.h"
+#include "config.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace deribit {
+namespace utils {
+
+namespace {
+
+// Worker running on the current thread, if any
+thread_local const TaskPool* t_pool = nullptr;
+thread_local size_t t_worker = 0;
+
+} // namespace
+
+TaskPoolConfig TaskPoolConfig::fromConfig(const Config& config) {
+    TaskPoolConfig result;
+    result.threads = std::max(1u, config.getUInt("task_pool.threads", result.threads));
+    result.cpus = config.getUIntList("task_pool.cpus");
+    return result;
+}
+
+TaskPool::TaskPool(TaskPoolConfig config)
+    : m_config(std::move(config)),
+      m_running(false),
+      m_queued(0),
+      m_next(0),
+      m_submitted(0),
+      m_failed(0) {}
+
+TaskPool::~TaskPool() {
+    stop();
+}
+
+bool TaskPool::start() {
+    std::lock_guard<std::mutex> lock(m_lifecycleMutex);
+    if (m_running.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    m_workers.clear();
+    for (unsigned int i = 0; i < m_config.threads; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    // submit() indexes the workers as soon as it sees the pool running
+    m_running.store(true, std::memory_order_release);
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->thread = std::thread(&TaskPool::work, this, i);
+    }
+    LOG_INFO("Task pool started with {} workers", m_workers.size());
+    return true;
+}
+
+void TaskPool::stop() {
+    std::lock_guard<std::mutex> lifecycleLock(m_lifecycleMutex);
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+bool TaskPool::submit(Task task) {
+    if (!m_running.load(std::memory_order_acquire) || m_workers.empty()) {
+        return false;
+    }
+
+    size_t index = t_pool == this ? t_worker : m_next.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+    {
+        Worker& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    m_submitted.fetch_add(1, std::memory_order_relaxed);
+    m_queued.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders the count with a worker about to sleep
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_one();
+    return true;
+}
+
+TaskPool::Stats TaskPool::getStats() const {
+    Stats stats;
+    stats.submitted = m_submitted.load(std::memory_order_relaxed);
+    stats.failed = m_failed.load(std::memory_order_relaxed);
+    for (const auto& worker : m_workers) {
+        stats.executed += worker->executed.load(std::memory_order_relaxed);
+        stats.stolen += worker->stolen.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void TaskPool::work(size_t index) {
+    t_pool = this;
+    t_worker = index;
+    configureThread(index);
+
+    Worker& self = *m_workers[index];
+    Task task;
+    for (;;) {
+        if (pop(index, task) || steal(index, task)) {
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            try {
+                task();
+            } catch (const std::exception& e) {
+                m_failed.fetch_add(1, std::memory_order_relaxed);
+                LOG_ERROR("Task pool task failed: {}", e.what());
+            }
+            task = nullptr;
+            self.executed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        // Queued tasks are drained before the pool stops
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [this]() {
+            return m_queued.load(std::memory_order_acquire) > 0 || !m_running.load(std::memory_order_acquire);
+        });
+        if (m_queued.load(std::memory_order_acquire) == 0 && !m_running.load(std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    t_pool = nullptr;
+}
+
+bool TaskPool::pop(size_t index, Task& task) {
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool TaskPool::steal(size_t index, Task& task) {
+    size_t count = m_workers.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *m_workers[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            m_workers[index]->stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::configureThread(size_t index) {
+#ifdef __linux__
+    std::string name = "task-pool-" + std::to_string(index);
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+
+    if (!m_config.cpus.empty()) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (unsigned int cpu : m_config.cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+            LOG_WARN("Failed to confine task pool worker {} to its cores", index);
+        }
+    }
+#else
+    (void)index;
+#endif
+}
+
+} // namespace utils
+} // namespace deribit
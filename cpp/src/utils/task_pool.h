@@ -0,0 +1,177 @@
+/**
+ * @file task_pool.h
+ * @brief Work-stealing thread pool for background computation
+ *
+ * This file contains the pool that runs work which is not latency
+ * critical (analytics, reports, compression, reconciliation) on its own
+ * threads, confined to a configurable set of cores so it never competes
+ * with the market data and order threads.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace deribit {
+namespace utils {
+
+class Config;
+
+/**
+ * @struct TaskPoolConfig
+ * @brief Structure for the task pool settings
+ */
+struct TaskPoolConfig {
+    unsigned int threads;
+    std::vector<unsigned int> cpus;   // cores the workers may run on, empty for any
+
+    TaskPoolConfig() : threads(2) {}
+
+    /**
+     * @brief Build from the "task_pool" section of the configuration
+     * @param config Configuration
+     * @return Task pool configuration
+     */
+    static TaskPoolConfig fromConfig(const Config& config);
+};
+
+/**
+ * @class TaskPool
+ * @brief Class for running tasks on a work-stealing pool of threads
+ *
+ * Every worker owns a deque. Tasks submitted from a worker go to the back
+ * of its own deque and are taken back LIFO, which keeps the data of a
+ * task split into subtasks in that worker's cache; other submissions are
+ * spread round-robin. An idle worker steals from the front of the other
+ * deques before sleeping.
+ *
+ * Tasks must not block on the trading threads; they may submit further
+ * tasks. Exceptions escaping a task are logged and dropped.
+ */
+class TaskPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @struct Stats
+     * @brief Structure for task pool counters
+     */
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t executed = 0;
+        uint64_t stolen = 0;
+        uint64_t failed = 0;
+    };
+
+    /**
+     * @brief Constructor
+     * @param config Pool configuration
+     */
+    explicit TaskPool(TaskPoolConfig config);
+
+    /**
+     * @brief Destructor, stops the workers
+     */
+    ~TaskPool();
+
+    // Prevent copying and assignment
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    /**
+     * @brief Start the worker threads
+     * @return true if started, false if already running
+     */
+    bool start();
+
+    /**
+     * @brief Stop the worker threads once the queued tasks have run
+     *
+     * Tasks submitted while stopping may be dropped.
+     */
+    void stop();
+
+    /**
+     * @brief Queue a task
+     * @param task Task
+     * @return true if queued, false if the pool is not running
+     */
+    bool submit(Task task);
+
+    /**
+     * @brief Get the number of worker threads
+     * @return Number of workers
+     */
+    size_t getThreadCount() const { return m_workers.size(); }
+
+    /**
+     * @brief Get the pool counters
+     * @return Counters
+     */
+    Stats getStats() const;
+
+private:
+    /**
+     * @struct Worker
+     * @brief Structure for the deque and thread of one worker
+     */
+    struct Worker {
+        std::deque<Task> tasks;
+        std::mutex mutex;
+        std::thread thread;
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> stolen{0};
+    };
+
+    TaskPoolConfig m_config;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<bool> m_running;
+    std::mutex m_lifecycleMutex;  // serializes start() and stop()
+    std::atomic<size_t> m_queued;
+    std::atomic<size_t> m_next;
+    std::atomic<uint64_t> m_submitted;
+    std::atomic<uint64_t> m_failed;
+
+    // Idle workers sleep here until a task is queued
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+
+    /**
+     * @brief Worker thread main loop
+     * @param index Worker index
+     */
+    void work(size_t index);
+
+    /**
+     * @brief Take a task from the back of the worker's own deque
+     * @param index Worker index
+     * @param task Output task
+     * @return true if a task was taken, false if the deque is empty
+     */
+    bool pop(size_t index, Task& task);
+
+    /**
+     * @brief Take a task from the front of another worker's deque
+     * @param index Index of the stealing worker
+     * @param task Output task
+     * @return true if a task was stolen, false if all deques are empty
+     */
+    bool steal(size_t index, Task& task);
+
+    /**
+     * @brief Name the worker thread and confine it to the configured cores
+     * @param index Worker index
+     */
+    void configureThread(size_t index);
+};
+
+} // namespace utils
+} // namespace deribit
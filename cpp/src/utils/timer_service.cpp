@@ -0,0 +1,163 @@
+/**
+ * @file timer_service.cpp
+ * @brief Process-wide timer service implementation
+ */
+
+#include "timer_service.h"
+
+#include <algorithm>
+
+namespace deribit {
+namespace utils {
+
+namespace {
+
+int64_t toNs(TimerService::Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+TimerService& TimerService::getInstance() {
+    static TimerService instance;
+    return instance;
+}
+
+TimerService::TimerService()
+    : m_wheel(std::chrono::microseconds(100)),
+      m_nextPeriodicId(1),
+      m_wakeup(false) {}
+
+TimerId TimerService::schedule(Clock::duration delay, Callback callback) {
+    TimerId id = m_wheel.schedule(delay, std::move(callback));
+    wakeIfEarlier(Clock::now() + delay);
+    return id;
+}
+
+TimerId TimerService::scheduleEvery(Clock::duration interval, Callback callback) {
+    auto timer = std::make_shared<PeriodicTimer>();
+    timer->interval = std::max<Clock::duration>(interval, m_wheel.getTick());
+    timer->callback = std::move(callback);
+    timer->next = Clock::now() + timer->interval;
+
+    TimerId id;
+    {
+        std::lock_guard<std::mutex> lock(m_periodicMutex);
+        id = kPeriodicFlag | m_nextPeriodicId++;
+        m_periodic.emplace(id, timer);
+    }
+    armPeriodic(id, timer);
+    return id;
+}
+
+bool TimerService::cancel(TimerId id) {
+    if ((id & kPeriodicFlag) == 0) {
+        return m_wheel.cancel(id);
+    }
+
+    std::shared_ptr<PeriodicTimer> timer;
+    {
+        std::lock_guard<std::mutex> lock(m_periodicMutex);
+        auto it = m_periodic.find(id);
+        if (it == m_periodic.end()) {
+            return false;
+        }
+        timer = std::move(it->second);
+        m_periodic.erase(it);
+        m_wheel.cancel(timer->current);
+    }
+    return true;
+}
+
+void TimerService::run(const std::atomic<bool>& running) {
+    m_stopped = false;
+    while (running && !m_stopped) {
+        m_wheel.advance();
+
+        // Publish the sleep before looking at the wheel, so a timer
+        // scheduled in between wakes the loop instead of being overslept
+        auto now = Clock::now();
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_sleepUntilNs.store(toNs(now + kMaxSleep), std::memory_order_release);
+        auto wakeAt = std::min(m_wheel.nextExpiry(), now + kMaxSleep);
+        if (wakeAt <= now) {
+            m_sleepUntilNs.store(0, std::memory_order_release);
+            continue;
+        }
+        m_sleepUntilNs.store(toNs(wakeAt), std::memory_order_release);
+        m_wakeCondition.wait_until(lock, wakeAt, [this]() { return m_wakeup; });
+        m_wakeup = false;
+        m_sleepUntilNs.store(0, std::memory_order_release);
+    }
+}
+
+size_t TimerService::poll() {
+    return m_wheel.advance();
+}
+
+void TimerService::stop() {
+    m_stopped = true;
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeup = true;
+    }
+    m_wakeCondition.notify_one();
+}
+
+void TimerService::armPeriodic(TimerId id, const std::shared_ptr<PeriodicTimer>& timer) {
+    auto delay = timer->next - Clock::now();
+    TimerId current = m_wheel.schedule(delay, [this, id]() {
+        runPeriodic(id);
+    });
+
+    bool cancelled = false;
+    {
+        std::lock_guard<std::mutex> lock(m_periodicMutex);
+        if (m_periodic.count(id) != 0) {
+            timer->current = current;
+        } else {
+            cancelled = true;
+        }
+    }
+    if (cancelled) {
+        m_wheel.cancel(current);
+        return;
+    }
+    wakeIfEarlier(timer->next);
+}
+
+void TimerService::runPeriodic(TimerId id) {
+    std::shared_ptr<PeriodicTimer> timer;
+    {
+        std::lock_guard<std::mutex> lock(m_periodicMutex);
+        auto it = m_periodic.find(id);
+        if (it == m_periodic.end()) {
+            return;
+        }
+        timer = it->second;
+    }
+
+    timer->callback();
+
+    auto now = Clock::now();
+    timer->next += timer->interval;
+    if (timer->next <= now) {
+        timer->next = now + timer->interval;
+    }
+    armPeriodic(id, timer);
+}
+
+void TimerService::wakeIfEarlier(Clock::time_point due) {
+    int64_t sleepUntil = m_sleepUntilNs.load(std::memory_order_acquire);
+    if (sleepUntil == 0 || toNs(due) >= sleepUntil) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeup = true;
+    }
+    m_wakeCondition.notify_one();
+}
+
+} // namespace utils
+} // namespace deribit
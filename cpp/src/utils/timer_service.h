@@ -0,0 +1,161 @@
+/**
+ * @file timer_service.h
+ * @brief Process-wide timer service
+ *
+ * This file contains the timer service shared by the API client, the
+ * WebSocket server and the metrics collector. It runs the application's
+ * event loop: one thread drives a hierarchical timer wheel and sleeps
+ * until the next timer is due.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include "timer_wheel.h"
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @class TimerService
+ * @brief Class for scheduling one-shot and periodic callbacks
+ *
+ * schedule(), scheduleEvery() and cancel() may be called from any thread.
+ * Callbacks run on the thread inside run() and must not block; work that
+ * may block belongs on another thread.
+ */
+class TimerService {
+public:
+    using Callback = TimerWheel::Callback;
+    using Clock = TimerWheel::Clock;
+
+    /**
+     * @brief Get the instance (singleton)
+     * @return Reference to TimerService instance
+     */
+    static TimerService& getInstance();
+
+    /**
+     * @brief Schedule a one-shot callback
+     * @param delay Delay from now
+     * @param callback Callback function
+     * @return Timer ID
+     */
+    TimerId schedule(Clock::duration delay, Callback callback);
+
+    /**
+     * @brief Schedule a periodic callback
+     *
+     * The first call happens one interval from now. Runs that were missed
+     * because the loop was late are skipped rather than queued up.
+     *
+     * @param interval Interval between calls
+     * @param callback Callback function
+     * @return Timer ID, valid until cancelled
+     */
+    TimerId scheduleEvery(Clock::duration interval, Callback callback);
+
+    /**
+     * @brief Cancel a one-shot or periodic timer
+     * @param id Timer ID
+     * @return true if the timer was pending, false otherwise
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief Run the event loop on the calling thread
+     *
+     * Returns once running is false or stop() was called. running is
+     * checked at least every kMaxSleep, so it may be cleared from a
+     * signal handler.
+     *
+     * @param running Flag to keep running
+     */
+    void run(const std::atomic<bool>& running);
+
+    /**
+     * @brief Fire the timers that are due without blocking
+     * @return Number of timers fired
+     */
+    size_t poll();
+
+    /**
+     * @brief Make run() return
+     */
+    void stop();
+
+    /**
+     * @brief Get the number of pending timers
+     * @return Number of pending one-shot timers plus periodic timers
+     */
+    size_t size() const { return m_wheel.size(); }
+
+    /**
+     * @brief Get the timer resolution
+     * @return Tick length
+     */
+    std::chrono::microseconds getResolution() const { return m_wheel.getTick(); }
+
+    /**
+     * @brief Longest time run() sleeps without checking its running flag
+     */
+    static constexpr std::chrono::milliseconds kMaxSleep{50};
+
+private:
+    // Private constructor for singleton
+    TimerService();
+
+    // Prevent copying and assignment
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    /**
+     * @struct PeriodicTimer
+     * @brief Structure for a periodic timer between runs
+     */
+    struct PeriodicTimer {
+        Clock::duration interval;
+        Callback callback;
+        Clock::time_point next;
+        TimerId current = 0;
+    };
+
+    // Periodic IDs have the top bit set, which wheel IDs never do
+    static constexpr TimerId kPeriodicFlag = TimerId{1} << 63;
+
+    TimerWheel m_wheel;
+    std::map<TimerId, std::shared_ptr<PeriodicTimer>> m_periodic;
+    std::mutex m_periodicMutex;
+    uint64_t m_nextPeriodicId;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<int64_t> m_sleepUntilNs{0};
+    bool m_wakeup;
+    std::atomic<bool> m_stopped{false};
+
+    /**
+     * @brief Schedule the next run of a periodic timer
+     */
+    void armPeriodic(TimerId id, const std::shared_ptr<PeriodicTimer>& timer);
+
+    /**
+     * @brief Run a periodic timer and schedule its next run
+     */
+    void runPeriodic(TimerId id);
+
+    /**
+     * @brief Wake run() if a timer is due before it would wake up
+     */
+    void wakeIfEarlier(Clock::time_point due);
+};
+
+} // namespace utils
+} // namespace deribit
@@ -0,0 +1,193 @@
+/**
+ * @file timer_wheel.cpp
+ * @brief Hierarchical timer wheel implementation
+ */
+
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+namespace deribit {
+namespace utils {
+
+namespace {
+
+constexpr uint64_t kMaxDistance = (uint64_t{1} << (TimerWheel::kLevelBits * TimerWheel::kLevels)) - 1;
+
+} // namespace
+
+TimerWheel::TimerWheel(std::chrono::microseconds tick)
+    : m_tick(tick.count() > 0 ? tick : std::chrono::microseconds(1)),
+      m_start(Clock::now()),
+      m_currentTick(0),
+      m_slots(kLevels * kSlots, kNil),
+      m_size(0) {}
+
+TimerId TimerWheel::schedule(Clock::duration delay, Callback callback) {
+    // Round the due time up to a tick boundary so a timer never fires early
+    auto tickNs = std::chrono::duration_cast<std::chrono::nanoseconds>(m_tick).count();
+    auto dueNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start + delay).count();
+    auto dueTick = static_cast<uint64_t>(std::max<int64_t>((dueNs + tickNs - 1) / tickNs, 0));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t index;
+    if (!m_free.empty()) {
+        index = m_free.back();
+        m_free.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_timers.size());
+        m_timers.emplace_back();
+    }
+
+    Timer& timer = m_timers[index];
+    timer.callback = std::move(callback);
+    timer.expiryTick = std::max(dueTick, m_currentTick + 1);
+    timer.active = true;
+    link(index);
+    ++m_size;
+    return (static_cast<TimerId>(timer.generation) << 32) | (index + 1);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    if (id == 0) {
+        return false;
+    }
+    auto index = static_cast<uint32_t>(id & 0xFFFFFFFFu) - 1;
+    auto generation = static_cast<uint32_t>(id >> 32);
+
+    Callback callback;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (index >= m_timers.size() || !m_timers[index].active ||
+            m_timers[index].generation != generation) {
+            return false;
+        }
+        // Destroy the callback outside the lock, it may own arbitrary state
+        callback = std::move(m_timers[index].callback);
+        release(index);
+    }
+    return true;
+}
+
+size_t TimerWheel::advance(Clock::time_point now) {
+    auto target = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - m_start) / m_tick);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (m_currentTick < target) {
+            if (m_size == 0) {
+                m_currentTick = target;
+                break;
+            }
+
+            uint64_t tick = ++m_currentTick;
+            for (uint32_t level = 1; level < kLevels; ++level) {
+                if (((tick >> ((level - 1) * kLevelBits)) & (kSlots - 1)) != 0) {
+                    break;
+                }
+                cascade(level);
+            }
+
+            uint32_t index = m_slots[tick & (kSlots - 1)];
+            while (index != kNil) {
+                uint32_t next = m_timers[index].next;
+                m_due.push_back(std::move(m_timers[index].callback));
+                release(index);
+                index = next;
+            }
+        }
+    }
+
+    size_t fired = m_due.size();
+    for (auto& callback : m_due) {
+        callback();
+    }
+    m_due.clear();
+    return fired;
+}
+
+size_t TimerWheel::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+TimerWheel::Clock::time_point TimerWheel::nextExpiry() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_size == 0) {
+        return Clock::time_point::max();
+    }
+
+    // The finest level holds every timer due within one turn; the first
+    // cascade bounds the search since it may bring earlier timers down
+    uint64_t tick = m_currentTick + 1;
+    for (; tick < m_currentTick + kSlots; ++tick) {
+        if (m_slots[tick & (kSlots - 1)] != kNil || (tick & (kSlots - 1)) == 0) {
+            break;
+        }
+    }
+    return m_start + std::chrono::duration_cast<Clock::duration>(m_tick * static_cast<int64_t>(tick));
+}
+
+void TimerWheel::link(uint32_t index) {
+    Timer& timer = m_timers[index];
+    uint64_t distance = timer.expiryTick > m_currentTick ? timer.expiryTick - m_currentTick : 0;
+    uint64_t expiry = timer.expiryTick;
+    if (distance > kMaxDistance) {
+        expiry = m_currentTick + kMaxDistance;
+        distance = kMaxDistance;
+    }
+
+    uint32_t level = 0;
+    while (level + 1 < kLevels && distance >= (uint64_t{1} << ((level + 1) * kLevelBits))) {
+        ++level;
+    }
+    timer.slot = level * kSlots + static_cast<uint32_t>((expiry >> (level * kLevelBits)) & (kSlots - 1));
+
+    uint32_t& head = m_slots[timer.slot];
+    timer.prev = kNil;
+    timer.next = head;
+    if (head != kNil) {
+        m_timers[head].prev = index;
+    }
+    head = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Timer& timer = m_timers[index];
+    if (timer.prev != kNil) {
+        m_timers[timer.prev].next = timer.next;
+    } else {
+        m_slots[timer.slot] = timer.next;
+    }
+    if (timer.next != kNil) {
+        m_timers[timer.next].prev = timer.prev;
+    }
+    timer.prev = kNil;
+    timer.next = kNil;
+}
+
+void TimerWheel::release(uint32_t index) {
+    unlink(index);
+    Timer& timer = m_timers[index];
+    timer.active = false;
+    timer.callback = nullptr;
+    timer.generation = (timer.generation + 1) & 0x7FFFFFFFu;  // keeps the top ID bit clear
+    m_free.push_back(index);
+    --m_size;
+}
+
+void TimerWheel::cascade(uint32_t level) {
+    uint32_t slot = level * kSlots +
+                    static_cast<uint32_t>((m_currentTick >> (level * kLevelBits)) & (kSlots - 1));
+    uint32_t index = m_slots[slot];
+    m_slots[slot] = kNil;
+    while (index != kNil) {
+        uint32_t next = m_timers[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+} // namespace utils
+} // namespace deribit
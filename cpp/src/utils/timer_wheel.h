@@ -0,0 +1,151 @@
+/**
+ * @file timer_wheel.h
+ * @brief Hierarchical timer wheel
+ *
+ * This file contains a timer wheel for large numbers of timers such as
+ * request deadlines, heartbeats and periodic jobs, where a thread or OS
+ * timer per timer would be too expensive.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+namespace deribit {
+namespace utils {
+
+/**
+ * @brief Timer identifier, 0 is never a valid timer and the top bit is never set
+ */
+using TimerId = uint64_t;
+
+/**
+ * @class TimerWheel
+ * @brief Class for scheduling callbacks with O(1) insertion and cancellation
+ *
+ * Time is divided into ticks. The wheel has kLevels levels of kSlots slots;
+ * level n covers kSlots^(n+1) ticks at a resolution of kSlots^n ticks. A
+ * timer is linked into the coarsest level needed for its distance, and is
+ * moved one level down each time the finer level wraps, so every timer is
+ * touched at most kLevels times and firing never scans pending timers that
+ * are not due. Timers are stored in a slab indexed by their id, so
+ * cancelling does not search.
+ *
+ * schedule() and cancel() may be called from any thread. advance() must
+ * be called from a single thread at least once per tick for full
+ * precision; callbacks run on that thread, outside the wheel's lock.
+ */
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr uint32_t kLevelBits = 8;
+    static constexpr uint32_t kSlots = 1u << kLevelBits;
+    static constexpr uint32_t kLevels = 4;  // 2^32 ticks, about 49 days at 1ms
+
+    /**
+     * @brief Constructor
+     * @param tick Tick length, the timer resolution
+     */
+    explicit TimerWheel(std::chrono::microseconds tick = std::chrono::milliseconds(1));
+
+    /**
+     * @brief Schedule a callback
+     * @param delay Delay from now, rounded up to whole ticks
+     * @param callback Callback function
+     * @return Timer ID
+     */
+    TimerId schedule(Clock::duration delay, Callback callback);
+
+    /**
+     * @brief Cancel a timer
+     * @param id Timer ID
+     * @return true if the timer was pending, false if it fired or was cancelled already
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief Fire all timers that are due
+     * @param now Current time
+     * @return Number of timers fired
+     */
+    size_t advance(Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Get the number of pending timers
+     * @return Number of pending timers
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the time by which advance() should next be called
+     *
+     * Exact for timers within the current turn of the finest level,
+     * otherwise the time of the next cascade, which is never later than
+     * the earliest timer.
+     *
+     * @return Time point, or Clock::time_point::max() if no timer is pending
+     */
+    Clock::time_point nextExpiry() const;
+
+    /**
+     * @brief Get the tick length
+     * @return Tick length
+     */
+    std::chrono::microseconds getTick() const { return m_tick; }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    /**
+     * @struct Timer
+     * @brief Structure for a slab entry, linked into its slot when active
+     */
+    struct Timer {
+        Callback callback;
+        uint64_t expiryTick = 0;
+        uint32_t generation = 0;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t slot = 0;  // index into m_slots
+        bool active = false;
+    };
+
+    std::chrono::microseconds m_tick;
+    Clock::time_point m_start;
+    uint64_t m_currentTick;
+    std::vector<Timer> m_timers;
+    std::vector<uint32_t> m_free;
+    std::vector<uint32_t> m_slots;  // kLevels * kSlots list heads
+    size_t m_size;
+    std::vector<Callback> m_due;    // reused by advance()
+    mutable std::mutex m_mutex;
+
+    /**
+     * @brief Link a timer into the level and slot matching its distance
+     */
+    void link(uint32_t index);
+
+    /**
+     * @brief Unlink a timer from its slot
+     */
+    void unlink(uint32_t index);
+
+    /**
+     * @brief Unlink a timer and release its slab entry
+     */
+    void release(uint32_t index);
+
+    /**
+     * @brief Relink all timers of a slot, moving them to finer levels
+     */
+    void cascade(uint32_t level);
+};
+
+} // namespace utils
+} // namespace deribit
@@ -0,0 +1,88 @@
+/**
+ * @file warmup.cpp
+ * @brief Warmup implementation
+ */
+
+#include "warmup.h"
+#include "config.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace deribit {
+namespace utils {
+
+WarmupConfig WarmupConfig::fromConfig(const Config& config) {
+    WarmupConfig result;
+    result.enabled = config.getBool("warmup.enabled", result.enabled);
+    result.minRounds = config.getUInt("warmup.min_rounds", result.minRounds);
+    result.maxRounds = std::max(result.minRounds, config.getUInt("warmup.max_rounds", result.maxRounds));
+    result.window = std::max(1u, config.getUInt("warmup.window", result.window));
+    result.tolerance = config.getDouble("warmup.tolerance", result.tolerance);
+    return result;
+}
+
+Warmup::Warmup(WarmupConfig config) : m_config(std::move(config)) {}
+
+void Warmup::addStage(std::string name, std::function<void(uint64_t)> round) {
+    m_stages.push_back(Stage{std::move(name), std::move(round)});
+}
+
+bool Warmup::run() {
+    m_results.clear();
+    if (!m_config.enabled) {
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool stable = true;
+    for (const auto& stage : m_stages) {
+        StageResult result = runStage(stage);
+        if (result.stable) {
+            LOG_INFO("Warmup {}: stable at {:.0f} ns/round after {} rounds (first {:.0f} ns)",
+                     result.name, result.lastNs, result.rounds, result.firstNs);
+        } else {
+            LOG_WARN("Warmup {}: not stable after {} rounds, {:.0f} ns/round (first {:.0f} ns)",
+                     result.name, result.rounds, result.lastNs, result.firstNs);
+        }
+        stable = stable && result.stable;
+        m_results.push_back(std::move(result));
+    }
+    LOG_INFO("Warmup finished in {} ms",
+             std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    return stable;
+}
+
+Warmup::StageResult Warmup::runStage(const Stage& stage) {
+    StageResult result;
+    result.name = stage.name;
+
+    std::vector<double> samples(m_config.window);
+    double previous = 0;
+    while (result.rounds < m_config.maxRounds) {
+        for (auto& sample : samples) {
+            auto begin = std::chrono::steady_clock::now();
+            stage.round(result.rounds++);
+            sample = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        double median = samples[samples.size() / 2];
+
+        if (result.firstNs == 0) {
+            result.firstNs = median;
+        }
+        result.lastNs = median;
+        if (result.rounds >= m_config.minRounds && previous > 0 &&
+            std::abs(median - previous) <= m_config.tolerance * previous) {
+            result.stable = true;
+            break;
+        }
+        previous = median;
+    }
+    return result;
+}
+
+} // namespace utils
+} // namespace deribit
@@ -0,0 +1,117 @@
+/**
+ * @file warmup.h
+ * @brief Startup warmup of the trading code paths
+ *
+ * This file contains the warmup run between authentication and the start
+ * of live data. It repeats synthetic work through the hot paths until
+ * their latency stops improving, so the first live messages and orders
+ * find warm caches, grown pools and trained branch predictors.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace deribit {
+namespace utils {
+
+class Config;
+
+/**
+ * @struct WarmupConfig
+ * @brief Structure for the warmup settings
+ */
+struct WarmupConfig {
+    bool enabled;
+    unsigned int minRounds;     // rounds per stage before checking for stability
+    unsigned int maxRounds;     // rounds per stage before giving up
+    unsigned int window;        // rounds per latency sample
+    double tolerance;           // relative change between samples considered stable
+
+    WarmupConfig() : enabled(true), minRounds(1000), maxRounds(20000), window(200), tolerance(0.05) {}
+
+    /**
+     * @brief Build from the "warmup" section of the configuration
+     * @param config Configuration
+     * @return Warmup configuration
+     */
+    static WarmupConfig fromConfig(const Config& config);
+};
+
+/**
+ * @class Warmup
+ * @brief Class running warmup stages until their latency is stable
+ *
+ * Each stage is a callable doing one round of synthetic work. A stage
+ * runs in windows of rounds; the median round latency of each window is
+ * compared with the previous one, and the stage is stable once they
+ * differ by less than the tolerance after the minimum number of rounds.
+ * Stages run in the order they were added, on the calling thread; thread
+ * local state such as the arena only warms up on the thread that runs them.
+ */
+class Warmup {
+public:
+    /**
+     * @struct StageResult
+     * @brief Structure for the outcome of a stage
+     */
+    struct StageResult {
+        std::string name;
+        uint64_t rounds = 0;
+        double firstNs = 0;     // median latency of the first window
+        double lastNs = 0;      // median latency of the last window
+        bool stable = false;
+    };
+
+    /**
+     * @brief Constructor
+     * @param config Warmup configuration
+     */
+    explicit Warmup(WarmupConfig config);
+
+    /**
+     * @brief Add a stage
+     * @param name Stage name, for the report
+     * @param round Callable doing one round, given the round number
+     */
+    void addStage(std::string name, std::function<void(uint64_t)> round);
+
+    /**
+     * @brief Run all stages and log the results
+     * @return true if every stage stabilized or warmup is disabled, false otherwise
+     */
+    bool run();
+
+    /**
+     * @brief Get the results of the last run
+     * @return Results in stage order
+     */
+    const std::vector<StageResult>& getResults() const { return m_results; }
+
+private:
+    /**
+     * @struct Stage
+     * @brief Structure for a registered stage
+     */
+    struct Stage {
+        std::string name;
+        std::function<void(uint64_t)> round;
+    };
+
+    WarmupConfig m_config;
+    std::vector<Stage> m_stages;
+    std::vector<StageResult> m_results;
+
+    /**
+     * @brief Run one stage until stable or out of rounds
+     * @param stage Stage
+     * @return Result
+     */
+    StageResult runStage(const Stage& stage);
+};
+
+} // namespace utils
+} // namespace deribit
@@ -0,0 +1,178 @@
+/**
+ * @file feed_arbiter.cpp
+ * @brief Arbitration between redundant market data connections
+ */
+
+#include "feed_arbiter.h"
+#include "../api/deribit_api.h"
+#include "../utils/metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+namespace deribit {
+namespace websocket {
+
+namespace {
+
+// Duplicates between two lag samples
+const uint64_t kLagSampleInterval = 64;
+
+/**
+ * @brief Parse the integer value of a key found in serialized JSON
+ *
+ * Notification data is produced by a JSON serializer without whitespace,
+ * so a plain scan for "key": is sufficient and avoids a second parse.
+ *
+ * @param pos Position of the key in data, npos if not found
+ */
+bool parseIntAt(std::string_view data, size_t pos, std::string_view quotedKey, int64_t& value) {
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+
+    pos += quotedKey.size();
+    bool negative = pos < data.size() && data[pos] == '-';
+    if (negative) {
+        ++pos;
+    }
+
+    size_t digits = 0;
+    int64_t parsed = 0;
+    for (; pos < data.size() && data[pos] >= '0' && data[pos] <= '9'; ++pos, ++digits) {
+        parsed = parsed * 10 + (data[pos] - '0');
+    }
+    if (digits == 0) {
+        return false;
+    }
+    value = negative ? -parsed : parsed;
+    return true;
+}
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+FeedArbiter::FeedArbiter(size_t feedCount)
+    : m_feedCount(feedCount > 0 ? feedCount : 1),
+      m_counters(new FeedCounters[m_feedCount]) {}
+
+bool FeedArbiter::extractSequence(std::string_view channel, std::string_view data, int64_t& sequence, bool& unique) {
+    static constexpr std::string_view kChangeId = "\"change_id\":";
+    static constexpr std::string_view kTradeSeq = "\"trade_seq\":";
+    static constexpr std::string_view kTimestamp = "\"timestamp\":";
+
+    // The channel names the key, so each copy is scanned for one key only;
+    // change_id and timestamp precede the price levels, the last trade
+    // carries the highest trade_seq
+    unique = true;
+    if (channel.substr(0, 5) == "book.") {
+        return parseIntAt(data, data.find(kChangeId), kChangeId, sequence);
+    }
+    if (channel.substr(0, 7) == "trades.") {
+        return parseIntAt(data, data.rfind(kTradeSeq), kTradeSeq, sequence);
+    }
+    unique = false;
+    return parseIntAt(data, data.find(kTimestamp), kTimestamp, sequence);
+}
+
+bool FeedArbiter::isSnapshot(std::string_view data) {
+    return data.find("\"type\":\"snapshot\"") != std::string_view::npos;
+}
+
+bool FeedArbiter::accept(size_t feed, const api::WSMessageView& msg) {
+    if (feed >= m_feedCount) {
+        return false;
+    }
+    m_counters[feed].received.fetch_add(1, std::memory_order_relaxed);
+
+    int64_t sequence = 0;
+    bool unique = true;
+    if (!extractSequence(msg.channel, msg.data, sequence, unique)) {
+        bool leader = m_leader.load(std::memory_order_relaxed) == feed;
+        if (leader) {
+            m_counters[feed].won.fetch_add(1, std::memory_order_relaxed);
+        }
+        return leader;
+    }
+
+    ChannelState& state = getChannelState(msg.channel);
+    bool accepted;
+    if (unique) {
+        accepted = sequence > state.lastSequence || (sequence == state.lastSequence && isSnapshot(msg.data));
+        if (accepted) {
+            state.lastSequence = sequence;
+        }
+    } else {
+        accepted = acceptTimestamp(state, sequence, std::hash<std::string_view>()(msg.data));
+    }
+
+    if (!accepted) {
+        // Sampled, as this runs for every duplicate with delivery locked
+        if (++m_duplicates % kLagSampleInterval == 0 && state.lastAcceptedNs > 0) {
+            utils::Metrics::getInstance().recordLatency(
+                "market_data", "arbitration_lag", (nowNs() - state.lastAcceptedNs) / 1e6);
+        }
+        return false;
+    }
+
+    state.lastAcceptedNs = nowNs();
+    m_leader.store(feed, std::memory_order_relaxed);
+    m_counters[feed].won.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool FeedArbiter::acceptTimestamp(ChannelState& state, int64_t timestamp, uint64_t hash) {
+    if (timestamp < state.lastSequence) {
+        return false;
+    }
+    if (timestamp > state.lastSequence) {
+        state.lastSequence = timestamp;
+        state.hashes[0] = hash;
+        state.hashCount = 1;
+        return true;
+    }
+
+    size_t stored = std::min(state.hashCount, kHashesPerTimestamp);
+    for (size_t i = 0; i < stored; ++i) {
+        if (state.hashes[i] == hash) {
+            return false;
+        }
+    }
+    // Past the remembered hashes, older ones are overwritten in turn
+    state.hashes[state.hashCount % kHashesPerTimestamp] = hash;
+    ++state.hashCount;
+    return true;
+}
+
+void FeedArbiter::reset(const std::string& channel) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_channels.find(channel);
+    if (it != m_channels.end()) {
+        it->second = ChannelState();
+    }
+}
+
+FeedStats FeedArbiter::getStats(size_t feed) const {
+    FeedStats stats;
+    if (feed < m_feedCount) {
+        stats.received = m_counters[feed].received.load(std::memory_order_relaxed);
+        stats.won = m_counters[feed].won.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+FeedArbiter::ChannelState& FeedArbiter::getChannelState(std::string_view channel) {
+    auto it = m_channels.find(channel);
+    if (it == m_channels.end()) {
+        it = m_channels.emplace(std::string(channel), ChannelState()).first;
+    }
+    return it->second;
+}
+
+} // namespace websocket
+} // namespace deribit
@@ -0,0 +1,174 @@
+/**
+ * @file feed_arbiter.h
+ * @brief Arbitration between redundant market data connections
+ *
+ * This file contains the arbiter which deduplicates notifications
+ * received on several WebSocket connections subscribed to the same
+ * channels, keeping whichever copy arrives first.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace deribit {
+
+namespace api {
+struct WSMessageView;
+} // namespace api
+
+namespace websocket {
+
+/**
+ * @struct FeedStats
+ * @brief Structure for per-connection arbitration statistics
+ */
+struct FeedStats {
+    uint64_t received;  // notifications received on the connection
+    uint64_t won;       // notifications forwarded because this copy arrived first
+
+    FeedStats() : received(0), won(0) {}
+};
+
+/**
+ * @class FeedArbiter
+ * @brief Class for arbitrating notifications from redundant connections
+ *
+ * Each notification is keyed by its channel and a sequence number taken
+ * from the data: change_id for book channels, trade_seq for trades and
+ * timestamp otherwise. The time a duplicate arrived behind its first copy
+ * is sampled into the "arbitration_lag" metric. A copy is forwarded only if its sequence is newer
+ * than the last one forwarded on the channel. Snapshots are also forwarded
+ * when they repeat the last sequence, so a book invalidated by a full
+ * outage can rebuild. Timestamps are not unique, so a copy repeating the
+ * last timestamp is still forwarded if its payload differs from those
+ * already forwarded at that timestamp. Notifications without a sequence
+ * are forwarded from the connection that most recently won a race.
+ *
+ * The I/O threads of all connections call accept() and deliver what it
+ * accepted while holding lockDelivery(), so accepted notifications reach
+ * the consumer in the order they were accepted.
+ */
+class FeedArbiter {
+public:
+    /**
+     * @brief Constructor
+     * @param feedCount Number of redundant connections
+     */
+    explicit FeedArbiter(size_t feedCount);
+
+    /**
+     * @brief Lock delivery, to be held across accept() and forwarding
+     * @return Lock on the arbiter
+     */
+    std::unique_lock<std::mutex> lockDelivery() {
+        return std::unique_lock<std::mutex>(m_mutex);
+    }
+
+    /**
+     * @brief Decide whether a notification should be forwarded
+     *
+     * Must be called with lockDelivery() held.
+     *
+     * @param feed Index of the connection the notification arrived on
+     * @param msg WebSocket message
+     * @return true if this is the first copy, false if it is a duplicate
+     */
+    bool accept(size_t feed, const api::WSMessageView& msg);
+
+    /**
+     * @brief Forget the sequence of a channel, e.g. before resubscribing
+     * @param channel Channel name
+     */
+    void reset(const std::string& channel);
+
+    /**
+     * @brief Get the number of connections
+     * @return Number of connections
+     */
+    size_t getFeedCount() const { return m_feedCount; }
+
+    /**
+     * @brief Get arbitration statistics for a connection
+     * @param feed Connection index
+     * @return FeedStats structure
+     */
+    FeedStats getStats(size_t feed) const;
+
+    /**
+     * @brief Extract the arbitration sequence from notification data
+     * @param channel Channel name, which selects the sequence key
+     * @param data Serialized "data" object of the notification
+     * @param sequence Output sequence number
+     * @param unique Output whether the sequence identifies one notification
+     *               (change_id, trade_seq) rather than a time (timestamp)
+     * @return true if a sequence was found, false otherwise
+     */
+    static bool extractSequence(std::string_view channel, std::string_view data, int64_t& sequence, bool& unique);
+
+    /**
+     * @brief Check whether notification data is a book snapshot
+     * @param data Serialized "data" object of the notification
+     * @return true if a snapshot, false otherwise
+     */
+    static bool isSnapshot(std::string_view data);
+
+private:
+    // Payload hashes remembered for the last timestamp of a channel
+    static constexpr size_t kHashesPerTimestamp = 8;
+
+    /**
+     * @struct ChannelState
+     * @brief Structure for the last forwarded sequence of a channel
+     */
+    struct ChannelState {
+        int64_t lastSequence;
+        int64_t lastAcceptedNs;
+        uint64_t hashes[kHashesPerTimestamp];   // forwarded at lastSequence, timestamp keys only
+        size_t hashCount;
+
+        ChannelState() : lastSequence(INT64_MIN), lastAcceptedNs(0), hashes{}, hashCount(0) {}
+    };
+
+    /**
+     * @struct FeedCounters
+     * @brief Structure for per-connection counters
+     */
+    struct FeedCounters {
+        std::atomic<uint64_t> received{0};
+        std::atomic<uint64_t> won{0};
+    };
+
+    size_t m_feedCount;
+    std::unique_ptr<FeedCounters[]> m_counters;
+    std::atomic<size_t> m_leader{0};
+    std::map<std::string, ChannelState, std::less<>> m_channels;   // guarded by m_mutex
+    uint64_t m_duplicates = 0;                                      // guarded by m_mutex
+    std::mutex m_mutex;
+
+    /**
+     * @brief Get or create the state of a channel, with m_mutex held
+     * @param channel Channel name
+     * @return Reference to the channel state
+     */
+    ChannelState& getChannelState(std::string_view channel);
+
+    /**
+     * @brief Check a timestamp-keyed copy against those already forwarded
+     * @param state Channel state
+     * @param timestamp Timestamp of the copy
+     * @param hash Payload hash of the copy
+     * @return true if the copy is new, false if it is a duplicate
+     */
+    static bool acceptTimestamp(ChannelState& state, int64_t timestamp, uint64_t hash);
+};
+
+} // namespace websocket
+} // namespace deribit
@@ -0,0 +1,154 @@
+/**
+ * @file tls_context.cpp
+ * @brief Shared TLS client configuration implementation
+ */
+
+#include "tls_context.h"
+
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+
+namespace deribit {
+namespace websocket {
+
+namespace ssl = boost::asio::ssl;
+
+namespace {
+
+// AEAD only; the first entries are negotiated when the server allows it
+const char* const kAesFirstCiphers =
+    "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"
+    "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384:"
+    "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305";
+const char* const kChaChaFirstCiphers =
+    "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305:"
+    "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"
+    "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384";
+const char* const kAesFirstSuites =
+    "TLS_AES_128_GCM_SHA256:TLS_CHACHA20_POLY1305_SHA256:TLS_AES_256_GCM_SHA384";
+const char* const kChaChaFirstSuites =
+    "TLS_CHACHA20_POLY1305_SHA256:TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384";
+
+// ex_data slot pointing back to the owning TlsContext; the app data slot
+// is already used by boost::asio::ssl::context for its verify callback
+int contextIndex() {
+    static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
+} // namespace
+
+TlsContext& TlsContext::getInstance() {
+    static TlsContext instance;
+    return instance;
+}
+
+TlsContext::TlsContext(bool verifyPeer) : m_context(ssl::context::tls_client) {
+    SSL_CTX* ctx = m_context.native_handle();
+
+    // TLS 1.3 is preferred, saving a round trip on full handshakes; TLS 1.2
+    // stays allowed with AEAD ciphers only, and older versions are refused
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    m_context.set_options(ssl::context::default_workarounds | ssl::context::no_compression);
+
+    bool aes = hasAesAcceleration();
+    SSL_CTX_set_cipher_list(ctx, aes ? kAesFirstCiphers : kChaChaFirstCiphers);
+    SSL_CTX_set_ciphersuites(ctx, aes ? kAesFirstSuites : kChaChaFirstSuites);
+
+    // Sessions are cached per host by this class rather than by OpenSSL,
+    // which only keys client sessions by the SSL object
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx, &TlsContext::onNewSession);
+    SSL_CTX_set_ex_data(ctx, contextIndex(), this);
+
+    if (verifyPeer) {
+        m_context.set_default_verify_paths();
+        m_context.set_verify_mode(ssl::verify_peer);
+    } else {
+        m_context.set_verify_mode(ssl::verify_none);
+    }
+}
+
+TlsContext::~TlsContext() {
+    clearSessions();
+}
+
+bool TlsContext::hasAesAcceleration() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_cpu_supports("aes") && __builtin_cpu_supports("pclmul");
+#elif defined(__aarch64__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool TlsContext::prepare(SSL* ssl, const std::string& host) {
+    if (!SSL_set_tlsext_host_name(ssl, host.c_str())) {
+        return false;
+    }
+    // The chain check alone accepts a certificate issued for any name
+    SSL_set_hostflags(ssl, X509_CHECK_FLAG_NO_PARTIAL_WILDCARDS);
+    if (!SSL_set1_host(ssl, host.c_str())) {
+        return false;
+    }
+    if (!m_resumption.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_sessionsMutex);
+    auto it = m_sessions.find(host);
+    if (it != m_sessions.end() && SSL_SESSION_is_resumable(it->second)) {
+        SSL_set_session(ssl, it->second);
+    }
+    return true;
+}
+
+bool TlsContext::onHandshake(SSL* ssl) {
+    m_handshakes.fetch_add(1, std::memory_order_relaxed);
+    bool resumed = SSL_session_reused(ssl) == 1;
+    if (resumed) {
+        m_resumed.fetch_add(1, std::memory_order_relaxed);
+    }
+    return resumed;
+}
+
+void TlsContext::clearSessions() {
+    std::lock_guard<std::mutex> lock(m_sessionsMutex);
+    for (auto& entry : m_sessions) {
+        SSL_SESSION_free(entry.second);
+    }
+    m_sessions.clear();
+}
+
+TlsStats TlsContext::getStats() const {
+    TlsStats stats;
+    stats.handshakes = m_handshakes.load(std::memory_order_relaxed);
+    stats.resumed = m_resumed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void TlsContext::storeSession(const std::string& host, SSL_SESSION* session) {
+    std::lock_guard<std::mutex> lock(m_sessionsMutex);
+    auto result = m_sessions.emplace(host, session);
+    if (!result.second) {
+        SSL_SESSION_free(result.first->second);
+        result.first->second = session;
+    }
+}
+
+int TlsContext::onNewSession(SSL* ssl, SSL_SESSION* session) {
+    auto* self = static_cast<TlsContext*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), contextIndex()));
+    const char* host = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+    if (!self || !host) {
+        return 0;
+    }
+
+    // TLS 1.3 servers send tickets after the handshake, possibly several;
+    // the latest one replaces the previous
+    self->storeSession(host, session);
+    return 1;
+}
+
+} // namespace websocket
+} // namespace deribit
@@ -0,0 +1,137 @@
+/**
+ * @file tls_context.h
+ * @brief Shared TLS client configuration
+ *
+ * This file contains the TLS context shared by all outgoing connections to
+ * Deribit. It restricts the handshake to TLS 1.2+ with AEAD ciphers in the
+ * order fastest on the host CPU, and caches session tickets per host so
+ * reconnects resume instead of performing a full handshake.
+ */
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include <boost/asio/ssl/context.hpp>
+
+namespace deribit {
+namespace websocket {
+
+/**
+ * @struct TlsStats
+ * @brief Structure for handshake statistics
+ */
+struct TlsStats {
+    uint64_t handshakes;  // completed handshakes
+    uint64_t resumed;     // handshakes that resumed a cached session
+
+    TlsStats() : handshakes(0), resumed(0) {}
+};
+
+/**
+ * @class TlsContext
+ * @brief Class owning a client SSL context and its session cache
+ *
+ * The context may be shared by any number of connections and threads.
+ * Call prepare() on each new SSL stream before the handshake and
+ * onHandshake() after it.
+ */
+class TlsContext {
+public:
+    /**
+     * @brief Get the shared context used for Deribit connections
+     * @return Reference to TlsContext instance
+     */
+    static TlsContext& getInstance();
+
+    /**
+     * @brief Constructor
+     * @param verifyPeer Whether to verify the server certificate chain
+     */
+    explicit TlsContext(bool verifyPeer = true);
+
+    /**
+     * @brief Destructor, releases cached sessions
+     */
+    ~TlsContext();
+
+    /**
+     * @brief Get the underlying SSL context
+     * @return Reference to the SSL context
+     */
+    boost::asio::ssl::context& get() { return m_context; }
+
+    /**
+     * @brief Prepare an SSL stream for a handshake with a host
+     *
+     * Sets the SNI host name, which also keys the session cache, and the
+     * name the server certificate must match when the peer is verified,
+     * then offers the cached session for the host if there is one.
+     *
+     * @param ssl Native handle of the SSL stream
+     * @param host Server host name
+     * @return true if successful, false if SNI or the expected name could not be set
+     */
+    bool prepare(SSL* ssl, const std::string& host);
+
+    /**
+     * @brief Record a completed handshake
+     * @param ssl Native handle of the SSL stream
+     * @return true if the handshake resumed a cached session, false otherwise
+     */
+    bool onHandshake(SSL* ssl);
+
+    /**
+     * @brief Enable or disable session resumption
+     * @param enabled Whether cached sessions are offered
+     */
+    void setSessionResumption(bool enabled) { m_resumption.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * @brief Drop all cached sessions
+     */
+    void clearSessions();
+
+    /**
+     * @brief Get handshake statistics
+     * @return TlsStats structure
+     */
+    TlsStats getStats() const;
+
+    /**
+     * @brief Check whether the CPU has AES instructions
+     * @return true if AES-GCM is hardware accelerated, false otherwise
+     */
+    static bool hasAesAcceleration();
+
+private:
+    // Prevent copying and assignment
+    TlsContext(const TlsContext&) = delete;
+    TlsContext& operator=(const TlsContext&) = delete;
+
+    boost::asio::ssl::context m_context;
+    std::map<std::string, SSL_SESSION*> m_sessions;
+    std::mutex m_sessionsMutex;
+    std::atomic<bool> m_resumption{true};
+    std::atomic<uint64_t> m_handshakes{0};
+    std::atomic<uint64_t> m_resumed{0};
+
+    /**
+     * @brief Store a session ticket issued by a server
+     * @param host Server host name
+     * @param session Session, ownership is taken
+     */
+    void storeSession(const std::string& host, SSL_SESSION* session);
+
+    /**
+     * @brief OpenSSL callback for newly issued sessions
+     */
+    static int onNewSession(SSL* ssl, SSL_SESSION* session);
+};
+
+} // namespace websocket
+} // namespace deribit
@@ -0,0 +1,1000 @@
+/**
+ * @file ws_client.cpp
+ * @brief WebSocket client implementation
+ */
+
+#include "ws_client.h"
+#include "tls_context.h"
+#include "../api/deribit_api.h"
+#include "../utils/logger.h"
+#include "../utils/metrics.h"
+#include "../utils/arena_json.h"
+
+#include <algorithm>
+#include <random>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <nlohmann/json.hpp>
+
+namespace deribit {
+namespace websocket {
+
+namespace beast = boost::beast;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = boost::asio::ip::tcp;
+using json = nlohmann::json;
+using utils::ArenaJson;
+
+namespace {
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Frames of a batch stay in the read buffer until it is dispatched
+constexpr size_t kReadBufferReserve = 1 << 20;
+
+const char* const kTimeoutPayload = "{\"message\":\"timeout\"}";
+const char* const kCancelledPayload = "{\"message\":\"cancelled\"}";
+
+std::string testRequestFrame(uint64_t id) {
+    return "{\"jsonrpc\":\"2.0\",\"id\":" + std::to_string(id) + ",\"method\":\"public/test\",\"params\":{}}";
+}
+
+/**
+ * @brief Serialize a value parsed into the arena for a caller that keeps it
+ */
+std::string dumpToString(const ArenaJson& value) {
+    auto text = value.dump();
+    return std::string(text.data(), text.size());
+}
+
+} // namespace
+
+/**
+ * @struct WSClient::Session
+ * @brief Socket state for a single connection
+ */
+struct WSClient::Session {
+    /**
+     * @struct PendingFrame
+     * @brief Notification read but not yet dispatched, as offsets into readBuffer
+     */
+    struct PendingFrame {
+        size_t channelOffset;
+        size_t channelSize;
+        size_t dataOffset;
+        size_t dataSize;
+        std::chrono::system_clock::time_point timestamp;
+    };
+
+    /**
+     * @struct BatchGroup
+     * @brief Notifications of one batch subscription within a batch
+     */
+    struct BatchGroup {
+        const Subscription* subscription;
+        std::vector<api::WSMessageView> messages;
+    };
+
+    net::io_context ioContext;
+    beast::websocket::stream<beast::ssl_stream<beast::tcp_stream>> ws;
+    beast::flat_buffer readBuffer;
+    net::steady_timer watchdog;
+
+    // Batch state, reused across reads so steady-state dispatch does not allocate
+    std::vector<PendingFrame> pendingFrames;
+    std::vector<api::WSMessageView> batchMessages;
+    std::vector<std::shared_ptr<const Subscription>> batchSubscriptions;
+    std::vector<BatchGroup> batchGroups;
+    int64_t batchStartNs = 0;    // receive time of the first pending frame
+
+    // Only the I/O thread runs the context, so the stream needs no strand.
+    // The plain executor also fits in the type-erased executor's inline
+    // storage, where a strand is copied to the heap on every read
+    explicit Session(ssl::context& tls)
+        : ws(ioContext, tls),
+          watchdog(ws.get_executor()) {}
+};
+
+WSClient::WSClient(const std::string& host, const std::string& port, const std::string& path, TlsContext* tls)
+    : m_host(host),
+      m_port(port),
+      m_path(path),
+      m_tls(tls ? *tls : TlsContext::getInstance()),
+      m_name(host),
+      m_probeSentNs(0),
+      m_probeId(0),
+      m_maxChannelsPerRequest(kDefaultMaxChannelsPerRequest),
+      m_maxBatchSize(kDefaultMaxBatchSize),
+      m_maxBatchDelayNs(std::chrono::duration_cast<std::chrono::nanoseconds>(kDefaultMaxBatchDelay).count()) {}
+
+WSClient::~WSClient() {
+    disconnect();
+}
+
+bool WSClient::connect() {
+    if (m_running) {
+        return m_connected;
+    }
+
+    if (!openSession()) {
+        return false;
+    }
+
+    m_running = true;
+    m_connected = true;
+    resynchronize(std::chrono::steady_clock::now(), 0);
+    m_ioThread = std::thread(&WSClient::ioThreadFunction, this);
+
+    LOG_INFO("WebSocket connected to {}{}", m_host, m_path);
+    return true;
+}
+
+void WSClient::disconnect() {
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_running = false;
+    }
+    m_stateCondition.notify_all();
+
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        if (m_session) {
+            if (m_connected.exchange(false)) {
+                net::post(m_session->ws.get_executor(), [this]() {
+                    m_session->ws.async_close(beast::websocket::close_code::normal,
+                        [this](beast::error_code) {
+                            m_session->ioContext.stop();
+                        });
+                });
+            } else {
+                m_session->ioContext.stop();
+            }
+        }
+    }
+
+    if (m_ioThread.joinable()) {
+        m_ioThread.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        m_session.reset();
+        m_writeQueue.clear();
+    }
+    failAllRequests("{\"message\":\"connection closed\"}");
+}
+
+void WSClient::setAuthParams(const std::string& params) {
+    std::lock_guard<std::mutex> lock(m_authMutex);
+    m_authParams = params;
+}
+
+bool WSClient::openSession() {
+    auto session = std::make_unique<Session>(m_tls.get());
+    try {
+        auto& ws = session->ws;
+
+        tcp::resolver resolver(session->ioContext);
+        auto endpoints = resolver.resolve(m_host, m_port);
+        beast::get_lowest_layer(ws).connect(endpoints);
+        beast::get_lowest_layer(ws).socket().set_option(tcp::no_delay(true));
+
+        auto& tls = m_tls;
+        SSL* ssl = ws.next_layer().native_handle();
+        if (!tls.prepare(ssl, m_host)) {
+            LOG_ERROR("Failed to set SNI host name for {}", m_host);
+            return false;
+        }
+        auto handshakeStart = std::chrono::steady_clock::now();
+        ws.next_layer().handshake(ssl::stream_base::client);
+        bool resumed = tls.onHandshake(ssl);
+        utils::Metrics::getInstance().recordLatency(
+            "websocket", resumed ? "tls_resumed_handshake" : "tls_full_handshake",
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - handshakeStart).count());
+        LOG_DEBUG("{}: TLS handshake {} ({})", m_name, resumed ? "resumed" : "full", SSL_get_cipher(ssl));
+
+        beast::get_lowest_layer(ws).expires_never();
+        ws.set_option(beast::websocket::stream_base::timeout::suggested(beast::role_type::client));
+        ws.handshake(m_host, m_path);
+    } catch (const std::exception& e) {
+        LOG_ERROR("WebSocket connection to {} failed: {}", m_host, e.what());
+        return false;
+    }
+
+    // Sized for a full batch up front, rather than growing on the first large one
+    session->readBuffer.reserve(kReadBufferReserve);
+    session->pendingFrames.reserve(m_maxBatchSize);
+    session->batchMessages.reserve(m_maxBatchSize);
+    session->batchSubscriptions.reserve(m_maxBatchSize);
+
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        m_session = std::move(session);
+        m_writeQueue.clear();
+    }
+    m_lastReceiveNs.store(nowNs(), std::memory_order_relaxed);
+    m_probeSentNs = 0;
+    m_probeId = 0;
+    startRead();
+    startWatchdog();
+    return true;
+}
+
+std::chrono::nanoseconds WSClient::getIdleTime() const {
+    return std::chrono::nanoseconds(nowNs() - m_lastReceiveNs.load(std::memory_order_relaxed));
+}
+
+void WSClient::startWatchdog() {
+    if (!m_heartbeatPolicy.enabled) {
+        return;
+    }
+
+    auto interval = std::max(std::chrono::milliseconds(10), m_heartbeatPolicy.probeAfter / 2);
+    m_session->watchdog.expires_after(interval);
+    m_session->watchdog.async_wait([this](beast::error_code ec) {
+        if (ec) {
+            return;
+        }
+        checkStaleness();
+    });
+}
+
+void WSClient::checkStaleness() {
+    int64_t now = nowNs();
+    auto idle = std::chrono::nanoseconds(now - m_lastReceiveNs.load(std::memory_order_relaxed));
+
+    if (idle > m_heartbeatPolicy.staleAfter) {
+        double idleMs = idle.count() / 1e6;
+        LOG_WARN("WebSocket connection {} stale: no data for {:.0f}ms, dropping it", m_name, idleMs);
+        utils::Metrics::getInstance().recordStaleConnection(m_name, idleMs);
+
+        m_connected = false;
+        beast::error_code ec;
+        beast::get_lowest_layer(m_session->ws).socket().close(ec);
+        m_session->ioContext.stop();
+        return;
+    }
+
+    if (idle > m_heartbeatPolicy.probeAfter &&
+        (m_probeSentNs == 0 || std::chrono::nanoseconds(now - m_probeSentNs) > m_heartbeatPolicy.probeAfter)) {
+        m_probeId = m_nextRequestId++;
+        m_probeSentNs = now;
+        queueWrite(testRequestFrame(m_probeId));
+    }
+
+    startWatchdog();
+}
+
+bool WSClient::handleHeartbeat(std::string_view payload) {
+    // Heartbeat frames are tiny; skip the scan for market data frames
+    if (payload.size() > 256 || payload.find("\"method\":\"heartbeat\"") == std::string_view::npos) {
+        return false;
+    }
+
+    if (payload.find("test_request") != std::string_view::npos) {
+        queueWrite(testRequestFrame(m_nextRequestId++));
+    }
+    return true;
+}
+
+void WSClient::ioThreadFunction() {
+    while (m_running) {
+        m_session->ioContext.run();
+        m_connected = false;
+
+        if (!m_running) {
+            break;
+        }
+
+        auto lostAt = std::chrono::steady_clock::now();
+        LOG_WARN("WebSocket connection to {} lost", m_host);
+        failAllRequests("{\"message\":\"connection lost\"}");
+
+        if (m_onDisconnected) {
+            m_onDisconnected();
+        }
+
+        size_t attempts = 0;
+        if (!m_reconnectPolicy.enabled || !reconnect(attempts)) {
+            m_running = false;
+            break;
+        }
+
+        {
+            // disconnect() may have stopped the client while reconnecting
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            if (!m_running) {
+                break;
+            }
+            m_connected = true;
+        }
+        resynchronize(lostAt, attempts);
+    }
+}
+
+bool WSClient::reconnect(size_t& attempts) {
+    std::mt19937 random(std::random_device{}());
+    std::uniform_real_distribution<double> jitter(-m_reconnectPolicy.jitter, m_reconnectPolicy.jitter);
+    auto delay = m_reconnectPolicy.initialDelay;
+
+    while (m_running) {
+        ++attempts;
+        if (openSession()) {
+            return true;
+        }
+
+        if (m_reconnectPolicy.maxAttempts > 0 && attempts >= m_reconnectPolicy.maxAttempts) {
+            LOG_ERROR("Giving up reconnecting to {} after {} attempts", m_host, attempts);
+            return false;
+        }
+
+        auto wait = std::chrono::milliseconds(static_cast<int64_t>(delay.count() * (1.0 + jitter(random))));
+        LOG_INFO("Reconnecting to {} in {}ms (attempt {})", m_host, wait.count(), attempts + 1);
+        {
+            std::unique_lock<std::mutex> lock(m_stateMutex);
+            m_stateCondition.wait_for(lock, wait, [this]() { return !m_running; });
+        }
+
+        delay = std::min(
+            m_reconnectPolicy.maxDelay,
+            std::chrono::milliseconds(static_cast<int64_t>(delay.count() * m_reconnectPolicy.multiplier))
+        );
+    }
+    return false;
+}
+
+void WSClient::resynchronize(std::chrono::steady_clock::time_point lostAt, size_t attempts) {
+    auto reconnectedAt = std::chrono::steady_clock::now();
+    auto channels = getSubscribedChannels();
+
+    auto onRecovered = [this, lostAt, reconnectedAt, attempts, count = channels.size()]() {
+        if (attempts == 0 || !m_connected) {
+            return;
+        }
+        ReconnectStats stats;
+        stats.attempts = attempts;
+        stats.channels = count;
+        stats.timeToReconnect = std::chrono::duration_cast<std::chrono::microseconds>(reconnectedAt - lostAt);
+        stats.timeToRecover = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - lostAt);
+
+        double recoverMs = stats.timeToRecover.count() / 1000.0;
+        utils::Metrics::getInstance().recordLatency("websocket", "recover", recoverMs);
+        LOG_INFO("WebSocket recovered after {} attempt(s): reconnect {:.1f}ms, resync of {} channels {:.1f}ms",
+                 attempts, stats.timeToReconnect.count() / 1000.0, count, recoverMs);
+
+        if (m_onReconnected) {
+            m_onReconnected(stats);
+        }
+    };
+
+    auto resubscribe = [this, channels, onRecovered]() {
+        if (m_connected && sendChannelRequests("subscribe", channels, onRecovered) == 0) {
+            onRecovered();
+        }
+    };
+
+    if (m_heartbeatPolicy.enabled) {
+        sendRequest("public/set_heartbeat",
+                    "{\"interval\":" + std::to_string(m_heartbeatPolicy.heartbeatIntervalSec) + "}");
+    }
+
+    std::string authParams;
+    {
+        std::lock_guard<std::mutex> lock(m_authMutex);
+        authParams = m_authParams;
+    }
+
+    if (authParams.empty()) {
+        resubscribe();
+        return;
+    }
+
+    sendRequest("public/auth", authParams, [this, resubscribe](bool success, const std::string& payload) {
+        if (!success) {
+            LOG_ERROR("WebSocket re-authentication failed: {}", payload);
+        } else if (m_onReauthenticated) {
+            utils::ArenaScope scope;
+            const ArenaJson& result = utils::parseJson(payload);
+            if (result.is_object()) {
+                m_onReauthenticated(std::string(utils::stringField(result, "access_token")),
+                                    std::string(utils::stringField(result, "refresh_token")),
+                                    std::chrono::seconds(result.value("expires_in", int64_t{0})));
+            }
+        }
+        resubscribe();
+    });
+}
+
+uint64_t WSClient::sendRequest(
+    const std::string& method,
+    const std::string& params,
+    ResponseCallback callback
+) {
+    return sendRequest(method, params, std::move(callback), RequestOptions());
+}
+
+uint64_t WSClient::sendRequest(
+    const std::string& method,
+    const std::string& params,
+    ResponseCallback callback,
+    const RequestOptions& options
+) {
+    uint64_t id = m_nextRequestId++;
+    if (!m_connected || options.cancellation.isCancelled()) {
+        if (callback) {
+            callback(false, m_connected ? kCancelledPayload : "{\"message\":\"not connected\"}");
+        }
+        return id;
+    }
+
+    if (callback) {
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            m_pendingRequests[id].callback = std::move(callback);
+        }
+
+        // The deadline or cancellation may fire before its handle is stored,
+        // in which case the request is gone and the handle is released here
+        if (options.timeout.count() > 0) {
+            auto& timers = utils::TimerService::getInstance();
+            auto deadline = timers.schedule(options.timeout, [this, id]() {
+                failRequest(id, kTimeoutPayload);
+            });
+            {
+                std::lock_guard<std::mutex> lock(m_pendingMutex);
+                auto it = m_pendingRequests.find(id);
+                if (it != m_pendingRequests.end()) {
+                    it->second.deadline = deadline;
+                    deadline = 0;
+                }
+            }
+            timers.cancel(deadline);
+        }
+        if (options.cancellation.canBeCancelled()) {
+            auto registration = options.cancellation.onCancel([this, id]() {
+                failRequest(id, kCancelledPayload);
+            });
+            {
+                std::lock_guard<std::mutex> lock(m_pendingMutex);
+                auto it = m_pendingRequests.find(id);
+                if (it != m_pendingRequests.end()) {
+                    it->second.cancellation = options.cancellation;
+                    it->second.cancelRegistration = registration;
+                    registration = 0;
+                }
+            }
+            options.cancellation.unregister(registration);
+            if (options.cancellation.isCancelled()) {
+                return id;
+            }
+        }
+    }
+
+    send(encodeRequest(id, method, params));
+    return id;
+}
+
+std::string WSClient::encodeRequest(uint64_t id, std::string_view method, std::string_view params) {
+    std::string payload;
+    payload.reserve(64 + method.size() + params.size());
+    payload += "{\"jsonrpc\":\"2.0\",\"id\":";
+    payload += std::to_string(id);
+    payload += ",\"method\":\"";
+    payload += method;
+    payload += "\",\"params\":";
+    payload += params.empty() ? std::string_view("{}") : params;
+    payload += "}";
+    return payload;
+}
+
+bool WSClient::subscribe(const std::string& channel, MessageCallback callback) {
+    return subscribe(std::vector<std::string>{channel}, std::move(callback)) > 0;
+}
+
+size_t WSClient::subscribe(const std::vector<std::string>& channels, MessageCallback callback) {
+    auto subscription = std::make_shared<Subscription>();
+    subscription->callback = std::move(callback);
+    return addSubscriptions(channels, std::move(subscription));
+}
+
+size_t WSClient::subscribeView(const std::vector<std::string>& channels, MessageViewCallback callback) {
+    auto subscription = std::make_shared<Subscription>();
+    subscription->viewCallback = std::move(callback);
+    return addSubscriptions(channels, std::move(subscription));
+}
+
+size_t WSClient::subscribeBatch(
+    const std::vector<std::string>& channels,
+    MessageBatchCallback callback,
+    std::function<void()> onSubscribed
+) {
+    auto subscription = std::make_shared<Subscription>();
+    subscription->batchCallback = std::move(callback);
+    return addSubscriptions(channels, std::move(subscription), std::move(onSubscribed));
+}
+
+size_t WSClient::addSubscriptions(
+    const std::vector<std::string>& channels,
+    std::shared_ptr<const Subscription> subscription,
+    std::function<void()> onComplete
+) {
+    if (channels.empty()) {
+        return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_subscriptionsMutex);
+        for (const auto& channel : channels) {
+            m_subscriptions[channel] = subscription;
+        }
+    }
+
+    return sendChannelRequests("subscribe", channels, std::move(onComplete));
+}
+
+bool WSClient::unsubscribe(const std::string& channel) {
+    return unsubscribe(std::vector<std::string>{channel}) > 0;
+}
+
+size_t WSClient::unsubscribe(const std::vector<std::string>& channels) {
+    if (channels.empty()) {
+        return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_subscriptionsMutex);
+        for (const auto& channel : channels) {
+            m_subscriptions.erase(channel);
+        }
+    }
+
+    return sendChannelRequests("unsubscribe", channels);
+}
+
+size_t WSClient::resubscribe(const std::vector<std::string>& channels) {
+    return sendChannelRequests("unsubscribe", channels) + sendChannelRequests("subscribe", channels);
+}
+
+std::vector<std::string> WSClient::getSubscribedChannels() const {
+    std::lock_guard<std::mutex> lock(m_subscriptionsMutex);
+    std::vector<std::string> channels;
+    channels.reserve(m_subscriptions.size());
+    for (const auto& entry : m_subscriptions) {
+        channels.push_back(entry.first);
+    }
+    return channels;
+}
+
+size_t WSClient::sendChannelRequests(
+    const std::string& action,
+    const std::vector<std::string>& channels,
+    std::function<void()> onComplete
+) {
+    if (!m_connected) {
+        LOG_DEBUG("Deferring {} of {} channels until connected", action, channels.size());
+        return 0;
+    }
+
+    std::vector<std::string> publicChannels;
+    std::vector<std::string> privateChannels;
+    for (const auto& channel : channels) {
+        if (channel.compare(0, 5, "user.") == 0) {
+            privateChannels.push_back(channel);
+        } else {
+            publicChannels.push_back(channel);
+        }
+    }
+
+    size_t batches = (publicChannels.size() + m_maxChannelsPerRequest - 1) / m_maxChannelsPerRequest +
+                     (privateChannels.size() + m_maxChannelsPerRequest - 1) / m_maxChannelsPerRequest;
+    if (batches == 0) {
+        return 0;
+    }
+
+    auto remaining = std::make_shared<std::atomic<size_t>>(batches);
+    auto sendBatches = [&](const std::string& method, const std::vector<std::string>& batchChannels) {
+        for (size_t begin = 0; begin < batchChannels.size(); begin += m_maxChannelsPerRequest) {
+            size_t end = std::min(begin + m_maxChannelsPerRequest, batchChannels.size());
+            json params;
+            params["channels"] = json::array();
+            for (size_t i = begin; i < end; ++i) {
+                params["channels"].push_back(batchChannels[i]);
+            }
+
+            size_t count = end - begin;
+            sendRequest(method, params.dump(),
+                [method, count, remaining, onComplete](bool success, const std::string& payload) {
+                    if (!success) {
+                        LOG_ERROR("{} for {} channels failed: {}", method, count, payload);
+                    }
+                    if (--*remaining == 0 && onComplete) {
+                        onComplete();
+                    }
+                });
+        }
+    };
+
+    sendBatches("public/" + action, publicChannels);
+    sendBatches("private/" + action, privateChannels);
+
+    LOG_DEBUG("Sent {} {} request(s) for {} channels", batches, action, channels.size());
+    return batches;
+}
+
+void WSClient::send(std::string payload) {
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    if (!m_session || !m_connected) {
+        LOG_WARN("Dropping WebSocket message: not connected");
+        return;
+    }
+
+    net::post(m_session->ws.get_executor(), [this, payload = std::move(payload)]() mutable {
+        queueWrite(std::move(payload));
+    });
+}
+
+bool WSClient::post(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    if (!m_session || !m_connected) {
+        return false;
+    }
+
+    net::post(m_session->ws.get_executor(), std::move(task));
+    return true;
+}
+
+void WSClient::queueWrite(std::string payload) {
+    m_writeQueue.push_back(std::move(payload));
+    if (m_writeQueue.size() == 1) {
+        startWrite();
+    }
+}
+
+void WSClient::startWrite() {
+    m_session->ws.text(true);
+    m_session->ws.async_write(
+        net::buffer(m_writeQueue.front()),
+        [this](beast::error_code ec, std::size_t) {
+            if (ec) {
+                LOG_ERROR("WebSocket write failed: {}", ec.message());
+                m_writeQueue.clear();
+                return;
+            }
+            m_writeQueue.pop_front();
+            if (!m_writeQueue.empty()) {
+                startWrite();
+            }
+        });
+}
+
+void WSClient::startRead() {
+    m_session->ws.async_read(
+        m_session->readBuffer,
+        [this](beast::error_code ec, std::size_t bytes) {
+            if (ec) {
+                if (m_connected.exchange(false)) {
+                    LOG_WARN("WebSocket read failed: {}", ec.message());
+                }
+                m_session->ioContext.stop();
+                return;
+            }
+
+            int64_t receivedNs = nowNs();
+            m_lastReceiveNs.store(receivedNs, std::memory_order_relaxed);
+            auto& session = *m_session;
+
+            // Frames are appended to the read buffer, which keeps its capacity
+            // across reads; notifications are recorded as offsets and handed
+            // out as views once the batch is flushed
+            auto buffer = session.readBuffer.cdata();
+            const char* base = static_cast<const char*>(buffer.data());
+            std::string_view frame(base + buffer.size() - bytes, bytes);
+
+            std::string_view channel;
+            std::string_view data;
+            if (handleHeartbeat(frame)) {
+                // Answered on the I/O thread
+            } else if (parseNotification(frame, channel, data)) {
+                if (session.pendingFrames.empty()) {
+                    session.batchStartNs = receivedNs;
+                }
+                session.pendingFrames.push_back(Session::PendingFrame{
+                    static_cast<size_t>(channel.data() - base), channel.size(),
+                    static_cast<size_t>(data.data() - base), data.size(),
+                    std::chrono::system_clock::now()
+                });
+            } else {
+                // Replies must not overtake notifications read before them
+                flushBatch();
+                handleMessage(frame);
+            }
+
+            // Keep reading while more data is already buffered, up to the
+            // batch size and delay. The buffered bytes may hold only part of
+            // the next frame, so the delay bounds how long a batch is held
+            if (!session.pendingFrames.empty() &&
+                session.pendingFrames.size() < m_maxBatchSize &&
+                receivedNs - session.batchStartNs < m_maxBatchDelayNs &&
+                hasBufferedData()) {
+                startRead();
+                return;
+            }
+
+            flushBatch();
+            session.readBuffer.consume(session.readBuffer.size());
+            startRead();
+        });
+}
+
+bool WSClient::hasBufferedData() {
+    auto& ws = m_session->ws;
+    if (SSL_pending(ws.next_layer().native_handle()) > 0) {
+        return true;
+    }
+    beast::error_code ec;
+    return beast::get_lowest_layer(ws).socket().available(ec) > 0 && !ec;
+}
+
+void WSClient::flushBatch() {
+    auto& session = *m_session;
+    if (session.pendingFrames.empty()) {
+        return;
+    }
+
+    // Handlers parse into the thread's arena, rewound once the batch is done
+    utils::ArenaScope scope;
+    auto buffer = session.readBuffer.cdata();
+    const char* base = static_cast<const char*>(buffer.data());
+
+    // Resolve all subscriptions of the batch under a single lock
+    session.batchMessages.clear();
+    session.batchSubscriptions.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_subscriptionsMutex);
+        for (const auto& frame : session.pendingFrames) {
+            api::WSMessageView msg;
+            msg.channel = std::string_view(base + frame.channelOffset, frame.channelSize);
+            msg.data = std::string_view(base + frame.dataOffset, frame.dataSize);
+            msg.timestamp = frame.timestamp;
+
+            auto it = m_subscriptions.find(msg.channel);
+            if (it != m_subscriptions.end()) {
+                session.batchMessages.push_back(msg);
+                session.batchSubscriptions.push_back(it->second);
+            }
+        }
+    }
+    session.pendingFrames.clear();
+
+    // Notifications of batch subscriptions are grouped per subscription;
+    // the groups are delivered before any other callback runs, so each
+    // callback sees its notifications no later than the order they arrived in
+    size_t groupCount = 0;
+    auto deliverGroups = [&session, &groupCount]() {
+        for (size_t group = 0; group < groupCount; ++group) {
+            session.batchGroups[group].subscription->batchCallback(session.batchGroups[group].messages);
+        }
+        groupCount = 0;
+    };
+    for (size_t i = 0; i < session.batchMessages.size(); ++i) {
+        const auto& msg = session.batchMessages[i];
+        const Subscription* subscription = session.batchSubscriptions[i].get();
+
+        if (!subscription->batchCallback) {
+            deliverGroups();
+            if (subscription->viewCallback) {
+                subscription->viewCallback(msg);
+            } else if (subscription->callback) {
+                subscription->callback(msg.toMessage());
+            }
+            continue;
+        }
+
+        size_t group = 0;
+        while (group < groupCount && session.batchGroups[group].subscription != subscription) {
+            ++group;
+        }
+        if (group == groupCount) {
+            if (groupCount == session.batchGroups.size()) {
+                session.batchGroups.emplace_back();
+                session.batchGroups.back().messages.reserve(m_maxBatchSize);
+            }
+            session.batchGroups[group].subscription = subscription;
+            session.batchGroups[group].messages.clear();
+            ++groupCount;
+        }
+        session.batchGroups[group].messages.push_back(msg);
+    }
+
+    deliverGroups();
+    session.batchSubscriptions.clear();
+}
+
+bool WSClient::parseNotification(std::string_view frame, std::string_view& channel, std::string_view& data) {
+    static constexpr std::string_view kMethod = "\"method\":\"subscription\"";
+    static constexpr std::string_view kChannel = "\"channel\":\"";
+    static constexpr std::string_view kData = "\"data\":";
+
+    // "method" precedes "params" in Deribit notifications
+    if (frame.substr(0, 64).find(kMethod) == std::string_view::npos) {
+        return false;
+    }
+
+    auto channelPos = frame.find(kChannel);
+    if (channelPos == std::string_view::npos) {
+        return false;
+    }
+    channelPos += kChannel.size();
+    auto channelEnd = frame.find('"', channelPos);
+    if (channelEnd == std::string_view::npos) {
+        return false;
+    }
+
+    auto dataPos = frame.find(kData, channelEnd);
+    if (dataPos == std::string_view::npos) {
+        return false;
+    }
+    dataPos += kData.size();
+
+    // Find the end of the data value by matching brackets outside strings
+    size_t depth = 0;
+    bool inString = false;
+    size_t pos = dataPos;
+    for (; pos < frame.size(); ++pos) {
+        char c = frame[pos];
+        if (inString) {
+            if (c == '\\') {
+                ++pos;
+            } else if (c == '"') {
+                inString = false;
+            }
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) {
+                break;
+            }
+            if (--depth == 0) {
+                ++pos;
+                break;
+            }
+        } else if (c == ',' && depth == 0) {
+            break;
+        }
+    }
+    if (depth != 0 || pos > frame.size()) {
+        return false;
+    }
+
+    channel = frame.substr(channelPos, channelEnd - channelPos);
+    data = frame.substr(dataPos, pos - dataPos);
+    return true;
+}
+
+void WSClient::dispatch(const api::WSMessageView& msg) {
+    std::shared_ptr<const Subscription> subscription;
+    {
+        std::lock_guard<std::mutex> lock(m_subscriptionsMutex);
+        auto it = m_subscriptions.find(msg.channel);
+        if (it == m_subscriptions.end()) {
+            return;
+        }
+        subscription = it->second;
+    }
+
+    if (subscription->batchCallback) {
+        subscription->batchCallback(std::vector<api::WSMessageView>{msg});
+    } else if (subscription->viewCallback) {
+        subscription->viewCallback(msg);
+    } else if (subscription->callback) {
+        subscription->callback(msg.toMessage());
+    }
+}
+
+void WSClient::handleMessage(std::string_view frame) {
+    api::WSMessageView msg;
+    if (parseNotification(frame, msg.channel, msg.data)) {
+        msg.timestamp = std::chrono::system_clock::now();
+        dispatch(msg);
+        return;
+    }
+
+    utils::ArenaScope scope;
+    const ArenaJson& message = utils::parseJson(frame);
+    if (message.is_discarded() || !message.is_object()) {
+        LOG_WARN("Discarding malformed WebSocket message");
+        return;
+    }
+
+    if (utils::stringField(message, "method") == "subscription") {
+        // Notification in an unexpected layout: fall back to a copy in the arena
+        auto params = message.find("params");
+        if (params == message.end() || !params->is_object()) {
+            return;
+        }
+        auto payload = params->find("data");
+        auto data = payload != params->end() ? payload->dump() : ArenaJson::string_t("null");
+        msg.channel = utils::stringField(*params, "channel");
+        msg.data = std::string_view(data.data(), data.size());
+        msg.timestamp = std::chrono::system_clock::now();
+        dispatch(msg);
+        return;
+    }
+
+    auto id = message.find("id");
+    if (id == message.end() || !id->is_number_unsigned()) {
+        return;
+    }
+
+    if (m_probeSentNs != 0 && id->get<uint64_t>() == m_probeId) {
+        utils::Metrics::getInstance().recordLatency(
+            "websocket", "probe_rtt", (nowNs() - m_probeSentNs) / 1e6);
+        m_probeSentNs = 0;
+        return;
+    }
+
+    PendingRequest request;
+    if (!takeRequest(id->get<uint64_t>(), request)) {
+        return;
+    }
+
+    auto error = message.find("error");
+    if (error != message.end()) {
+        request.callback(false, dumpToString(*error));
+    } else {
+        auto result = message.find("result");
+        request.callback(true, result != message.end() ? dumpToString(*result) : std::string("null"));
+    }
+}
+
+bool WSClient::takeRequest(uint64_t id, PendingRequest& request) {
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        auto it = m_pendingRequests.find(id);
+        if (it == m_pendingRequests.end()) {
+            return false;
+        }
+        request = std::move(it->second);
+        m_pendingRequests.erase(it);
+    }
+    utils::TimerService::getInstance().cancel(request.deadline);
+    request.cancellation.unregister(request.cancelRegistration);
+    return true;
+}
+
+void WSClient::failRequest(uint64_t id, const char* payload) {
+    PendingRequest request;
+    if (takeRequest(id, request)) {
+        request.callback(false, payload);
+    }
+}
+
+void WSClient::failAllRequests(const char* payload) {
+    std::map<uint64_t, PendingRequest> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        pending.swap(m_pendingRequests);
+    }
+    for (auto& entry : pending) {
+        utils::TimerService::getInstance().cancel(entry.second.deadline);
+        entry.second.cancellation.unregister(entry.second.cancelRegistration);
+        entry.second.callback(false, payload);
+    }
+}
+
+} // namespace websocket
+} // namespace deribit
@@ -0,0 +1,684 @@
+/**
+ * @file ws_client.h
+ * @brief WebSocket client for the Deribit JSON-RPC API
+ *
+ * This file contains the WebSocket client used to send JSON-RPC requests
+ * to Deribit and to receive subscription notifications.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include "../utils/cancellation.h"
+#include "../utils/timer_service.h"
+
+namespace deribit {
+
+namespace api {
+struct WSMessage;
+struct WSMessageView;
+} // namespace api
+
+namespace websocket {
+
+class TlsContext;
+
+/**
+ * @brief Callback invoked for each subscription notification
+ */
+using MessageCallback = std::function<void(const api::WSMessage&)>;
+
+/**
+ * @brief Callback invoked for each subscription notification without copying
+ *
+ * The views point into the receive buffer and are only valid for the
+ * duration of the call; use WSMessageView::toMessage() to keep a copy.
+ */
+using MessageViewCallback = std::function<void(const api::WSMessageView&)>;
+
+/**
+ * @brief Callback invoked with all notifications of a batch
+ *
+ * A batch holds the notifications read back-to-back while more data was
+ * already buffered, up to the client's maximum batch size and delay. The
+ * views are only valid for the duration of the call.
+ */
+using MessageBatchCallback = std::function<void(const std::vector<api::WSMessageView>&)>;
+
+/**
+ * @brief Callback invoked with the result (or error) of a JSON-RPC request
+ * @param success true if the response carried a result, false on error
+ * @param payload Serialized "result" or "error" object
+ */
+using ResponseCallback = std::function<void(bool success, const std::string& payload)>;
+
+/**
+ * @brief Callback invoked with the tokens returned by a re-authentication
+ */
+using AuthCallback = std::function<void(const std::string& accessToken, const std::string& refreshToken,
+                                        std::chrono::seconds expiresIn)>;
+
+/**
+ * @struct ReconnectPolicy
+ * @brief Structure describing the reconnect backoff
+ *
+ * The first reconnect attempt is made immediately; subsequent attempts
+ * wait initialDelay, then grow by multiplier up to maxDelay.
+ */
+struct ReconnectPolicy {
+    bool enabled;
+    std::chrono::milliseconds initialDelay;
+    std::chrono::milliseconds maxDelay;
+    double multiplier;
+    double jitter;        // fraction of the delay randomized, 0.0 - 1.0
+    size_t maxAttempts;   // 0 for unlimited
+
+    ReconnectPolicy() :
+        enabled(true),
+        initialDelay(100),
+        maxDelay(std::chrono::seconds(30)),
+        multiplier(2.0),
+        jitter(0.2),
+        maxAttempts(0) {}
+};
+
+/**
+ * @struct HeartbeatPolicy
+ * @brief Structure describing heartbeat and staleness detection
+ *
+ * Deribit heartbeats (public/set_heartbeat, minimum 10 s) keep the session
+ * alive server-side. Dead links are detected faster by the watchdog: once
+ * no frame was received for probeAfter a public/test probe is sent, and
+ * the connection is declared stale and dropped if still nothing arrived
+ * after staleAfter.
+ */
+struct HeartbeatPolicy {
+    bool enabled;
+    unsigned int heartbeatIntervalSec;
+    std::chrono::milliseconds probeAfter;
+    std::chrono::milliseconds staleAfter;
+
+    HeartbeatPolicy() :
+        enabled(true),
+        heartbeatIntervalSec(10),
+        probeAfter(250),
+        staleAfter(750) {}
+};
+
+/**
+ * @struct RequestOptions
+ * @brief Structure for per-request deadline and cancellation
+ *
+ * A request that times out or is cancelled fails its callback right away
+ * with {"message":"timeout"} or {"message":"cancelled"}. The request may
+ * still have reached the exchange, so its outcome must be treated as
+ * unknown.
+ */
+struct RequestOptions {
+    std::chrono::milliseconds timeout;         // 0 for no deadline
+    utils::CancellationToken cancellation;
+
+    RequestOptions() : timeout(0) {}
+    explicit RequestOptions(std::chrono::milliseconds t, utils::CancellationToken c = utils::CancellationToken())
+        : timeout(t), cancellation(std::move(c)) {}
+};
+
+/**
+ * @struct ReconnectStats
+ * @brief Structure describing a completed reconnect
+ */
+struct ReconnectStats {
+    size_t attempts;
+    size_t channels;
+    std::chrono::microseconds timeToReconnect;  // connection lost until socket reopened
+    std::chrono::microseconds timeToRecover;    // connection lost until auth and resubscription acknowledged
+};
+
+/**
+ * @class WSClient
+ * @brief WebSocket client implementation
+ *
+ * All socket I/O runs on a dedicated thread. Subscription callbacks are
+ * invoked on that thread. If the connection drops, the I/O thread
+ * reconnects according to the ReconnectPolicy, re-authenticates and
+ * resubscribes all channels in batched requests.
+ *
+ * Heartbeat test_requests are answered and the staleness watchdog runs
+ * on the I/O thread itself, without user callbacks or locks.
+ */
+class WSClient {
+public:
+    /**
+     * @brief Default number of channels sent in a single public/subscribe call
+     */
+    static constexpr size_t kDefaultMaxChannelsPerRequest = 250;
+
+    /**
+     * @brief Default maximum number of notifications dispatched as one batch
+     */
+    static constexpr size_t kDefaultMaxBatchSize = 64;
+
+    /**
+     * @brief Default longest time a batch is held back reading further frames
+     */
+    static constexpr std::chrono::microseconds kDefaultMaxBatchDelay{50};
+
+    /**
+     * @brief Constructor
+     * @param host Server host name
+     * @param port Server port (default: "443")
+     * @param path WebSocket endpoint path (default: "/ws/api/v2")
+     * @param tls TLS context, the shared one if null
+     */
+    WSClient(
+        const std::string& host,
+        const std::string& port = "443",
+        const std::string& path = "/ws/api/v2",
+        TlsContext* tls = nullptr
+    );
+
+    /**
+     * @brief Destructor
+     */
+    ~WSClient();
+
+    /**
+     * @brief Connect to the server and start the I/O thread
+     * @return true if successful, false otherwise
+     */
+    bool connect();
+
+    /**
+     * @brief Close the connection and stop the I/O thread
+     */
+    void disconnect();
+
+    /**
+     * @brief Get the server host name
+     * @return Host name
+     */
+    const std::string& getHost() const { return m_host; }
+
+    /**
+     * @brief Get the server port
+     * @return Port
+     */
+    const std::string& getPort() const { return m_port; }
+
+    /**
+     * @brief Get the WebSocket endpoint path
+     * @return Endpoint path
+     */
+    const std::string& getPath() const { return m_path; }
+
+    /**
+     * @brief Check whether the connection is open
+     * @return true if connected, false otherwise
+     */
+    bool isConnected() const { return m_connected; }
+
+    /**
+     * @brief Run a task on the I/O thread, between reads
+     *
+     * The task delays the reads of this connection while it runs, so it
+     * should be short or run before the market data is subscribed.
+     *
+     * @param task Task
+     * @return true if queued, false if not connected
+     */
+    bool post(std::function<void()> task);
+
+    /**
+     * @brief Send a JSON-RPC request
+     * @param method JSON-RPC method name
+     * @param params Serialized JSON params object
+     * @param callback Callback for the response (optional)
+     * @return Request ID
+     */
+    uint64_t sendRequest(
+        const std::string& method,
+        const std::string& params,
+        ResponseCallback callback = nullptr
+    );
+
+    /**
+     * @brief Send a JSON-RPC request with a deadline and/or cancellation token
+     *
+     * Deadlines are scheduled on the shared TimerService, so any number of
+     * outstanding requests cost one wheel entry each and no OS timer.
+     * Timeouts are reported on the TimerService thread.
+     *
+     * @param method JSON-RPC method name
+     * @param params Serialized JSON params object
+     * @param callback Callback for the response, timeout or cancellation
+     * @param options Deadline and cancellation token
+     * @return Request ID
+     */
+    uint64_t sendRequest(
+        const std::string& method,
+        const std::string& params,
+        ResponseCallback callback,
+        const RequestOptions& options
+    );
+
+    /**
+     * @brief Subscribe to a single channel
+     * @param channel Channel name
+     * @param callback Callback for notifications on the channel
+     * @return true if the request was sent, false otherwise
+     */
+    bool subscribe(const std::string& channel, MessageCallback callback);
+
+    /**
+     * @brief Subscribe to several channels sharing one callback
+     *
+     * Channels are sent in batched public/subscribe calls of at most
+     * getMaxChannelsPerRequest() channels each.
+     *
+     * @param channels Channel names
+     * @param callback Callback for notifications on any of the channels
+     * @return Number of public/subscribe requests sent
+     */
+    size_t subscribe(const std::vector<std::string>& channels, MessageCallback callback);
+
+    /**
+     * @brief Subscribe to several channels with a zero-copy callback
+     *
+     * Notifications are parsed in place: the callback receives views of
+     * the channel and data inside the receive buffer, with no allocation
+     * or copy per message.
+     *
+     * @param channels Channel names
+     * @param callback Callback for notifications on any of the channels
+     * @return Number of public/subscribe requests sent
+     */
+    size_t subscribeView(const std::vector<std::string>& channels, MessageViewCallback callback);
+
+    /**
+     * @brief Subscribe to several channels with a batch callback
+     *
+     * Notifications read in one burst are delivered together, so the
+     * consumer can amortize locking and syscalls across the batch. Order
+     * is preserved within a channel, and a batch is delivered before any
+     * reply read after it. Batching is bounded by the maximum batch size
+     * and delay.
+     *
+     * @param channels Channel names
+     * @param callback Callback for batches of notifications
+     * @param onSubscribed Callback once every request was acknowledged (optional)
+     * @return Number of public/subscribe requests sent
+     */
+    size_t subscribeBatch(
+        const std::vector<std::string>& channels,
+        MessageBatchCallback callback,
+        std::function<void()> onSubscribed = nullptr
+    );
+
+    /**
+     * @brief Unsubscribe from a single channel
+     * @param channel Channel name
+     * @return true if the request was sent, false otherwise
+     */
+    bool unsubscribe(const std::string& channel);
+
+    /**
+     * @brief Unsubscribe from several channels in batched calls
+     * @param channels Channel names
+     * @return Number of public/unsubscribe requests sent
+     */
+    size_t unsubscribe(const std::vector<std::string>& channels);
+
+    /**
+     * @brief Unsubscribe and resubscribe channels to obtain fresh snapshots
+     * @param channels Channel names, which must already be subscribed
+     * @return Number of requests sent
+     */
+    size_t resubscribe(const std::vector<std::string>& channels);
+
+    /**
+     * @brief Get the channels currently subscribed
+     * @return Vector of channel names
+     */
+    std::vector<std::string> getSubscribedChannels() const;
+
+    /**
+     * @brief Set the maximum number of channels per subscribe request
+     * @param maxChannels Maximum channels per request
+     */
+    void setMaxChannelsPerRequest(size_t maxChannels) {
+        m_maxChannelsPerRequest = maxChannels > 0 ? maxChannels : 1;
+    }
+
+    /**
+     * @brief Get the maximum number of channels per subscribe request
+     * @return Maximum channels per request
+     */
+    size_t getMaxChannelsPerRequest() const { return m_maxChannelsPerRequest; }
+
+    /**
+     * @brief Set the maximum number of notifications per batch
+     * @param maxBatchSize Maximum batch size, 1 to disable batching
+     */
+    void setMaxBatchSize(size_t maxBatchSize) {
+        m_maxBatchSize = maxBatchSize > 0 ? maxBatchSize : 1;
+    }
+
+    /**
+     * @brief Set the longest time a batch is held back reading further frames
+     *
+     * Checked before each further read, so a read of a frame that has
+     * only partly arrived may still extend the batch beyond it.
+     *
+     * @param maxBatchDelay Maximum delay, 0 to dispatch after every frame
+     */
+    void setMaxBatchDelay(std::chrono::nanoseconds maxBatchDelay) {
+        m_maxBatchDelayNs = maxBatchDelay.count();
+    }
+
+    /**
+     * @brief Set the reconnect policy
+     * @param policy Reconnect policy
+     */
+    void setReconnectPolicy(const ReconnectPolicy& policy) { m_reconnectPolicy = policy; }
+
+    /**
+     * @brief Set the heartbeat and staleness policy
+     *
+     * Takes effect on the next (re)connection.
+     *
+     * @param policy Heartbeat policy
+     */
+    void setHeartbeatPolicy(const HeartbeatPolicy& policy) { m_heartbeatPolicy = policy; }
+
+    /**
+     * @brief Set the connection name used in logs and metrics
+     * @param name Connection name
+     */
+    void setName(const std::string& name) { m_name = name; }
+
+    /**
+     * @brief Get the connection name
+     * @return Connection name
+     */
+    const std::string& getName() const { return m_name; }
+
+    /**
+     * @brief Get the time since the last frame was received
+     * @return Idle time
+     */
+    std::chrono::nanoseconds getIdleTime() const;
+
+    /**
+     * @brief Set the public/auth params sent on every (re)connection
+     *
+     * Private channels are only resubscribed once authentication succeeded.
+     *
+     * @param params Serialized JSON params object, empty to disable
+     */
+    void setAuthParams(const std::string& params);
+
+    /**
+     * @brief Set callback for the tokens of a successful re-authentication
+     *
+     * Invoked on the I/O thread, e.g. to hand the renewed access token to
+     * the REST client.
+     *
+     * @param callback Callback function
+     */
+    void setOnReauthenticated(AuthCallback callback) {
+        m_onReauthenticated = callback;
+    }
+
+    /**
+     * @brief Set callback for connection loss
+     *
+     * Invoked on the I/O thread before reconnecting, e.g. to invalidate
+     * state derived from the feed.
+     *
+     * @param callback Callback function
+     */
+    void setOnDisconnected(std::function<void()> callback) {
+        m_onDisconnected = callback;
+    }
+
+    /**
+     * @brief Set callback for completed reconnects
+     * @param callback Callback function
+     */
+    void setOnReconnected(std::function<void(const ReconnectStats&)> callback) {
+        m_onReconnected = callback;
+    }
+
+    /**
+     * @brief Locate the channel and data of a notification frame in place
+     * @param frame Received frame
+     * @param channel Output view of the channel name
+     * @param data Output view of the serialized "data" value
+     * @return true if the frame is a subscription notification, false otherwise
+     */
+    static bool parseNotification(std::string_view frame, std::string_view& channel, std::string_view& data);
+
+    /**
+     * @brief Build the frame of a JSON-RPC request, as sent by sendRequest()
+     * @param id Request ID
+     * @param method JSON-RPC method name
+     * @param params Serialized JSON params object, empty for none
+     * @return Frame
+     */
+    static std::string encodeRequest(uint64_t id, std::string_view method, std::string_view params);
+
+private:
+    struct Session;
+
+    /**
+     * @struct Subscription
+     * @brief Structure holding the callback of a subscribed channel
+     */
+    struct Subscription {
+        MessageCallback callback;
+        MessageViewCallback viewCallback;
+        MessageBatchCallback batchCallback;
+    };
+
+    std::string m_host;
+    std::string m_port;
+    std::string m_path;
+    TlsContext& m_tls;
+    std::unique_ptr<Session> m_session;
+    std::mutex m_sessionMutex;
+    std::thread m_ioThread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_connected{false};
+    std::mutex m_stateMutex;
+    std::condition_variable m_stateCondition;
+    ReconnectPolicy m_reconnectPolicy;
+    std::string m_authParams;
+    std::mutex m_authMutex;
+    HeartbeatPolicy m_heartbeatPolicy;
+    std::string m_name;
+
+    // Watchdog state, written on the I/O thread only
+    std::atomic<int64_t> m_lastReceiveNs{0};
+    int64_t m_probeSentNs;
+    uint64_t m_probeId;
+
+    std::atomic<uint64_t> m_nextRequestId{1};
+    size_t m_maxChannelsPerRequest;
+    size_t m_maxBatchSize;
+    int64_t m_maxBatchDelayNs;
+
+    std::map<std::string, std::shared_ptr<const Subscription>, std::less<>> m_subscriptions;
+    mutable std::mutex m_subscriptionsMutex;
+    /**
+     * @struct PendingRequest
+     * @brief Structure for a request awaiting its response
+     */
+    struct PendingRequest {
+        ResponseCallback callback;
+        utils::TimerId deadline = 0;
+        utils::CancellationToken cancellation;
+        uint64_t cancelRegistration = 0;
+    };
+
+    std::map<uint64_t, PendingRequest> m_pendingRequests;
+    std::mutex m_pendingMutex;
+    std::deque<std::string> m_writeQueue;
+
+    std::function<void()> m_onDisconnected;
+    std::function<void(const ReconnectStats&)> m_onReconnected;
+    AuthCallback m_onReauthenticated;
+
+    /**
+     * @brief Open a new session: TCP connect, TLS and WebSocket handshakes
+     * @return true if successful, false otherwise
+     */
+    bool openSession();
+
+    /**
+     * @brief I/O thread function: runs the session and reconnects on loss
+     */
+    void ioThreadFunction();
+
+    /**
+     * @brief Reconnect with backoff after the connection was lost
+     * @param attempts Output number of attempts made
+     * @return true if reconnected, false if stopped or attempts exhausted
+     */
+    bool reconnect(size_t& attempts);
+
+    /**
+     * @brief Re-authenticate and resubscribe all channels after a reconnect
+     * @param lostAt Time the connection loss was detected
+     * @param attempts Number of reconnect attempts
+     */
+    void resynchronize(std::chrono::steady_clock::time_point lostAt, size_t attempts);
+
+    /**
+     * @brief Queue a serialized frame for sending on the I/O thread
+     * @param payload Frame payload
+     */
+    void send(std::string payload);
+
+    /**
+     * @brief Send channel requests in batches
+     *
+     * "user.*" channels are sent with the private/ method prefix, all
+     * others with public/.
+     *
+     * @param action "subscribe" or "unsubscribe"
+     * @param channels Channel names
+     * @param onComplete Callback once every batch was acknowledged (optional)
+     * @return Number of requests sent
+     */
+    size_t sendChannelRequests(
+        const std::string& action,
+        const std::vector<std::string>& channels,
+        std::function<void()> onComplete = nullptr
+    );
+
+    /**
+     * @brief Remove a pending request, releasing its deadline and cancellation hook
+     * @param id Request ID
+     * @param request Output request
+     * @return true if the request was pending, false otherwise
+     */
+    bool takeRequest(uint64_t id, PendingRequest& request);
+
+    /**
+     * @brief Fail a pending request, e.g. on timeout or cancellation
+     * @param id Request ID
+     * @param payload Error payload passed to the callback
+     */
+    void failRequest(uint64_t id, const char* payload);
+
+    /**
+     * @brief Fail all pending requests, e.g. when the connection is lost
+     * @param payload Error payload passed to the callbacks
+     */
+    void failAllRequests(const char* payload);
+
+
+    /**
+     * @brief Queue a frame from the I/O thread, bypassing send()
+     * @param payload Frame payload
+     */
+    void queueWrite(std::string payload);
+
+    /**
+     * @brief Arm the staleness watchdog timer
+     */
+    void startWatchdog();
+
+    /**
+     * @brief Check the connection for staleness and probe it when idle
+     */
+    void checkStaleness();
+
+    /**
+     * @brief Answer heartbeat notifications
+     * @param payload Frame payload
+     * @return true if the frame was a heartbeat, false otherwise
+     */
+    bool handleHeartbeat(std::string_view payload);
+
+    /**
+     * @brief Start an asynchronous read of the next frame
+     */
+    void startRead();
+
+    /**
+     * @brief Write the frame at the head of the write queue
+     */
+    void startWrite();
+
+    /**
+     * @brief Register a subscription for channels and send the requests
+     * @param channels Channel names
+     * @param subscription Subscription shared by the channels
+     * @param onComplete Callback once every request was acknowledged (optional)
+     * @return Number of requests sent
+     */
+    size_t addSubscriptions(
+        const std::vector<std::string>& channels,
+        std::shared_ptr<const Subscription> subscription,
+        std::function<void()> onComplete = nullptr
+    );
+
+    /**
+     * @brief Check whether the TLS layer or socket holds unread bytes
+     * @return true if more data is buffered, false otherwise
+     */
+    bool hasBufferedData();
+
+    /**
+     * @brief Dispatch the pending notifications of the current batch
+     */
+    void flushBatch();
+
+    /**
+     * @brief Invoke the callback subscribed to a notification's channel
+     * @param msg Notification
+     */
+    void dispatch(const api::WSMessageView& msg);
+
+    /**
+     * @brief Handle a received frame
+     * @param frame Frame payload, valid for the duration of the call
+     */
+    void handleMessage(std::string_view frame);
+};
+
+} // namespace websocket
+} // namespace deribit
@@ -0,0 +1,289 @@
+/**
+ * @file analytics_tests.cpp
+ * @brief Tests for the options analytics: pricing kernels, option tickers and SVI surface fits
+ */
+
+#include <gtest/gtest.h>
+#include "../src/analytics/black_scholes.h"
+#include "../src/analytics/options_analytics.h"
+#include "../src/analytics/vol_surface.h"
+#include "../src/utils/task_pool.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <numbers>
+#include <thread>
+#include <vector>
+
+using namespace deribit;
+
+namespace {
+
+/**
+ * @brief Expiry part of an instrument name some days ahead, e.g. "25MAR27"
+ */
+std::string expiryIn(int days) {
+    std::time_t time = std::chrono::system_clock::to_time_t(
+        std::chrono::system_clock::now() + std::chrono::hours(24 * days));
+    std::tm utc{};
+    gmtime_r(&time, &utc);
+    char text[16];
+    std::strftime(text, sizeof(text), "%d%b%y", &utc);
+    std::string expiry(text);
+    for (auto& c : expiry) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return expiry;
+}
+
+double yearsTo(int64_t expiryMs) {
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return static_cast<double>(expiryMs - now) / (365.0 * 24 * 3600 * 1000);
+}
+
+/**
+ * @brief Feed an option ticker with the given mark and return the recomputed analytics
+ */
+analytics::OptionGreeks greeksFor(const std::string& instrument, double forward, double mark) {
+    auto& options = analytics::OptionsAnalytics::getInstance();
+    order::Ticker ticker;
+    ticker.underlyingPrice = forward;
+    ticker.indexPrice = forward;
+    ticker.markPrice = mark;
+    ticker.timestamp = 1;
+    ticker.valid = true;
+    options.onTicker(instrument, ticker);
+    options.recompute();
+
+    analytics::OptionGreeks greeks;
+    EXPECT_TRUE(options.getGreeks(instrument, greeks));
+    options.removeOption(instrument);
+    return greeks;
+}
+
+} // namespace
+
+TEST(BlackScholesTest, MatchesKnownBlack76Values) {
+    // At the money, F = K = 100, T = 1, vol = 20%: d1 = 0.1, d2 = -0.1
+    double call = 100 * (2 * analytics::normalCdf(0.1) - 1);
+    EXPECT_NEAR(call, 7.965567455405804, 1e-9);
+    EXPECT_NEAR(analytics::blackPrice(100, 100, 1, 0.2, true), 7.965567455405804, 1e-9);
+    EXPECT_NEAR(analytics::blackPrice(100, 100, 1, 0.2, false), 7.965567455405804, 1e-9);
+
+    // Put-call parity away from the money, discounted
+    double rate = 0.05;
+    double callPrice = analytics::blackPrice(100, 120, 0.5, 0.6, true, rate);
+    double putPrice = analytics::blackPrice(100, 120, 0.5, 0.6, false, rate);
+    EXPECT_NEAR(callPrice - putPrice, std::exp(-rate * 0.5) * (100 - 120), 1e-9);
+
+    EXPECT_NEAR(analytics::normalCdf(0), 0.5, 1e-15);
+    EXPECT_NEAR(analytics::normalCdf(1.959963984540054), 0.975, 1e-12);
+    EXPECT_NEAR(analytics::normalCdf(-3), 0.0013498980316301, 1e-14);
+}
+
+TEST(BlackScholesTest, GreeksMatchClosedForm) {
+    double forward = 100, strike = 100, expiry = 1, vol = 0.2, sign = 1;
+    double price, delta, gamma, vega, theta;
+    analytics::priceBatch(1, analytics::OptionInputs{&forward, &strike, &expiry, &sign}, &vol, 0,
+                          analytics::OptionOutputs{&price, &delta, &gamma, &vega, &theta});
+
+    double density = std::exp(-0.5 * 0.1 * 0.1) / std::sqrt(2 * std::numbers::pi);
+    EXPECT_NEAR(price, 7.965567455405804, 1e-9);
+    EXPECT_NEAR(delta, analytics::normalCdf(0.1), 1e-12);
+    EXPECT_NEAR(gamma, density / (forward * vol), 1e-12);
+    EXPECT_NEAR(vega, forward * density, 1e-9);
+    EXPECT_NEAR(theta, -forward * density * vol / 2, 1e-9);
+}
+
+TEST(BlackScholesTest, ImpliedVolRoundTrips) {
+    std::vector<double> forward, strike, expiry, sign, vol, price;
+    for (double k : {60.0, 90.0, 100.0, 110.0, 160.0}) {
+        for (double t : {0.02, 0.25, 2.0}) {
+            for (double v : {0.05, 0.5, 1.5}) {
+                for (double s : {1.0, -1.0}) {
+                    forward.push_back(100);
+                    strike.push_back(k);
+                    expiry.push_back(t);
+                    sign.push_back(s);
+                    vol.push_back(v);
+                    price.push_back(analytics::blackPrice(100, k, t, v, s > 0));
+                }
+            }
+        }
+    }
+
+    size_t count = price.size();
+    std::vector<double> solved(count);
+    analytics::OptionInputs inputs{forward.data(), strike.data(), expiry.data(), sign.data()};
+    analytics::impliedVolBatch(count, inputs, price.data(), 0, solved.data());
+    for (size_t i = 0; i < count; ++i) {
+        // Several deviations from the money the time value is lost in the
+        // rounding of the price and carries no volatility information
+        double timeValue = price[i] - std::max(sign[i] * (forward[i] - strike[i]), 0.0);
+        if (timeValue > 1e-9 * forward[i]) {
+            EXPECT_NEAR(solved[i], vol[i], 1e-6)
+                << "strike " << strike[i] << " expiry " << expiry[i] << " sign " << sign[i];
+        }
+    }
+}
+
+TEST(BlackScholesTest, PriceOutsideBoundsHasNoImpliedVol) {
+    double forward = 100, strike = 90, expiry = 0.5, sign = 1;
+    analytics::OptionInputs inputs{&forward, &strike, &expiry, &sign};
+    double vol = -1;
+
+    // Below intrinsic value
+    double price = 9;
+    analytics::impliedVolBatch(1, inputs, &price, 0, &vol);
+    EXPECT_EQ(vol, 0);
+
+    // Above the forward
+    price = 101;
+    analytics::impliedVolBatch(1, inputs, &price, 0, &vol);
+    EXPECT_EQ(vol, 0);
+}
+
+TEST(OptionNameTest, ParsesSettlement) {
+    analytics::OptionContract contract;
+    ASSERT_TRUE(analytics::parseOptionName("BTC-25MAR22-50000-C", contract));
+    EXPECT_EQ(contract.currency, "BTC");
+    EXPECT_DOUBLE_EQ(contract.strike, 50000);
+    EXPECT_TRUE(contract.isCall);
+    EXPECT_TRUE(contract.inverse);
+
+    ASSERT_TRUE(analytics::parseOptionName("XRP_USDC-5APR24-0d625-P", contract));
+    EXPECT_EQ(contract.currency, "XRP_USDC");
+    EXPECT_DOUBLE_EQ(contract.strike, 0.625);
+    EXPECT_FALSE(contract.isCall);
+    EXPECT_FALSE(contract.inverse);
+
+    EXPECT_FALSE(analytics::parseOptionName("BTC-PERPETUAL", contract));
+    EXPECT_FALSE(analytics::parseOptionName("BTC-25MAR22", contract));
+}
+
+TEST(OptionsAnalyticsTest, CoinSettledMarkIsConvertedToUsd) {
+    const std::string instrument = "BTC-" + expiryIn(90) + "-60000-C";
+    analytics::OptionContract contract;
+    ASSERT_TRUE(analytics::parseOptionName(instrument, contract));
+    double forward = 50000;
+    double usd = analytics::blackPrice(forward, 60000, yearsTo(contract.expiry), 0.6, true);
+
+    // Quoted in BTC
+    auto greeks = greeksFor(instrument, forward, usd / forward);
+    EXPECT_NEAR(greeks.markPrice, usd, 1e-6 * usd);
+    EXPECT_NEAR(greeks.markIv, 0.6, 1e-6);
+}
+
+TEST(OptionsAnalyticsTest, UsdcSettledMarkIsUsedAsQuoted) {
+    const std::string instrument = "XRP_USDC-" + expiryIn(90) + "-0d6-P";
+    analytics::OptionContract contract;
+    ASSERT_TRUE(analytics::parseOptionName(instrument, contract));
+    double forward = 0.5;
+    double usdc = analytics::blackPrice(forward, 0.6, yearsTo(contract.expiry), 0.8, false);
+
+    // Already quoted in USDC
+    auto greeks = greeksFor(instrument, forward, usdc);
+    EXPECT_NEAR(greeks.markPrice, usdc, 1e-12);
+    EXPECT_NEAR(greeks.markIv, 0.8, 1e-6);
+}
+
+TEST(SviTest, TotalVarianceMatchesDefinition) {
+    analytics::SviParams params;
+    params.a = 0.02;
+    params.b = 0.4;
+    params.rho = -0.5;
+    params.m = 0.1;
+    params.sigma = 0.2;
+    EXPECT_NEAR(params.totalVariance(0.1), 0.02 + 0.4 * 0.2, 1e-15);
+    EXPECT_NEAR(params.totalVariance(-0.3), 0.02 + 0.4 * (-0.5 * -0.4 + std::sqrt(0.16 + 0.04)), 1e-15);
+}
+
+TEST(SviTest, BuilderRecoversSyntheticSmiles) {
+    // Two expiries with known smiles, quoted out of the money as marks in BTC
+    const double forward = 50000;
+    struct Smile {
+        int days;
+        analytics::SviParams params;
+    };
+    std::vector<Smile> smiles(2);
+    smiles[0].days = 30;
+    smiles[0].params.a = 0.004;
+    smiles[0].params.b = 0.05;
+    smiles[0].params.rho = -0.3;
+    smiles[0].params.m = 0.02;
+    smiles[0].params.sigma = 0.15;
+    smiles[1].days = 120;
+    smiles[1].params.a = 0.03;
+    smiles[1].params.b = 0.12;
+    smiles[1].params.rho = 0.2;
+    smiles[1].params.m = -0.05;
+    smiles[1].params.sigma = 0.3;
+
+    auto& options = analytics::OptionsAnalytics::getInstance();
+    std::vector<std::string> instruments;
+    std::vector<int64_t> expiries;
+    for (const auto& smile : smiles) {
+        std::string expiry = expiryIn(smile.days);
+        for (int strike = 30000; strike <= 80000; strike += 2500) {
+            bool isCall = strike >= forward;
+            std::string instrument = "SVI-" + expiry + "-" + std::to_string(strike) + (isCall ? "-C" : "-P");
+            analytics::OptionContract contract;
+            ASSERT_TRUE(analytics::parseOptionName(instrument, contract));
+            double years = yearsTo(contract.expiry);
+            double vol = std::sqrt(smile.params.totalVariance(std::log(strike / forward)) / years);
+
+            order::Ticker ticker;
+            ticker.underlyingPrice = forward;
+            ticker.markPrice = analytics::blackPrice(forward, strike, years, vol, isCall) / forward;
+            ticker.valid = true;
+            options.onTicker(instrument, ticker);
+            instruments.push_back(instrument);
+        }
+        analytics::OptionContract contract;
+        analytics::parseOptionName(instruments.back(), contract);
+        expiries.push_back(contract.expiry);
+    }
+    options.recompute(true);
+
+    utils::TaskPoolConfig poolConfig;
+    poolConfig.threads = 2;
+    utils::TaskPool pool(poolConfig);
+    ASSERT_TRUE(pool.start());
+    analytics::VolSurfaceConfig config;
+    config.currencies = {"SVI"};
+    analytics::VolSurfaceBuilder builder(config, pool);
+    ASSERT_TRUE(builder.start());
+    EXPECT_EQ(builder.refresh(), 2u);
+
+    std::shared_ptr<const analytics::VolSurface> surface;
+    for (int wait = 0; wait < 500 && !surface; ++wait) {
+        surface = builder.getSurface("SVI");
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    builder.stop();
+    pool.stop();
+    for (const auto& instrument : instruments) {
+        options.removeOption(instrument);
+    }
+
+    ASSERT_TRUE(surface);
+    ASSERT_EQ(surface->getSmiles().size(), 2u);
+    for (size_t i = 0; i < smiles.size(); ++i) {
+        const auto& fitted = surface->getSmiles()[i];
+        EXPECT_EQ(fitted.expiry, expiries[i]);
+        EXPECT_EQ(fitted.points, 21u);
+        EXPECT_NEAR(fitted.forward, forward, 1e-6);
+        EXPECT_LT(fitted.rmse, 1e-4);
+
+        // Between the quoted strikes the surface follows the generating smile
+        for (double strike : {33000.0, 47500.0, 51000.0, 77000.0}) {
+            double years = yearsTo(expiries[i]);
+            double expected = std::sqrt(smiles[i].params.totalVariance(std::log(strike / forward)) / years);
+            EXPECT_NEAR(surface->getVol(strike, expiries[i]), expected, 5e-4) << "strike " << strike;
+        }
+    }
+}
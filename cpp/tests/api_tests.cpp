@@ -0,0 +1,207 @@
+/**
+ * @file api_tests.cpp
+ * @brief Tests for the REST layer: keep-alive connection pool
+ */
+
+#include <gtest/gtest.h>
+#include "../src/api/http_client.h"
+#include "../src/websocket/tls_context.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+using namespace deribit;
+
+namespace beast = boost::beast;
+namespace http = boost::beast::http;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = boost::asio::ip::tcp;
+
+namespace {
+
+/**
+ * @brief Configure a server context with a freshly generated self-signed certificate
+ */
+bool useSelfSignedCertificate(ssl::context& context) {
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    if (!key || !cert) {
+        EVP_PKEY_free(key);
+        X509_free(cert);
+        return false;
+    }
+
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    bool ok = X509_sign(cert, key, EVP_sha256()) > 0 &&
+              SSL_CTX_use_certificate(context.native_handle(), cert) == 1 &&
+              SSL_CTX_use_PrivateKey(context.native_handle(), key) == 1;
+
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ok;
+}
+
+/**
+ * @class MockRestServer
+ * @brief Local TLS HTTP server answering every request with "{}", or never answering
+ *
+ * Runs on its own thread until destroyed and counts the connections it
+ * accepted and the requests it read.
+ */
+class MockRestServer {
+public:
+    explicit MockRestServer(bool respond)
+        : m_respond(respond),
+          m_context(ssl::context::tls_server),
+          m_acceptor(m_ioContext, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0)) {}
+
+    ~MockRestServer() {
+        m_ioContext.stop();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    bool start() {
+        if (!useSelfSignedCertificate(m_context)) {
+            return false;
+        }
+        accept();
+        m_thread = std::thread([this]() { m_ioContext.run(); });
+        return true;
+    }
+
+    std::string getPort() const { return std::to_string(m_acceptor.local_endpoint().port()); }
+    size_t getConnections() const { return m_connections.load(); }
+    size_t getRequests() const { return m_requests.load(); }
+
+private:
+    struct Session {
+        beast::ssl_stream<beast::tcp_stream> stream;
+        beast::flat_buffer buffer;
+        http::request<http::string_body> request;
+        http::response<http::string_body> response;
+
+        Session(tcp::socket socket, ssl::context& context) : stream(std::move(socket), context) {}
+    };
+
+    bool m_respond;
+    net::io_context m_ioContext;
+    ssl::context m_context;
+    tcp::acceptor m_acceptor;
+    std::thread m_thread;
+    std::atomic<size_t> m_connections{0};
+    std::atomic<size_t> m_requests{0};
+
+    void accept() {
+        m_acceptor.async_accept([this](boost::system::error_code ec, tcp::socket socket) {
+            if (ec) {
+                return;
+            }
+            m_connections.fetch_add(1);
+            auto session = std::make_shared<Session>(std::move(socket), m_context);
+            session->stream.async_handshake(ssl::stream_base::server,
+                [this, session](boost::system::error_code ec) {
+                    if (!ec) {
+                        read(session);
+                    }
+                });
+            accept();
+        });
+    }
+
+    void read(const std::shared_ptr<Session>& session) {
+        session->request = {};
+        http::async_read(session->stream, session->buffer, session->request,
+            [this, session](boost::system::error_code ec, size_t) {
+                if (ec) {
+                    return;
+                }
+                m_requests.fetch_add(1);
+                if (!m_respond) {
+                    // Keep the session alive without answering
+                    read(session);
+                    return;
+                }
+                session->response = {};
+                session->response.result(http::status::ok);
+                session->response.version(11);
+                session->response.keep_alive(true);
+                session->response.body() = "{}";
+                session->response.prepare_payload();
+                http::async_write(session->stream, session->response,
+                    [this, session](boost::system::error_code ec, size_t) {
+                        if (!ec) {
+                            read(session);
+                        }
+                    });
+            });
+    }
+};
+
+} // namespace
+
+TEST(HttpConnectionPoolTest, ReusesKeepAliveConnection) {
+    MockRestServer server(true);
+    ASSERT_TRUE(server.start());
+
+    websocket::TlsContext tls(false);
+    api::HttpConnectionPool pool("127.0.0.1", server.getPort(), 2, &tls);
+    api::RequestParams params;
+    params.add("currency", "BTC");
+
+    for (int i = 0; i < 3; ++i) {
+        api::HttpResponse response;
+        ASSERT_TRUE(pool.get("/api/v2/public/get_time", params, response));
+        EXPECT_TRUE(response.ok());
+        EXPECT_EQ(response.body, "{}");
+        EXPECT_EQ(pool.getIdleCount(), 1u);
+    }
+    EXPECT_EQ(server.getConnections(), 1u);
+    EXPECT_EQ(server.getRequests(), 3u);
+
+    std::vector<api::HttpResponse> responses;
+    ASSERT_TRUE(pool.pipelineGet({"/api/v2/public/test", "/api/v2/public/get_time"}, responses));
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_EQ(responses[1].body, "{}");
+    EXPECT_EQ(server.getConnections(), 1u);
+}
+
+TEST(HttpConnectionPoolTest, StalledServerTimesOut) {
+    MockRestServer server(false);
+    ASSERT_TRUE(server.start());
+
+    websocket::TlsContext tls(false);
+    api::HttpConnectionPool pool("127.0.0.1", server.getPort(), 2, &tls);
+    pool.setRequestTimeout(std::chrono::milliseconds(200));
+
+    api::HttpResponse response;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(pool.get("/api/v2/public/get_time", api::RequestParams(), response));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Only a reused connection is retried, so the one request was sent once
+    EXPECT_EQ(server.getRequests(), 1u);
+    EXPECT_LT(elapsed, std::chrono::seconds(2));
+    EXPECT_EQ(pool.getIdleCount(), 0u);
+}
@@ -0,0 +1,256 @@
+/**
+ * @file dispatch_tests.cpp
+ * @brief Tests for the market data dispatch path
+ *
+ * Streams notifications from a local TLS WebSocket server through
+ * WSClient batching into the order books, tickers and trades, and checks
+ * that the I/O thread no longer touches the heap once warmed up. Built as
+ * its own executable, as it links the counting allocator.
+ */
+
+#include <gtest/gtest.h>
+#include "../src/websocket/ws_client.h"
+#include "../src/websocket/tls_context.h"
+#include "../src/api/deribit_api.h"
+#include "../src/order/orderbook.h"
+#include "../src/order/ticker_cache.h"
+#include "../src/order/trade_store.h"
+#include "../src/utils/allocation_counter.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+using namespace deribit;
+
+namespace beast = boost::beast;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = boost::asio::ip::tcp;
+
+namespace {
+
+const std::string kInstrument = "DISPATCH-PERPETUAL";
+const std::string kBookChannel = "book." + kInstrument + ".100ms";
+const std::string kTickerChannel = "ticker." + kInstrument + ".100ms";
+const std::string kTradesChannel = "trades." + kInstrument + ".raw";
+
+/**
+ * @brief Configure a server context with a freshly generated self-signed certificate
+ */
+bool useSelfSignedCertificate(ssl::context& context) {
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    if (!key || !cert) {
+        EVP_PKEY_free(key);
+        X509_free(cert);
+        return false;
+    }
+
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    bool ok = X509_sign(cert, key, EVP_sha256()) > 0 &&
+              SSL_CTX_use_certificate(context.native_handle(), cert) == 1 &&
+              SSL_CTX_use_PrivateKey(context.native_handle(), key) == 1;
+
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ok;
+}
+
+std::string notification(const std::string& channel, const std::string& data) {
+    return "{\"jsonrpc\":\"2.0\",\"method\":\"subscription\",\"params\":{\"channel\":\"" + channel +
+           "\",\"data\":" + data + "}}";
+}
+
+/**
+ * @brief Build the i-th notification: a book snapshot, then changes interleaved with tickers and trades
+ */
+std::string marketData(size_t i) {
+    if (i == 0) {
+        std::string snapshot = "{\"type\":\"snapshot\",\"change_id\":1,\"bids\":[";
+        std::string asks;
+        for (int level = 0; level < 20; ++level) {
+            snapshot += (level ? ",[\"new\"," : "[\"new\",") + std::to_string(50000 - level) + ",10]";
+            asks += (level ? ",[\"new\"," : "[\"new\",") + std::to_string(50001 + level) + ",10]";
+        }
+        return notification(kBookChannel, snapshot + "],\"asks\":[" + asks + "]}");
+    }
+
+    std::string price = std::to_string(50000 - static_cast<int>(i % 20));
+    if (i % 4 == 1) {
+        return notification(kTickerChannel,
+            "{\"timestamp\":1,\"instrument_name\":\"" + kInstrument + "\",\"mark_price\":" + price +
+            ",\"index_price\":50001,\"best_bid_price\":50000,\"best_bid_amount\":10,"
+            "\"best_ask_price\":50001,\"best_ask_amount\":10}");
+    }
+    if (i % 4 == 3) {
+        return notification(kTradesChannel,
+            "[{\"trade_seq\":" + std::to_string(i) + ",\"trade_id\":\"" + std::to_string(i) +
+            "\",\"timestamp\":1,\"price\":50000.5,\"instrument_name\":\"" + kInstrument +
+            "\",\"direction\":\"buy\",\"amount\":10}]");
+    }
+    // Change ids advance by one per book notification after the snapshot
+    int64_t changeId = static_cast<int64_t>(i / 4 * 2 + (i % 4 == 2 ? 1 : 0)) + 1;
+    return notification(kBookChannel,
+        "{\"type\":\"change\",\"prev_change_id\":" + std::to_string(changeId - 1) +
+        ",\"change_id\":" + std::to_string(changeId) + ",\"bids\":[[\"delete\"," + price +
+        ",0],[\"new\"," + price + ",7]],\"asks\":[[\"change\",50001,3]]}");
+}
+
+/**
+ * @class MockFeedServer
+ * @brief Local TLS WebSocket server acknowledging one subscribe request, then streaming market data
+ *
+ * Sends the given number of notifications back-to-back, then waits for
+ * the client to close the connection.
+ */
+class MockFeedServer {
+public:
+    explicit MockFeedServer(size_t count)
+        : m_count(count),
+          m_context(ssl::context::tls_server),
+          m_acceptor(m_ioContext, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0)) {}
+
+    ~MockFeedServer() {
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    bool start() {
+        if (!useSelfSignedCertificate(m_context)) {
+            return false;
+        }
+        m_thread = std::thread([this]() { run(); });
+        return true;
+    }
+
+    std::string getPort() const { return std::to_string(m_acceptor.local_endpoint().port()); }
+
+private:
+    size_t m_count;
+    net::io_context m_ioContext;
+    ssl::context m_context;
+    tcp::acceptor m_acceptor;
+    std::thread m_thread;
+
+    void run() {
+        boost::system::error_code ec;
+        beast::websocket::stream<beast::ssl_stream<tcp::socket>> ws(m_ioContext, m_context);
+        m_acceptor.accept(beast::get_lowest_layer(ws), ec);
+        if (ec) {
+            return;
+        }
+        ws.next_layer().handshake(ssl::stream_base::server, ec);
+        if (!ec) {
+            ws.accept(ec);
+        }
+
+        // Acknowledge the subscribe request with its own id
+        beast::flat_buffer buffer;
+        if (!ec) {
+            ws.read(buffer, ec);
+        }
+        if (ec) {
+            return;
+        }
+        std::string request = beast::buffers_to_string(buffer.data());
+        auto idPos = request.find("\"id\":");
+        std::string id = idPos == std::string::npos ? "0" :
+            request.substr(idPos + 5, request.find_first_of(",}", idPos) - idPos - 5);
+        ws.text(true);
+        ws.write(net::buffer("{\"jsonrpc\":\"2.0\",\"id\":" + id + ",\"result\":[]}"), ec);
+
+        for (size_t i = 0; i < m_count && !ec; ++i) {
+            ws.write(net::buffer(marketData(i)), ec);
+        }
+        while (!ec) {
+            ws.read(buffer, ec);
+            buffer.clear();
+        }
+    }
+};
+
+} // namespace
+
+TEST(DispatchTest, WarmDispatchDoesNotAllocate) {
+    const size_t warmup = 2000;
+    const size_t measured = 20000;
+
+    MockFeedServer server(warmup + measured);
+    ASSERT_TRUE(server.start());
+
+    websocket::TlsContext tls(false);
+    websocket::WSClient client("127.0.0.1", server.getPort(), "/", &tls);
+    websocket::HeartbeatPolicy heartbeat;
+    heartbeat.enabled = false;
+    client.setHeartbeatPolicy(heartbeat);
+    ASSERT_TRUE(client.connect());
+
+    auto& books = order::OrderBookManager::getInstance();
+    auto& tickers = order::TickerCache::getInstance();
+    auto& trades = order::TradeStore::getInstance();
+
+    // The book manager keeps a per-batch buffer sized by the largest batch
+    // so far; size it for a full batch, which the stream may not reach in warmup
+    std::vector<api::WSMessageView> fullBatch(websocket::WSClient::kDefaultMaxBatchSize,
+                                              api::WSMessageView{kBookChannel, "{}", {}});
+    books.onBookMessages(fullBatch);
+
+    // Only touched on the I/O thread
+    size_t received = 0;
+    size_t batches = 0;
+    uint64_t startCount = 0;
+    std::promise<uint64_t> allocations;
+    auto finished = allocations.get_future();
+
+    client.subscribeBatch({kBookChannel, kTickerChannel, kTradesChannel},
+        [&](const std::vector<api::WSMessageView>& msgs) {
+            books.onBookMessages(msgs);
+            tickers.onTickerMessages(msgs);
+            trades.onTradeMessages(msgs);
+
+            size_t before = received;
+            received += msgs.size();
+            if (before < warmup && received >= warmup) {
+                startCount = utils::AllocationCounter::getThreadCount();
+                batches = 0;
+            } else if (before >= warmup) {
+                ++batches;
+                if (before < warmup + measured && received >= warmup + measured) {
+                    allocations.set_value(utils::AllocationCounter::getThreadCount() - startCount);
+                }
+            }
+        });
+
+    ASSERT_EQ(finished.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+    uint64_t count = finished.get();
+    client.disconnect();
+
+    auto book = books.getBook(kInstrument);
+    ASSERT_TRUE(book);
+    EXPECT_TRUE(book->isValid());
+    EXPECT_EQ(count, 0u) << "over " << batches << " batches";
+
+    books.removeBook(kInstrument);
+    tickers.removeTicker(kInstrument);
+    trades.removeTape(kInstrument);
+}
@@ -0,0 +1,217 @@
+/**
+ * @file order_tests.cpp
+ * @brief Tests for the order state: open orders and snapshots
+ */
+
+#include <gtest/gtest.h>
+#include "../src/order/open_orders.h"
+#include "../src/order/state_snapshot.h"
+#include "../src/utils/snapshot_file.h"
+
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+using namespace deribit;
+using std::chrono::system_clock;
+
+namespace {
+
+api::Order makeOrder(const std::string& id, const std::string& state, double price,
+                     system_clock::time_point updatedAt) {
+    api::Order order;
+    order.order_id = id;
+    order.instrument_name = "BTC-PERPETUAL";
+    order.direction = "buy";
+    order.price = price;
+    order.amount = 10;
+    order.order_type = "limit";
+    order.order_state = state;
+    order.created_at = updatedAt;
+    order.last_updated_at = updatedAt;
+    return order;
+}
+
+std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() /
+            (name + "-" + std::to_string(::getpid()) + ".snap")).string();
+}
+
+} // namespace
+
+class OpenOrdersTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        order::OpenOrders::getInstance().setOrders({});
+        asOf = system_clock::now();
+    }
+
+    order::OpenOrders& orders = order::OpenOrders::getInstance();
+    system_clock::time_point asOf;
+};
+
+TEST_F(OpenOrdersTest, ReconcileAppliesExchangeList) {
+    auto before = asOf - std::chrono::seconds(10);
+    orders.setOrders({
+        makeOrder("kept", "open", 100, before),
+        makeOrder("repriced", "open", 100, before),
+        makeOrder("gone", "open", 100, before)
+    });
+
+    auto delta = orders.reconcile({
+        makeOrder("kept", "open", 100, before),
+        makeOrder("repriced", "open", 101, before + std::chrono::seconds(1)),
+        makeOrder("new", "open", 100, before)
+    }, asOf);
+
+    EXPECT_EQ(delta.unchanged, 1u);
+    EXPECT_EQ(delta.changed, 1u);
+    EXPECT_EQ(delta.removed, 1u);
+    EXPECT_EQ(delta.added, 1u);
+
+    api::Order order;
+    ASSERT_TRUE(orders.getOrder("repriced", order));
+    EXPECT_EQ(order.price, 101);
+    EXPECT_TRUE(orders.getOrder("new", order));
+    EXPECT_FALSE(orders.getOrder("gone", order));
+}
+
+TEST_F(OpenOrdersTest, ReconcileKeepsOrderPlacedAfterRequest) {
+    orders.onOrder(makeOrder("placed-later", "open", 100, asOf + std::chrono::milliseconds(5)));
+
+    auto delta = orders.reconcile({}, asOf);
+
+    EXPECT_EQ(delta.removed, 0u);
+    api::Order order;
+    EXPECT_TRUE(orders.getOrder("placed-later", order));
+}
+
+TEST_F(OpenOrdersTest, ReconcileDoesNotReviveOrderClosedAfterRequest) {
+    auto before = asOf - std::chrono::seconds(1);
+    orders.setOrders({makeOrder("filled-later", "open", 100, before)});
+    orders.onOrder(makeOrder("filled-later", "filled", 100, asOf + std::chrono::milliseconds(5)));
+
+    // The exchange's list was taken before the fill
+    auto delta = orders.reconcile({makeOrder("filled-later", "open", 100, before)}, asOf);
+
+    EXPECT_EQ(delta.added, 0u);
+    api::Order order;
+    EXPECT_FALSE(orders.getOrder("filled-later", order));
+    EXPECT_EQ(orders.size(), 0u);
+}
+
+TEST(SnapshotFileTest, ReadsLatestValidSlot) {
+    std::string path = tempPath("snapshot-file-latest");
+    std::filesystem::remove(path);
+
+    utils::SnapshotFile file;
+    ASSERT_TRUE(file.open(path, 64 * 1024, false));
+    ASSERT_TRUE(file.write("first"));
+    ASSERT_TRUE(file.write("second"));
+
+    std::string payload;
+    uint64_t sequence = 0;
+    ASSERT_TRUE(file.read(payload, sequence));
+    EXPECT_EQ(payload, "second");
+    EXPECT_EQ(sequence, 2u);
+
+    EXPECT_FALSE(file.write(std::string(file.getCapacity() + 1, 'x')));
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST(SnapshotFileTest, FallsBackWhenLatestSlotIsCorrupt) {
+    std::string path = tempPath("snapshot-file-corrupt");
+    std::filesystem::remove(path);
+
+    utils::SnapshotFile file;
+    ASSERT_TRUE(file.open(path, 64 * 1024, false));
+    ASSERT_TRUE(file.write("first"));
+    ASSERT_TRUE(file.write("second"));
+    file.close();
+
+    // Snapshot 2 lives in slot 0; flip a payload byte after its 64-byte header
+    {
+        std::fstream raw(path, std::ios::in | std::ios::out | std::ios::binary);
+        raw.seekp(64);
+        raw.put('S');
+    }
+
+    ASSERT_TRUE(file.open(path, 64 * 1024, false));
+    std::string payload;
+    uint64_t sequence = 0;
+    ASSERT_TRUE(file.read(payload, sequence));
+    EXPECT_EQ(payload, "first");
+    EXPECT_EQ(sequence, 1u);
+
+    // The next write replaces the corrupt slot, not the valid one
+    ASSERT_TRUE(file.write("third"));
+    ASSERT_TRUE(file.read(payload, sequence));
+    EXPECT_EQ(payload, "third");
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST(SnapshotFileTest, EmptyFileHasNoSnapshot) {
+    std::string path = tempPath("snapshot-file-empty");
+    std::filesystem::remove(path);
+
+    utils::SnapshotFile file;
+    ASSERT_TRUE(file.open(path, 64 * 1024, false));
+    std::string payload;
+    uint64_t sequence = 0;
+    EXPECT_FALSE(file.read(payload, sequence));
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST(StateSnapshotTest, EncodeDecodeRoundTrip) {
+    auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(system_clock::now());
+
+    order::TradingState state;
+    state.takenAt = now;
+    state.orders.push_back(makeOrder("42", "open", 50000.5, now));
+
+    api::Position position{"BTC-PERPETUAL", 100, 50000, 50100, 2, -1, 25000};
+    state.positions.push_back(position);
+
+    api::Instrument instrument;
+    instrument.instrument_name = "BTC-27DEC24-100000-C";
+    instrument.currency = "BTC";
+    instrument.kind = "option";
+    instrument.option_type = "call";
+    instrument.strike = 100000;
+    instrument.tick_size = 0.0005;
+    instrument.contract_size = 1;
+    instrument.min_trade_amount = 0.1;
+    instrument.is_active = true;
+    instrument.expiration = now + std::chrono::hours(24);
+    state.instruments.push_back(instrument);
+
+    order::TradingState decoded;
+    ASSERT_TRUE(order::StateSnapshot::decode(order::StateSnapshot::encode(state), decoded));
+
+    EXPECT_EQ(decoded.takenAt, state.takenAt);
+    ASSERT_EQ(decoded.orders.size(), 1u);
+    EXPECT_EQ(decoded.orders[0].order_id, "42");
+    EXPECT_EQ(decoded.orders[0].price, 50000.5);
+    EXPECT_EQ(decoded.orders[0].order_state, "open");
+    EXPECT_EQ(decoded.orders[0].last_updated_at, now);
+    ASSERT_EQ(decoded.positions.size(), 1u);
+    EXPECT_EQ(decoded.positions[0].instrument_name, "BTC-PERPETUAL");
+    EXPECT_EQ(decoded.positions[0].size, 100);
+    EXPECT_EQ(decoded.positions[0].liquidation_price, 25000);
+    ASSERT_EQ(decoded.instruments.size(), 1u);
+    EXPECT_EQ(decoded.instruments[0].instrument_name, "BTC-27DEC24-100000-C");
+    EXPECT_EQ(decoded.instruments[0].option_type, "call");
+    EXPECT_EQ(decoded.instruments[0].tick_size, 0.0005);
+    EXPECT_TRUE(decoded.instruments[0].is_active);
+    EXPECT_EQ(decoded.instruments[0].expiration, instrument.expiration);
+}
+
+TEST(StateSnapshotTest, DecodeRejectsMalformedPayload) {
+    order::TradingState state;
+    EXPECT_FALSE(order::StateSnapshot::decode("not json", state));
+    EXPECT_FALSE(order::StateSnapshot::decode("{\"version\":0}", state));
+    EXPECT_FALSE(order::StateSnapshot::decode("{\"version\":1,\"taken_at\":0}", state));
+}
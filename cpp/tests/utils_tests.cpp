@@ -0,0 +1,189 @@
+/**
+ * @file utils_tests.cpp
+ * @brief Tests for the utilities: timer wheel and arena JSON reader
+ */
+
+#include <gtest/gtest.h>
+#include "../src/utils/timer_wheel.h"
+#include "../src/utils/arena_json.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace deribit;
+using std::chrono::milliseconds;
+
+class TimerWheelTest : public ::testing::Test {
+protected:
+    // The wheel's start lies just before base, so a timer scheduled with
+    // delay d is due within a few ticks after base + d
+    utils::TimerWheel wheel{milliseconds(1)};
+    utils::TimerWheel::Clock::time_point base = utils::TimerWheel::Clock::now();
+    std::vector<int> fired;
+
+    utils::TimerId scheduleAt(milliseconds delay, int tag) {
+        return wheel.schedule(delay, [this, tag]() { fired.push_back(tag); });
+    }
+};
+
+TEST_F(TimerWheelTest, FiresWithinFinestLevel) {
+    scheduleAt(milliseconds(20), 1);
+    scheduleAt(milliseconds(10), 2);
+    EXPECT_EQ(wheel.size(), 2u);
+
+    EXPECT_EQ(wheel.advance(base + milliseconds(5)), 0u);
+    EXPECT_EQ(wheel.advance(base + milliseconds(15)), 1u);
+    EXPECT_EQ(wheel.advance(base + milliseconds(25)), 1u);
+    EXPECT_EQ(fired, (std::vector<int>{2, 1}));
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST_F(TimerWheelTest, CascadesAcrossLevels) {
+    // 256 ticks per level: these sit in levels 1 and 2 until they come due
+    scheduleAt(milliseconds(300), 1);
+    scheduleAt(milliseconds(1000), 2);
+    scheduleAt(milliseconds(70000), 3);
+
+    EXPECT_EQ(wheel.advance(base + milliseconds(290)), 0u);
+    EXPECT_EQ(wheel.advance(base + milliseconds(310)), 1u);
+    EXPECT_EQ(wheel.advance(base + milliseconds(990)), 0u);
+    EXPECT_EQ(wheel.advance(base + milliseconds(1010)), 1u);
+    EXPECT_EQ(wheel.advance(base + milliseconds(69990)), 0u);
+    EXPECT_EQ(wheel.advance(base + milliseconds(70010)), 1u);
+    EXPECT_EQ(fired, (std::vector<int>{1, 2, 3}));
+}
+
+TEST_F(TimerWheelTest, NextExpiryNeverPassesEarliestTimer) {
+    EXPECT_EQ(wheel.nextExpiry(), utils::TimerWheel::Clock::time_point::max());
+    scheduleAt(milliseconds(600), 1);
+    auto next = wheel.nextExpiry();
+    EXPECT_LE(next, utils::TimerWheel::Clock::now() + milliseconds(600));
+
+    // Advancing to each reported expiry reaches the timer without overshooting
+    int steps = 0;
+    while (fired.empty() && steps++ < 10) {
+        wheel.advance(wheel.nextExpiry());
+    }
+    EXPECT_EQ(fired, (std::vector<int>{1}));
+}
+
+TEST_F(TimerWheelTest, CancelledTimerDoesNotFire) {
+    auto cancelled = scheduleAt(milliseconds(300), 1);
+    auto kept = scheduleAt(milliseconds(300), 2);
+    EXPECT_TRUE(wheel.cancel(cancelled));
+    EXPECT_FALSE(wheel.cancel(cancelled));
+    EXPECT_EQ(wheel.size(), 1u);
+
+    wheel.advance(base + milliseconds(310));
+    EXPECT_EQ(fired, (std::vector<int>{2}));
+    EXPECT_FALSE(wheel.cancel(kept));
+    EXPECT_FALSE(wheel.cancel(0));
+}
+
+TEST_F(TimerWheelTest, StaleIdDoesNotCancelReusedEntry) {
+    auto first = scheduleAt(milliseconds(10), 1);
+    EXPECT_TRUE(wheel.cancel(first));
+
+    // The slab entry is reused with a new generation
+    auto second = scheduleAt(milliseconds(10), 2);
+    EXPECT_NE(first, second);
+    EXPECT_FALSE(wheel.cancel(first));
+
+    wheel.advance(base + milliseconds(20));
+    EXPECT_EQ(fired, (std::vector<int>{2}));
+}
+
+class ArenaJsonTest : public ::testing::Test {
+protected:
+    utils::ArenaScope scope;
+
+    static std::string_view text(const utils::ArenaJson& value) {
+        const auto& string = value.get_ref<const utils::ArenaJson::string_t&>();
+        return std::string_view(string.data(), string.size());
+    }
+};
+
+TEST_F(ArenaJsonTest, DecodesEscapes) {
+    const auto& document = utils::parseJson(
+        R"({"plain":"BTC-PERPETUAL","escaped":"a\"b\\c\/d\n\t\b\f\r","latin":"caf\u00e9",)"
+        R"("euro":"\u20AC","emoji":"\ud83d\ude00","nul":"x\u0000y"})");
+    ASSERT_FALSE(document.is_discarded());
+    EXPECT_EQ(utils::stringField(document, "plain"), "BTC-PERPETUAL");
+    EXPECT_EQ(utils::stringField(document, "escaped"), "a\"b\\c/d\n\t\b\f\r");
+    EXPECT_EQ(utils::stringField(document, "latin"), "caf\xC3\xA9");
+    EXPECT_EQ(utils::stringField(document, "euro"), "\xE2\x82\xAC");
+    EXPECT_EQ(utils::stringField(document, "emoji"), "\xF0\x9F\x98\x80");
+    EXPECT_EQ(utils::stringField(document, "nul"), std::string_view("x\0y", 3));
+
+    // Missing and non-string fields read as empty
+    EXPECT_EQ(utils::stringField(document, "missing"), "");
+    EXPECT_EQ(utils::stringField(utils::parseJson(R"({"n":1})"), "n"), "");
+}
+
+TEST_F(ArenaJsonTest, StoresNumbersLikeNlohmann) {
+    const auto& document = utils::parseJson(
+        R"([0, 42, -7, -0, 18446744073709551615, 18446744073709551616, -9223372036854775808,)"
+        R"( -9223372036854775809, 1.5, -2.5e-3, 1E2, 0.1e+1])");
+    ASSERT_TRUE(document.is_array());
+    ASSERT_EQ(document.size(), 12u);
+
+    EXPECT_TRUE(document[0].is_number_unsigned());
+    EXPECT_EQ(document[1].get<uint64_t>(), 42u);
+    EXPECT_TRUE(document[2].is_number_integer() && !document[2].is_number_unsigned());
+    EXPECT_EQ(document[2].get<int64_t>(), -7);
+    EXPECT_FALSE(document[3].is_number_unsigned());
+    EXPECT_EQ(document[3].get<int64_t>(), 0);
+    EXPECT_EQ(document[4].get<uint64_t>(), UINT64_MAX);
+    EXPECT_EQ(document[6].get<int64_t>(), INT64_MIN);
+
+    // Out of 64-bit range: kept as double
+    EXPECT_TRUE(document[5].is_number_float());
+    EXPECT_DOUBLE_EQ(document[5].get<double>(), 18446744073709551616.0);
+    EXPECT_TRUE(document[7].is_number_float());
+
+    EXPECT_DOUBLE_EQ(document[8].get<double>(), 1.5);
+    EXPECT_DOUBLE_EQ(document[9].get<double>(), -2.5e-3);
+    EXPECT_TRUE(document[10].is_number_float());
+    EXPECT_DOUBLE_EQ(document[10].get<double>(), 100.0);
+    EXPECT_DOUBLE_EQ(document[11].get<double>(), 1.0);
+}
+
+TEST_F(ArenaJsonTest, RejectsMalformedInput) {
+    const char* malformed[] = {
+        "", " ", "01", "-", "1.", ".5", "+1", "1e", "1e+", "0x10", "-01", "NaN", "Infinity",
+        "\"unterminated", "\"bad\\q\"", "\"tab\there\"", "\"\\u12\"", "\"\\u12G4\"",
+        "\"\\udc00\"", "\"\\ud83d\"", "\"\\ud83dx\"", "\"\\ud83d\\u0041\"",
+        "tru", "nul", "falsey", "[1,]", "[1 2]", "{\"a\":1,}", "{\"a\" 1}", "{a:1}", "{\"a\":}",
+        "[", "{", "{}}", "[] []", "{\"a\":1} x",
+    };
+    for (const char* input : malformed) {
+        EXPECT_TRUE(utils::parseJson(input).is_discarded()) << input;
+        EXPECT_FALSE(nlohmann::json::accept(input)) << input;
+    }
+    EXPECT_FALSE(utils::parseJson(" {\"a\" : [ true , false , null ] }\r\n").is_discarded());
+}
+
+TEST_F(ArenaJsonTest, LimitsNestingDepth) {
+    std::string nested = std::string(256, '[') + std::string(256, ']');
+    EXPECT_FALSE(utils::parseJson(nested).is_discarded());
+
+    std::string tooDeep = std::string(257, '[') + std::string(257, ']');
+    EXPECT_TRUE(utils::parseJson(tooDeep).is_discarded());
+    std::string objects;
+    for (int i = 0; i < 257; ++i) {
+        objects += "{\"a\":";
+    }
+    objects += "1" + std::string(257, '}');
+    EXPECT_TRUE(utils::parseJson(objects).is_discarded());
+}
+
+TEST_F(ArenaJsonTest, RepeatedKeyKeepsLastValue) {
+    const auto& document = utils::parseJson(R"({"price":1,"nested":{"id":"a"},"price":2,"nested":{"id":"b"}})");
+    ASSERT_TRUE(document.is_object());
+    EXPECT_EQ(document.size(), 2u);
+    EXPECT_EQ(document["price"].get<uint64_t>(), 2u);
+    EXPECT_EQ(text(document["nested"]["id"]), "b");
+}
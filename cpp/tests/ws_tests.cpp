@@ -0,0 +1,127 @@
+/**
+ * @file ws_tests.cpp
+ * @brief Tests for the WebSocket layer: redundant feed arbitration
+ */
+
+#include <gtest/gtest.h>
+#include "../src/websocket/feed_arbiter.h"
+#include "../src/api/deribit_api.h"
+
+#include <string>
+
+using namespace deribit;
+
+namespace {
+
+const std::string kBook = "book.BTC-PERPETUAL.100ms";
+const std::string kTrades = "trades.BTC-PERPETUAL.raw";
+const std::string kTicker = "ticker.BTC-PERPETUAL.100ms";
+
+std::string bookChange(int64_t changeId) {
+    return "{\"type\":\"change\",\"timestamp\":1,\"prev_change_id\":" + std::to_string(changeId - 1) +
+           ",\"instrument_name\":\"BTC-PERPETUAL\",\"change_id\":" + std::to_string(changeId) +
+           ",\"bids\":[[\"new\",50000,10]],\"asks\":[]}";
+}
+
+} // namespace
+
+class FeedArbiterTest : public ::testing::Test {
+protected:
+    websocket::FeedArbiter arbiter{2};
+
+    bool accept(size_t feed, const std::string& channel, const std::string& data) {
+        auto delivery = arbiter.lockDelivery();
+        return arbiter.accept(feed, api::WSMessageView{channel, data, {}});
+    }
+};
+
+TEST(FeedArbiterSequenceTest, ExtractsKeyNamedByChannel) {
+    int64_t sequence = 0;
+    bool unique = false;
+
+    // prev_change_id precedes change_id and must not be taken for it
+    ASSERT_TRUE(websocket::FeedArbiter::extractSequence(kBook, bookChange(42), sequence, unique));
+    EXPECT_EQ(sequence, 42);
+    EXPECT_TRUE(unique);
+
+    // The last trade of a batch carries the highest trade_seq
+    ASSERT_TRUE(websocket::FeedArbiter::extractSequence(kTrades,
+        "[{\"trade_seq\":7,\"timestamp\":5},{\"trade_seq\":8,\"timestamp\":5}]", sequence, unique));
+    EXPECT_EQ(sequence, 8);
+    EXPECT_TRUE(unique);
+
+    ASSERT_TRUE(websocket::FeedArbiter::extractSequence(kTicker,
+        "{\"timestamp\":1700000000123,\"mark_price\":50000}", sequence, unique));
+    EXPECT_EQ(sequence, 1700000000123);
+    EXPECT_FALSE(unique);
+
+    EXPECT_FALSE(websocket::FeedArbiter::extractSequence(kTicker, "{\"mark_price\":50000}", sequence, unique));
+    EXPECT_TRUE(websocket::FeedArbiter::isSnapshot("{\"type\":\"snapshot\",\"change_id\":1}"));
+    EXPECT_FALSE(websocket::FeedArbiter::isSnapshot(bookChange(1)));
+}
+
+TEST_F(FeedArbiterTest, DuplicateFromSlowerFeedIsDropped) {
+    EXPECT_TRUE(accept(0, kBook, bookChange(10)));
+    EXPECT_FALSE(accept(1, kBook, bookChange(10)));
+    EXPECT_TRUE(accept(1, kBook, bookChange(11)));
+    EXPECT_FALSE(accept(0, kBook, bookChange(11)));
+
+    auto first = arbiter.getStats(0);
+    auto second = arbiter.getStats(1);
+    EXPECT_EQ(first.received, 2u);
+    EXPECT_EQ(first.won, 1u);
+    EXPECT_EQ(second.received, 2u);
+    EXPECT_EQ(second.won, 1u);
+}
+
+TEST_F(FeedArbiterTest, OutOfOrderCopyIsDropped) {
+    EXPECT_TRUE(accept(0, kBook, bookChange(12)));
+    EXPECT_FALSE(accept(1, kBook, bookChange(11)));
+    EXPECT_FALSE(accept(0, kBook, bookChange(12)));
+    EXPECT_TRUE(accept(1, kBook, bookChange(13)));
+
+    // Channels are arbitrated independently
+    EXPECT_TRUE(accept(1, kTrades, "[{\"trade_seq\":3}]"));
+    EXPECT_FALSE(accept(0, kTrades, "[{\"trade_seq\":2},{\"trade_seq\":3}]"));
+    EXPECT_TRUE(accept(0, kTrades, "[{\"trade_seq\":4}]"));
+}
+
+TEST_F(FeedArbiterTest, SnapshotRepeatingLastSequenceIsForwarded) {
+    EXPECT_TRUE(accept(0, kBook, bookChange(20)));
+    EXPECT_TRUE(accept(1, kBook, "{\"type\":\"snapshot\",\"change_id\":20,\"bids\":[],\"asks\":[]}"));
+    EXPECT_FALSE(accept(0, kBook, "{\"type\":\"snapshot\",\"change_id\":19,\"bids\":[],\"asks\":[]}"));
+}
+
+TEST_F(FeedArbiterTest, TimestampKeysCompareThePayload) {
+    const std::string first = "{\"timestamp\":100,\"mark_price\":1}";
+    const std::string second = "{\"timestamp\":100,\"mark_price\":2}";
+    EXPECT_TRUE(accept(0, kTicker, first));
+    EXPECT_FALSE(accept(1, kTicker, first));
+
+    // Same time, different content: a distinct notification
+    EXPECT_TRUE(accept(1, kTicker, second));
+    EXPECT_FALSE(accept(0, kTicker, second));
+    EXPECT_FALSE(accept(0, kTicker, "{\"timestamp\":99,\"mark_price\":3}"));
+    EXPECT_TRUE(accept(0, kTicker, "{\"timestamp\":101,\"mark_price\":1}"));
+}
+
+TEST_F(FeedArbiterTest, UnsequencedDataFollowsLastWinner) {
+    const std::string data = "{\"mark_price\":1}";
+    EXPECT_TRUE(accept(0, kTicker, data));
+    EXPECT_FALSE(accept(1, kTicker, data));
+
+    EXPECT_TRUE(accept(1, kBook, bookChange(1)));
+    EXPECT_FALSE(accept(0, kTicker, data));
+    EXPECT_TRUE(accept(1, kTicker, data));
+}
+
+TEST_F(FeedArbiterTest, ResetForgetsChannelSequence) {
+    EXPECT_TRUE(accept(0, kBook, bookChange(50)));
+    EXPECT_FALSE(accept(1, kBook, bookChange(5)));
+
+    // After resubscribing, the exchange restarts the sequence
+    arbiter.reset(kBook);
+    EXPECT_TRUE(accept(1, kBook, bookChange(5)));
+    EXPECT_FALSE(accept(0, kBook, bookChange(5)));
+    EXPECT_FALSE(accept(2, kBook, bookChange(6)));
+}